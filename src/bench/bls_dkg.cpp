@@ -5,6 +5,7 @@
 #include <bench/bench.h>
 #include <random.h>
 #include <bls/bls_worker.h>
+#include <llmq/quorums_dkgsessionmgr.h>
 
 extern CBLSWorker blsWorker;
 
@@ -111,9 +112,25 @@ struct DKG
             memberIdx = (memberIdx + 1) % members.size();
         }
     }
+
+    // Splits the contributions received by whoAmI into batches of batchSize, like CDKGSession verifies them
+    void BuildContributionBatches(size_t whoAmI, size_t batchSize, std::vector<std::vector<BLSVerificationVectorPtr>>& vvecBatchesRet, std::vector<BLSSecretKeyVector>& skShareBatchesRet)
+    {
+        ReceiveVvecs();
+        ReceiveShares(whoAmI);
+
+        vvecBatchesRet.clear();
+        skShareBatchesRet.clear();
+        for (size_t i = 0; i < members.size(); i += batchSize) {
+            size_t end = std::min(i + batchSize, members.size());
+            vvecBatchesRet.emplace_back(receivedVvecs.begin() + i, receivedVvecs.begin() + end);
+            skShareBatchesRet.emplace_back(receivedSkShares.begin() + i, receivedSkShares.begin() + end);
+        }
+    }
 };
 
 std::shared_ptr<DKG> dkg10;
+std::shared_ptr<DKG> dkg50;
 std::shared_ptr<DKG> dkg100;
 std::shared_ptr<DKG> dkg400;
 
@@ -122,6 +139,9 @@ void InitIfNeeded()
     if (dkg10 == nullptr) {
         dkg10 = std::make_shared<DKG>(10);
     }
+    if (dkg50 == nullptr) {
+        dkg50 = std::make_shared<DKG>(50);
+    }
     if (dkg100 == nullptr) {
         dkg100 = std::make_shared<DKG>(100);
     }
@@ -133,6 +153,7 @@ void InitIfNeeded()
 void CleanupBLSDkgTests()
 {
     dkg10.reset();
+    dkg50.reset();
     dkg100.reset();
     dkg400.reset();
 }
@@ -181,3 +202,65 @@ BENCH_VerifyContributionShares(parallel, 400, 5, true, false, 1)
 BENCH_VerifyContributionShares(parallel_aggregated, 10, 5, true, true, 150)
 BENCH_VerifyContributionShares(parallel_aggregated, 100, 5, true, true, 4)
 BENCH_VerifyContributionShares(parallel_aggregated, 400, 5, true, true, 1)
+
+///////////////////////////////
+
+// Several quorums verify the contributions of their members at the same time, one batch of 32 contributions at a time
+// like CDKGSession does. The batches are either all pushed to the BLS worker at once or go through the
+// CDKGVerificationScheduler, which starts them in order of the quorum's deadline
+static void Bench_VerifyConcurrentContributionShares(benchmark::State& state, const std::vector<std::shared_ptr<DKG>>& dkgs, bool scheduled)
+{
+    llmq::CDKGVerificationScheduler scheduler(blsWorker);
+
+    std::vector<std::vector<std::vector<BLSVerificationVectorPtr>>> vvecBatches(dkgs.size());
+    std::vector<std::vector<BLSSecretKeyVector>> skShareBatches(dkgs.size());
+    for (size_t i = 0; i < dkgs.size(); i++) {
+        dkgs[i]->BuildContributionBatches(i % dkgs[i]->members.size(), 32, vvecBatches[i], skShareBatches[i]);
+    }
+
+    while (state.KeepRunning()) {
+        std::vector<std::future<std::vector<bool>>> futures;
+        // interleave the batches of all quorums, as they would arrive from the network
+        for (size_t batchIdx = 0; ; batchIdx++) {
+            bool pushed = false;
+            for (size_t i = 0; i < dkgs.size(); i++) {
+                if (batchIdx >= vvecBatches[i].size()) {
+                    continue;
+                }
+                const auto& forId = dkgs[i]->members[i % dkgs[i]->members.size()].id;
+                if (scheduled) {
+                    // smaller quorums have shorter DKG phases and thus earlier deadlines
+                    int nDeadline = (int)dkgs[i]->members.size();
+                    futures.emplace_back(scheduler.AsyncVerifyContributionShares(nDeadline, forId, vvecBatches[i][batchIdx], skShareBatches[i][batchIdx]));
+                } else {
+                    futures.emplace_back(blsWorker.AsyncVerifyContributionShares(forId, vvecBatches[i][batchIdx], skShareBatches[i][batchIdx], true, true));
+                }
+                pushed = true;
+            }
+            if (!pushed) {
+                break;
+            }
+        }
+        for (auto& f : futures) {
+            auto result = f.get();
+            for (bool b : result) {
+                assert(b);
+            }
+        }
+    }
+}
+
+#define BENCH_VerifyConcurrentContributionShares(name, scheduled, num_iters_for_one_second, ...) \
+    static void BLSDKG_VerifyConcurrentContributionShares_##name(benchmark::State& state) \
+    { \
+        InitIfNeeded(); \
+        Bench_VerifyConcurrentContributionShares(state, {__VA_ARGS__}, scheduled); \
+    } \
+    BENCHMARK(BLSDKG_VerifyConcurrentContributionShares_##name, num_iters_for_one_second)
+
+BENCH_VerifyConcurrentContributionShares(direct_4x50, false, 5, dkg50, dkg50, dkg50, dkg50)
+BENCH_VerifyConcurrentContributionShares(direct_2x400, false, 1, dkg400, dkg400)
+BENCH_VerifyConcurrentContributionShares(direct_4x50_400, false, 1, dkg50, dkg50, dkg50, dkg50, dkg400)
+BENCH_VerifyConcurrentContributionShares(scheduled_4x50, true, 5, dkg50, dkg50, dkg50, dkg50)
+BENCH_VerifyConcurrentContributionShares(scheduled_2x400, true, 1, dkg400, dkg400)
+BENCH_VerifyConcurrentContributionShares(scheduled_4x50_400, true, 1, dkg50, dkg50, dkg50, dkg50, dkg400)
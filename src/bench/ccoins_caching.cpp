@@ -5,6 +5,7 @@
 #include <bench/bench.h>
 #include <coins.h>
 #include <policy/policy.h>
+#include <random.h>
 #include <wallet/crypter.h>
 
 #include <vector>
@@ -84,4 +85,74 @@ static void CCoinsCaching(benchmark::State& state)
     }
 }
 
+// A cache of this many coins is roughly what a few blocks of inputs and outputs bring into pcoinsTip.
+static const int CACHE_COINS = 100 * 1000;
+
+static std::vector<COutPoint> MakeOutPoints()
+{
+    FastRandomContext rng(true);
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(CACHE_COINS);
+    for (int i = 0; i < CACHE_COINS; i++) {
+        outpoints.emplace_back(rng.rand256(), i % 4);
+    }
+    return outpoints;
+}
+
+static void AddDummyCoins(CCoinsViewCache& coins, const std::vector<COutPoint>& outpoints)
+{
+    CTxOut out(CENT, CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 1) << OP_EQUALVERIFY << OP_CHECKSIG);
+    for (const COutPoint& outpoint : outpoints) {
+        coins.AddCoin(outpoint, Coin(out, 1, false, false), false);
+    }
+}
+
+// Fill an empty cache, then drop it, as happens to the cache of every connected block.
+static void CCoinsCacheInsert(benchmark::State& state)
+{
+    const std::vector<COutPoint> outpoints = MakeOutPoints();
+    CCoinsView coinsDummy;
+
+    while (state.KeepRunning()) {
+        CCoinsViewCache coins(&coinsDummy);
+        AddDummyCoins(coins, outpoints);
+        assert(coins.GetCacheSize() == CACHE_COINS);
+    }
+}
+
+// Look up every coin of a filled cache.
+static void CCoinsCacheLookup(benchmark::State& state)
+{
+    const std::vector<COutPoint> outpoints = MakeOutPoints();
+    CCoinsView coinsDummy;
+    CCoinsViewCache coins(&coinsDummy);
+    AddDummyCoins(coins, outpoints);
+
+    while (state.KeepRunning()) {
+        for (const COutPoint& outpoint : outpoints) {
+            bool found = coins.HaveCoinInCache(outpoint);
+            assert(found);
+        }
+    }
+}
+
+// Fill a cache and flush it into an empty parent cache, which moves every entry across.
+static void CCoinsCacheFlush(benchmark::State& state)
+{
+    const std::vector<COutPoint> outpoints = MakeOutPoints();
+    CCoinsView coinsDummy;
+
+    while (state.KeepRunning()) {
+        CCoinsViewCache parent(&coinsDummy);
+        CCoinsViewCache coins(&parent);
+        AddDummyCoins(coins, outpoints);
+        bool success = coins.Flush();
+        assert(success);
+        assert(parent.GetCacheSize() == CACHE_COINS);
+    }
+}
+
 BENCHMARK(CCoinsCaching, 170 * 1000);
+BENCHMARK(CCoinsCacheInsert, 20);
+BENCHMARK(CCoinsCacheLookup, 100);
+BENCHMARK(CCoinsCacheFlush, 10);
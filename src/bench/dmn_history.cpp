@@ -0,0 +1,135 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <evo/deterministicmns.h>
+#include <evo/evodb.h>
+#include <random.h>
+
+static const int HISTORY_MASTERNODES = 500;
+static const int HISTORY_BLOCKS = DEFAULT_DMN_SNAPSHOT_PERIOD * 3;
+static const int HISTORY_UPDATES_PER_BLOCK = 3;
+static const int HISTORY_LOOKUPS = 16;
+
+/**
+ * A chain of HISTORY_BLOCKS blocks with a masternode list which gets a few payments per block. The diffs and
+ * snapshots are written to an in-memory evo DB, historic lookups are done on a fresh manager so every evaluation
+ * starts with cold caches.
+ */
+struct DMNHistorySetup
+{
+    CEvoDB evoDb{1 << 20, true, true};
+    const int nSnapshotPeriod;
+    std::vector<uint256> vHashes;
+    std::vector<CBlockIndex> vIndexes;
+
+    explicit DMNHistorySetup(int _nSnapshotPeriod) : nSnapshotPeriod(_nSnapshotPeriod)
+    {
+        SelectParams(CBaseChainParams::MAIN);
+        FastRandomContext rng(true);
+
+        vHashes.resize(HISTORY_BLOCKS);
+        vIndexes.resize(HISTORY_BLOCKS);
+        for (int i = 0; i < HISTORY_BLOCKS; i++) {
+            vHashes[i] = rng.rand256();
+            vIndexes[i].phashBlock = &vHashes[i];
+            vIndexes[i].nHeight = i;
+            vIndexes[i].pprev = i > 0 ? &vIndexes[i - 1] : nullptr;
+            vIndexes[i].BuildSkip();
+        }
+
+        CDeterministicMNManager manager(evoDb, nSnapshotPeriod);
+        auto dbTx = evoDb.BeginTransaction();
+
+        CDeterministicMNList mnList(vHashes[0], 0, 0);
+        std::vector<uint256> vProTxHashes;
+        for (int i = 0; i < HISTORY_MASTERNODES; i++) {
+            auto dmn = std::make_shared<CDeterministicMN>(i);
+            dmn->proTxHash = rng.rand256();
+            dmn->collateralOutpoint = COutPoint(rng.rand256(), 0);
+            dmn->nOperatorReward = 0;
+            auto dmnState = std::make_shared<CDeterministicMNState>();
+            dmnState->nRegisteredHeight = 0;
+            dmnState->confirmedHash = rng.rand256();
+            dmnState->keyIDOwner = CKeyID(uint160(rng.randbytes(20)));
+            dmn->pdmnState = dmnState;
+            mnList.AddMN(dmn);
+            vProTxHashes.emplace_back(dmn->proTxHash);
+        }
+        manager.WriteListForBlock(&vIndexes[0], CDeterministicMNList(), mnList);
+
+        for (int i = 1; i < HISTORY_BLOCKS; i++) {
+            CDeterministicMNList newList = mnList;
+            newList.SetBlockHash(vHashes[i]);
+            newList.SetHeight(i);
+            for (int j = 0; j < HISTORY_UPDATES_PER_BLOCK; j++) {
+                const uint256& proTxHash = vProTxHashes[rng.randrange(vProTxHashes.size())];
+                auto dmnState = std::make_shared<CDeterministicMNState>(*newList.GetMN(proTxHash)->pdmnState);
+                dmnState->nLastPaidHeight = i;
+                newList.UpdateMN(proTxHash, dmnState);
+            }
+            manager.WriteListForBlock(&vIndexes[i], mnList, newList);
+            mnList = newList;
+        }
+
+        dbTx->Commit();
+        evoDb.CommitRootTransaction();
+    }
+};
+
+static void DMNHistoryLookup(benchmark::State& state, int nSnapshotPeriod)
+{
+    DMNHistorySetup setup(nSnapshotPeriod);
+    FastRandomContext rng(true);
+
+    while (state.KeepRunning()) {
+        CDeterministicMNManager manager(setup.evoDb, nSnapshotPeriod);
+        for (int i = 0; i < HISTORY_LOOKUPS; i++) {
+            auto mnList = manager.GetListForBlock(&setup.vIndexes[rng.randrange(HISTORY_BLOCKS)]);
+            assert(mnList.GetAllMNsCount() == HISTORY_MASTERNODES);
+        }
+    }
+}
+
+// Lists of a range of blocks, one GetListForBlock call per block
+static void DMNHistoryRangeLookup(benchmark::State& state)
+{
+    DMNHistorySetup setup(DEFAULT_DMN_SNAPSHOT_PERIOD);
+    int nStart = DEFAULT_DMN_SNAPSHOT_PERIOD + 1;
+
+    while (state.KeepRunning()) {
+        CDeterministicMNManager manager(setup.evoDb, DEFAULT_DMN_SNAPSHOT_PERIOD);
+        for (int i = nStart; i < HISTORY_BLOCKS; i++) {
+            auto payee = manager.GetListForBlock(&setup.vIndexes[i]).GetMNPayee();
+            assert(payee != nullptr);
+        }
+    }
+}
+
+// Lists of the same range of blocks with ForEachListInRange
+static void DMNHistoryRangeScan(benchmark::State& state)
+{
+    DMNHistorySetup setup(DEFAULT_DMN_SNAPSHOT_PERIOD);
+    int nStart = DEFAULT_DMN_SNAPSHOT_PERIOD + 1;
+
+    while (state.KeepRunning()) {
+        CDeterministicMNManager manager(setup.evoDb, DEFAULT_DMN_SNAPSHOT_PERIOD);
+        manager.ForEachListInRange(&setup.vIndexes[nStart], &setup.vIndexes.back(), [&](const CDeterministicMNList& mnList) {
+            auto payee = mnList.GetMNPayee();
+            assert(payee != nullptr);
+            return true;
+        });
+    }
+}
+
+static void DMNHistoryLookup_576(benchmark::State& state) { DMNHistoryLookup(state, DEFAULT_DMN_SNAPSHOT_PERIOD); }
+static void DMNHistoryLookup_64(benchmark::State& state) { DMNHistoryLookup(state, 64); }
+
+BENCHMARK(DMNHistoryLookup_576, 5);
+BENCHMARK(DMNHistoryLookup_64, 20);
+BENCHMARK(DMNHistoryRangeLookup, 1);
+BENCHMARK(DMNHistoryRangeScan, 5);
@@ -0,0 +1,89 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <pos/kernel.h>
+#include <pos/stakeinput.h>
+#include <random.h>
+
+static const int STAKE_INPUTS = 10000;
+
+struct StakeKernelSetup
+{
+    CBlockIndex indexPrev;
+    std::vector<CBlockIndex> vIndexFrom;
+    std::vector<CStake> vStakes;
+
+    StakeKernelSetup()
+    {
+        SelectParams(CBaseChainParams::MAIN);
+        FastRandomContext rng(true);
+
+        indexPrev.nHeight = Params().GetConsensus().nBlockStakeModifierV2 + 1000;
+        indexPrev.nStakeModifierV2 = rng.rand256();
+
+        vIndexFrom.resize(STAKE_INPUTS);
+        vStakes.resize(STAKE_INPUTS);
+        for (int i = 0; i < STAKE_INPUTS; i++) {
+            vIndexFrom[i].nHeight = i;
+            vIndexFrom[i].nTime = 1600000000 + i * 60;
+
+            CMutableTransaction tx;
+            tx.vin.resize(1);
+            tx.vin[0].prevout = COutPoint(rng.rand256(), 0);
+            tx.vout.resize(1);
+            tx.vout[0].nValue = 100 * COIN;
+            vStakes[i].SetInput(MakeTransactionRef(tx), 0, &vIndexFrom[i]);
+        }
+    }
+};
+
+// Kernel hash as computed before CStakeKernelHasher: the whole kernel is serialized for every attempt
+static uint256 GetKernelHashStream(const CBlockIndex* pindexPrev, CStakeInput* stake, const unsigned int nTimeTx)
+{
+    CDataStream modifier_ss(SER_GETHASH, 0);
+    modifier_ss << pindexPrev->nStakeModifierV2;
+    CDataStream ss(modifier_ss);
+    ss << stake->GetIndexFrom()->nTime << stake->GetUniqueness() << nTimeTx;
+    return Hash(ss.begin(), ss.end());
+}
+
+static void StakeKernelHashStream(benchmark::State& state)
+{
+    StakeKernelSetup setup;
+    unsigned int nTimeTx = 1700000000;
+
+    while (state.KeepRunning()) {
+        for (CStake& stake : setup.vStakes) {
+            GetKernelHashStream(&setup.indexPrev, &stake, nTimeTx);
+        }
+        nTimeTx += 15;
+    }
+}
+
+static void StakeKernelHashMidstate(benchmark::State& state)
+{
+    StakeKernelSetup setup;
+    unsigned int nTimeTx = 1700000000;
+
+    std::vector<CStakeKernelHasher> vHashers(STAKE_INPUTS);
+    for (int i = 0; i < STAKE_INPUTS; i++) {
+        bool fInit = vHashers[i].Init(&setup.indexPrev, &setup.vStakes[i]);
+        assert(fInit);
+        assert(vHashers[i].GetHash(nTimeTx) == GetKernelHashStream(&setup.indexPrev, &setup.vStakes[i], nTimeTx));
+    }
+
+    while (state.KeepRunning()) {
+        for (const CStakeKernelHasher& hasher : vHashers) {
+            hasher.GetHash(nTimeTx);
+        }
+        nTimeTx += 15;
+    }
+}
+
+BENCHMARK(StakeKernelHashStream, 50);
+BENCHMARK(StakeKernelHashMidstate, 150);
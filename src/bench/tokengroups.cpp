@@ -0,0 +1,117 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <chainparams.h>
+#include <coins.h>
+#include <consensus/tokengroups.h>
+#include <consensus/validation.h>
+#include <key.h>
+#include <random.h>
+#include <tokens/tokengroupmanager.h>
+
+static const int TOKEN_TRANSFERS = 1000;
+static const CAmount TOKEN_AMOUNT = 500;
+
+static CScript GroupedP2PKH(const CTokenGroupID& group, const CKeyID& dest, CAmount amount)
+{
+    return CScript() << group.bytes() << SerializeAmount(amount) << OP_GROUP << OP_DROP << OP_DROP << OP_DUP
+                     << OP_HASH160 << ToByteVector(dest) << OP_EQUALVERIFY << OP_CHECKSIG;
+}
+
+// A block full of token transfers, each spending both token outputs of the transfer before it
+struct TokenTransferBlockSetup
+{
+    CCoinsView coinsDummy;
+    CCoinsViewCache view;
+    CTokenGroupID group;
+    std::vector<CTransactionRef> vtx;
+
+    TokenTransferBlockSetup() : view(&coinsDummy)
+    {
+        SelectParams(CBaseChainParams::REGTEST);
+        if (!tokenGroupManager) {
+            tokenGroupManager = std::make_shared<CTokenGroupManager>();
+        }
+
+        FastRandomContext rng(true);
+        group = CTokenGroupID(rng.rand256());
+        CKeyID dest(uint160(rng.randbytes(20)));
+        const int nHeight = Params().GetConsensus().ATPStartHeight + 1;
+
+        CMutableTransaction funding;
+        funding.vin.resize(1);
+        funding.vin[0].prevout = COutPoint(rng.rand256(), 0);
+        funding.vout.resize(2);
+        for (auto& out : funding.vout) {
+            out.nValue = COIN;
+            out.scriptPubKey = GroupedP2PKH(group, dest, TOKEN_AMOUNT);
+        }
+        AddCoins(view, funding, nHeight);
+
+        uint256 prevHash = funding.GetHash();
+        for (int i = 0; i < TOKEN_TRANSFERS; i++) {
+            CMutableTransaction tx;
+            tx.vin.resize(2);
+            tx.vin[0].prevout = COutPoint(prevHash, 0);
+            tx.vin[1].prevout = COutPoint(prevHash, 1);
+            tx.vout.resize(2);
+            for (auto& out : tx.vout) {
+                out.nValue = COIN;
+                out.scriptPubKey = GroupedP2PKH(group, dest, TOKEN_AMOUNT);
+            }
+            // The coins stay in the view so every transfer can be checked in any order
+            AddCoins(view, tx, nHeight);
+            vtx.emplace_back(MakeTransactionRef(tx));
+            prevHash = vtx.back()->GetHash();
+        }
+    }
+};
+
+// Every consumer parses the grouped outputs and inputs again, as ConnectBlock did before
+static void TokenGroupAccountingReparse(benchmark::State& state)
+{
+    TokenTransferBlockSetup setup;
+
+    while (state.KeepRunning()) {
+        for (const auto& tx : setup.vtx) {
+            CValidationState valstate;
+            std::unordered_map<CTokenGroupID, CTokenGroupBalance> balance;
+            bool ok = CheckTokenGroups(*tx, valstate, setup.view, balance);
+            assert(ok);
+            ok = IsAnyOutputGrouped(*tx);
+            assert(ok);
+            uint16_t nTokenCount = 0;
+            CAmount nTokenMint = 0;
+            tokenGroupManager->GetTokenTxStats(tx, setup.view, setup.group, nTokenCount, nTokenMint);
+            assert(nTokenMint == 0);
+        }
+    }
+}
+
+// The outputs are parsed once per block and shared by all consumers
+static void TokenGroupAccountingBlockData(benchmark::State& state)
+{
+    TokenTransferBlockSetup setup;
+
+    while (state.KeepRunning()) {
+        CTokenGroupBlockData blockData;
+        for (const auto& tx : setup.vtx) {
+            CValidationState valstate;
+            const CTokenGroupTxData& txData = blockData.Add(*tx);
+            std::unordered_map<CTokenGroupID, CTokenGroupBalance> balance;
+            bool ok = CheckTokenGroups(*tx, txData, valstate, setup.view, balance, &blockData);
+            assert(ok);
+            assert(txData.fAnyGrouped);
+            uint16_t nTokenCount = 0;
+            CAmount nTokenMint = 0;
+            tokenGroupManager->GetTokenTxStats(tx, setup.view, setup.group, nTokenCount, nTokenMint, &blockData);
+            assert(nTokenMint == 0);
+        }
+    }
+}
+
+BENCHMARK(TokenGroupAccountingReparse, 10);
+BENCHMARK(TokenGroupAccountingBlockData, 10);
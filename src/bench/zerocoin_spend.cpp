@@ -0,0 +1,138 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <checkqueue.h>
+#include <key.h>
+#include <pos/checks.h>
+#include <random.h>
+#include <util.h>
+#include <zbytz/zbytzmodule.h>
+
+#include <boost/thread/thread.hpp>
+
+static const int ZEROCOIN_SPENDS = 100;
+static const int MIN_CORES = 2;
+static const unsigned int QUEUE_BATCH_SIZE = 16;
+
+// A block of public zerocoin spends, each opening its mint and signed by the key of its serial
+struct ZerocoinSpendBlockSetup
+{
+    CBlockIndex index;
+    std::vector<CTransactionRef> vtx;
+    std::vector<std::shared_ptr<const libzerocoin::CoinSpend> > vSpends;
+
+    ZerocoinSpendBlockSetup()
+    {
+        SelectParams(CBaseChainParams::MAIN);
+        libzerocoin::ZerocoinParams* params = Params().Zerocoin_Params(false);
+        index.nHeight = Params().GetConsensus().nBlockZerocoinV2;
+
+        FastRandomContext rng(true);
+        for (int i = 0; i < ZEROCOIN_SPENDS; i++) {
+            CKey key;
+            CBigNum bnSerial;
+            while (!libzerocoin::GenerateKeyPair(params->coinCommitmentGroup.groupOrder, UintToArith256(rng.rand256()), key, bnSerial)) {}
+            CBigNum bnRandomness = CBigNum::randBignum(params->coinCommitmentGroup.groupOrder);
+            libzerocoin::Commitment commitment(&params->coinCommitmentGroup, bnSerial, bnRandomness);
+
+            auto spend = std::make_shared<PublicCoinSpend>(params, bnSerial, bnRandomness, key.GetPubKey());
+            spend->pubCoin = libzerocoin::PublicCoin(params, commitment.getCommitmentValue(), libzerocoin::ZQ_ONE);
+            spend->setDenom(libzerocoin::ZQ_ONE);
+            spend->txHash = rng.rand256();
+            spend->outputIndex = 0;
+
+            CMutableTransaction tx;
+            tx.vin.resize(1);
+            tx.vin[0].prevout = COutPoint(spend->txHash, spend->outputIndex);
+            tx.vout.resize(1);
+            tx.vout[0].nValue = COIN;
+            CMutableTransaction txNoIn(tx);
+            txNoIn.vin.clear();
+            spend->setTxOutHash(txNoIn.GetHash());
+
+            std::vector<unsigned char> vchSig;
+            bool ok = key.Sign(spend->signatureHash(), vchSig);
+            assert(ok);
+            spend->setVchSig(vchSig);
+
+            vtx.emplace_back(MakeTransactionRef(tx));
+            vSpends.emplace_back(spend);
+        }
+    }
+
+    std::vector<CZerocoinSpendCheck> MakeChecks()
+    {
+        std::vector<CZerocoinSpendCheck> vChecks;
+        vChecks.reserve(ZEROCOIN_SPENDS);
+        for (int i = 0; i < ZEROCOIN_SPENDS; i++) {
+            vChecks.emplace_back(vSpends[i], *vtx[i], &index, true);
+        }
+        return vChecks;
+    }
+};
+
+// Every spend is verified on the validation thread
+static void ZerocoinSpendVerifySerial(benchmark::State& state)
+{
+    ZerocoinSpendBlockSetup setup;
+
+    while (state.KeepRunning()) {
+        std::vector<CZerocoinSpendCheck> vChecks = setup.MakeChecks();
+        for (auto& check : vChecks) {
+            bool ok = check();
+            assert(ok);
+        }
+    }
+}
+
+// The spends are verified on the check queue, one transaction at a time as ConnectBlock adds them
+static void ZerocoinSpendVerifyParallel(benchmark::State& state)
+{
+    ZerocoinSpendBlockSetup setup;
+
+    CCheckQueue<CZerocoinSpendCheck> queue {QUEUE_BATCH_SIZE};
+    boost::thread_group tg;
+    for (auto x = 0; x < std::max(MIN_CORES, GetNumCores()) - 1; ++x) {
+        tg.create_thread([&]{queue.Thread();});
+    }
+    while (state.KeepRunning()) {
+        CCheckQueueControl<CZerocoinSpendCheck> control(&queue);
+        std::vector<CZerocoinSpendCheck> vChecks = setup.MakeChecks();
+        for (auto& check : vChecks) {
+            std::vector<CZerocoinSpendCheck> vTxChecks(1);
+            vTxChecks[0].swap(check);
+            control.Add(vTxChecks);
+        }
+        bool ok = control.Wait();
+        assert(ok);
+    }
+    tg.interrupt_all();
+    tg.join_all();
+}
+
+// The zero knowledge proofs of a private spend, dominated by exponentiations of the group generators
+static void ZerocoinCoinSpendVerify(benchmark::State& state)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    libzerocoin::ZerocoinParams* params = Params().Zerocoin_Params(false);
+
+    libzerocoin::PrivateCoin coin(params, libzerocoin::ZQ_ONE);
+    libzerocoin::Accumulator accumulator(params, libzerocoin::ZQ_ONE);
+    libzerocoin::AccumulatorWitness witness(params, accumulator, coin.getPublicCoin());
+    accumulator += coin.getPublicCoin();
+    libzerocoin::CoinSpend spend(params, params, coin, accumulator, 0, witness, uint256(), libzerocoin::SpendType::SPEND);
+
+    while (state.KeepRunning()) {
+        bool ok = spend.Verify(accumulator);
+        assert(ok);
+    }
+}
+
+BENCHMARK(ZerocoinSpendVerifySerial, 30);
+BENCHMARK(ZerocoinSpendVerifyParallel, 30);
+BENCHMARK(ZerocoinCoinSpendVerify, 10);
@@ -8,10 +8,14 @@
 #include <consensus/consensus.h>
 #include <random.h>
 
+#include <algorithm>
+#include <limits>
+#include <map>
+
 bool CCoinsView::GetCoin(const COutPoint &outpoint, Coin &coin) const { return false; }
 uint256 CCoinsView::GetBestBlock() const { return uint256(); }
 std::vector<uint256> CCoinsView::GetHeadBlocks() const { return std::vector<uint256>(); }
-bool CCoinsView::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) { return false; }
+bool CCoinsView::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock, bool erase) { return false; }
 CCoinsViewCursor *CCoinsView::Cursor() const { return nullptr; }
 
 bool CCoinsView::HaveCoin(const COutPoint &outpoint) const
@@ -26,13 +30,16 @@ bool CCoinsViewBacked::HaveCoin(const COutPoint &outpoint) const { return base->
 uint256 CCoinsViewBacked::GetBestBlock() const { return base->GetBestBlock(); }
 std::vector<uint256> CCoinsViewBacked::GetHeadBlocks() const { return base->GetHeadBlocks(); }
 void CCoinsViewBacked::SetBackend(CCoinsView &viewIn) { base = &viewIn; }
-bool CCoinsViewBacked::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) { return base->BatchWrite(mapCoins, hashBlock); }
+bool CCoinsViewBacked::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock, bool erase) { return base->BatchWrite(mapCoins, hashBlock, erase); }
 CCoinsViewCursor *CCoinsViewBacked::Cursor() const { return base->Cursor(); }
 size_t CCoinsViewBacked::EstimateSize() const { return base->EstimateSize(); }
 
 SaltedOutpointHasher::SaltedOutpointHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
 
-CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn) : CCoinsViewBacked(baseIn), cachedCoinsUsage(0) {}
+CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn) :
+    CCoinsViewBacked(baseIn),
+    cacheCoins(0, SaltedOutpointHasher(), CCoinsMap::key_equal(), &cacheCoinsMemoryResource),
+    cachedCoinsUsage(0), nCacheHits(0), nCacheMisses(0) {}
 
 size_t CCoinsViewCache::DynamicMemoryUsage() const {
     return memusage::DynamicUsage(cacheCoins) + cachedCoinsUsage;
@@ -40,8 +47,11 @@ size_t CCoinsViewCache::DynamicMemoryUsage() const {
 
 CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const {
     CCoinsMap::iterator it = cacheCoins.find(outpoint);
-    if (it != cacheCoins.end())
+    if (it != cacheCoins.end()) {
+        nCacheHits++;
         return it;
+    }
+    nCacheMisses++;
     Coin tmp;
     if (!base->GetCoin(outpoint, tmp))
         return cacheCoins.end();
@@ -55,6 +65,19 @@ CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const
     return ret;
 }
 
+void CCoinsViewCache::AddPrefetchedCoin(const COutPoint &outpoint, Coin&& coin) {
+    CCoinsMap::iterator it;
+    bool inserted;
+    std::tie(it, inserted) = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::forward_as_tuple(std::move(coin)));
+    if (!inserted) {
+        return;
+    }
+    if (it->second.coin.IsSpent()) {
+        it->second.flags = CCoinsCacheEntry::FRESH;
+    }
+    cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
+}
+
 bool CCoinsViewCache::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     CCoinsMap::const_iterator it = FetchCoin(outpoint);
     if (it != cacheCoins.end()) {
@@ -144,8 +167,8 @@ void CCoinsViewCache::SetBestBlock(const uint256 &hashBlockIn) {
     hashBlock = hashBlockIn;
 }
 
-bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn) {
-    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end(); it = mapCoins.erase(it)) {
+bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn, bool erase) {
+    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end(); it = erase ? mapCoins.erase(it) : std::next(it)) {
         // Ignore non-dirty entries (optimization).
         if (!(it->second.flags & CCoinsCacheEntry::DIRTY)) {
             continue;
@@ -158,7 +181,11 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
                 // Otherwise we will need to create it in the parent
                 // and move the data up and mark it as dirty
                 CCoinsCacheEntry& entry = cacheCoins[it->first];
-                entry.coin = std::move(it->second.coin);
+                if (erase) {
+                    entry.coin = std::move(it->second.coin);
+                } else {
+                    entry.coin = it->second.coin;
+                }
                 cachedCoinsUsage += entry.coin.DynamicMemoryUsage();
                 entry.flags = CCoinsCacheEntry::DIRTY;
                 // We can mark it FRESH in the parent if it was FRESH in the child
@@ -187,7 +214,11 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
             } else {
                 // A normal modification.
                 cachedCoinsUsage -= itUs->second.coin.DynamicMemoryUsage();
-                itUs->second.coin = std::move(it->second.coin);
+                if (erase) {
+                    itUs->second.coin = std::move(it->second.coin);
+                } else {
+                    itUs->second.coin = it->second.coin;
+                }
                 cachedCoinsUsage += itUs->second.coin.DynamicMemoryUsage();
                 itUs->second.flags |= CCoinsCacheEntry::DIRTY;
                 // NOTE: It is possible the child has a FRESH flag here in
@@ -203,12 +234,91 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
 }
 
 bool CCoinsViewCache::Flush() {
-    bool fOk = base->BatchWrite(cacheCoins, hashBlock);
-    cacheCoins.clear();
+    bool fOk = base->BatchWrite(cacheCoins, hashBlock, true);
+    ReallocateCache();
     cachedCoinsUsage = 0;
     return fOk;
 }
 
+bool CCoinsViewCache::Sync(size_t& nWritten)
+{
+    nWritten = 0;
+    for (const auto& entry : cacheCoins) {
+        if (entry.second.flags & CCoinsCacheEntry::DIRTY) {
+            nWritten++;
+        }
+    }
+    // Write the dirty entries without erasing them, copying them out would double the memory use of a full cache.
+    if (!base->BatchWrite(cacheCoins, hashBlock, false)) {
+        return false;
+    }
+
+    // The base now has every entry, so nothing here is dirty or fresh any more.
+    for (CCoinsMap::iterator it = cacheCoins.begin(); it != cacheCoins.end(); ) {
+        if (it->second.coin.IsSpent()) {
+            cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
+            it = cacheCoins.erase(it);
+        } else {
+            it->second.flags = 0;
+            ++it;
+        }
+    }
+    return true;
+}
+
+size_t CCoinsViewCache::Trim(size_t nTargetUsage)
+{
+    size_t nUsage = DynamicMemoryUsage();
+    if (nUsage <= nTargetUsage) {
+        return 0;
+    }
+
+    // An erased node goes back to the pool, where it no longer counts as used. Its block is at
+    // least as large as the node, so this never overestimates what an eviction frees.
+    const size_t nEntryUsage = sizeof(memusage::unordered_node<CCoinsMap::value_type>);
+
+    // Usage of the clean entries per height, to find the height below which they have to go.
+    std::map<int, size_t> mapCleanUsage;
+    for (const auto& entry : cacheCoins) {
+        if (entry.second.flags == 0) {
+            mapCleanUsage[(int)entry.second.coin.nHeight] += nEntryUsage + entry.second.coin.DynamicMemoryUsage();
+        }
+    }
+    int nCutoffHeight = std::numeric_limits<int>::min();
+    for (const auto& clean : mapCleanUsage) {
+        if (nUsage <= nTargetUsage) {
+            break;
+        }
+        nUsage -= std::min(nUsage, clean.second);
+        nCutoffHeight = clean.first + 1;
+    }
+
+    size_t nEvicted = 0;
+    for (CCoinsMap::iterator it = cacheCoins.begin(); it != cacheCoins.end(); ) {
+        if (it->second.flags == 0 && (int)it->second.coin.nHeight < nCutoffHeight) {
+            cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
+            it = cacheCoins.erase(it);
+            nEvicted++;
+        } else {
+            ++it;
+        }
+    }
+
+    // Shrink the bucket array to the entries left.
+    cacheCoins.rehash(0);
+    return nEvicted;
+}
+
+void CCoinsViewCache::ReallocateCache()
+{
+    // The pool keeps its chunks until it is destroyed, and clear() keeps the bucket array, so
+    // rebuild both in place to release the memory of a large cache after a flush.
+    cacheCoins.~CCoinsMap();
+    cacheCoinsMemoryResource.~CCoinsMapMemoryResource();
+    ::new (&cacheCoinsMemoryResource) CCoinsMapMemoryResource();
+    ::new (&cacheCoins) CCoinsMap(0, SaltedOutpointHasher(), CCoinsMap::key_equal(), &cacheCoinsMemoryResource);
+}
+
 void CCoinsViewCache::Uncache(const COutPoint& hash)
 {
     CCoinsMap::iterator it = cacheCoins.find(hash);
@@ -12,6 +12,7 @@
 #include <hash.h>
 #include <memusage.h>
 #include <serialize.h>
+#include <support/allocators/pool.h>
 #include <uint256.h>
 
 #include <assert.h>
@@ -131,7 +132,16 @@ struct CCoinsCacheEntry
     explicit CCoinsCacheEntry(Coin&& coin_) : coin(std::move(coin_)), flags(0) {}
 };
 
-typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
+/**
+ * The nodes of the UTXO cache come from a pool, as the cache inserts and erases millions of entries
+ * of a single size. The largest pooled block fits a node: the entry plus the bucket link and the
+ * cached hash, with some headroom for standard libraries that store more per node.
+ */
+typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher, std::equal_to<COutPoint>,
+                           PoolAllocator<std::pair<const COutPoint, CCoinsCacheEntry>,
+                                         sizeof(std::pair<const COutPoint, CCoinsCacheEntry>) + sizeof(void*) * 4> > CCoinsMap;
+
+typedef CCoinsMap::allocator_type::ResourceType CCoinsMapMemoryResource;
 
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
@@ -176,8 +186,9 @@ public:
     virtual std::vector<uint256> GetHeadBlocks() const;
 
     //! Do a bulk modification (multiple Coin changes + BestBlock change).
-    //! The passed mapCoins can be modified.
-    virtual bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock);
+    //! The passed mapCoins can be modified. If erase is true the entries are moved out of mapCoins,
+    //! otherwise they are left in mapCoins and only copied.
+    virtual bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock, bool erase);
 
     //! Get a cursor to iterate over the whole state
     virtual CCoinsViewCursor *Cursor() const;
@@ -203,7 +214,8 @@ public:
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
     void SetBackend(CCoinsView &viewIn);
-    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    CCoinsView* GetBackend() const { return base; }
+    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock, bool erase) override;
     CCoinsViewCursor *Cursor() const override;
     size_t EstimateSize() const override;
 };
@@ -218,11 +230,18 @@ protected:
      * declared as "const".
      */
     mutable uint256 hashBlock;
+    /* Backs the nodes of cacheCoins, so it must be declared first. */
+    mutable CCoinsMapMemoryResource cacheCoinsMemoryResource;
     mutable CCoinsMap cacheCoins;
 
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage;
 
+    /* Lookups answered from the cache and lookups that went to the backing view. Like cacheCoins
+     * they are only touched by the thread using the cache, which for pcoinsTip holds cs_main. */
+    mutable uint64_t nCacheHits;
+    mutable uint64_t nCacheMisses;
+
 public:
     CCoinsViewCache(CCoinsView *baseIn);
 
@@ -236,7 +255,7 @@ public:
     bool HaveCoin(const COutPoint &outpoint) const override;
     uint256 GetBestBlock() const override;
     void SetBestBlock(const uint256 &hashBlock);
-    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock, bool erase) override;
     CCoinsViewCursor* Cursor() const override {
         throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
     }
@@ -248,6 +267,12 @@ public:
      */
     bool HaveCoinInCache(const COutPoint &outpoint) const;
 
+    /**
+     * Add a coin that was read from the backing view ahead of time, exactly as the first
+     * access would have added it. Does nothing if the outpoint is already cached.
+     */
+    void AddPrefetchedCoin(const COutPoint &outpoint, Coin&& coin);
+
     /**
      * Return a reference to Coin in the cache, or a pruned one if not found. This is
      * more efficient than GetCoin.
@@ -280,6 +305,22 @@ public:
      */
     bool Flush();
 
+    /**
+     * Push the modifications applied to this cache to its base, like Flush(), but keep the
+     * unspent entries resident as clean entries. Spent entries are dropped. nWritten is set
+     * to the number of entries written.
+     * If false is returned, the state of this cache (and its backing view) will be undefined.
+     */
+    bool Sync(size_t& nWritten);
+
+    /**
+     * Evict unmodified entries until DynamicMemoryUsage() is at most nTargetUsage, or no
+     * unmodified entries are left. Coins created at the lowest heights are evicted first,
+     * as recent outputs are the ones most likely to be spent soon. Returns the number of
+     * entries evicted.
+     */
+    size_t Trim(size_t nTargetUsage);
+
     /**
      * Removes the UTXO with the given outpoint from the cache, if it is
      * not modified.
@@ -292,6 +333,12 @@ public:
     //! Calculate the size of the cache (in bytes)
     size_t DynamicMemoryUsage() const;
 
+    //! Number of lookups answered from the cache
+    uint64_t GetCacheHits() const { return nCacheHits; }
+
+    //! Number of lookups that had to query the backing view
+    uint64_t GetCacheMisses() const { return nCacheMisses; }
+
     /**
      * Amount of bytz coming in to a transaction
      * Note that lightweight clients may not know anything besides the hash of previous transactions,
@@ -307,6 +354,9 @@ public:
 
 private:
     CCoinsMap::iterator FetchCoin(const COutPoint &outpoint) const;
+
+    /** Empty the cache and give its memory back to the system, pooled nodes included. */
+    void ReallocateCache();
 };
 
 //! Utility function to add all of a transaction's outputs to a cache.
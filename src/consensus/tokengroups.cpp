@@ -52,7 +52,7 @@ bool AnyInputsGrouped(const CTransaction &transaction, const int nHeight, const
     return anyInputsGrouped;
 }
 
-bool IsTokenManagementKey(CScript script) {
+bool IsTokenManagementKey(const CScript& script) {
     // Initially, the TokenManagementKey enables management token operations
     // When the MGTToken is created, the MGTToken enables management token operations
     if (!tokenGroupManager.get()->MGTTokensCreated()) {
@@ -63,17 +63,22 @@ bool IsTokenManagementKey(CScript script) {
     return false;
 }
 
-bool IsMGTInput(CScript script) {
+bool IsMGTInput(const CTokenGroupInfo& grp) {
     // Initially, the TokenManagementKey enables management token operations
     // When the MGTToken is created, the MGTToken enables management token operations
     if (tokenGroupManager.get()->MGTTokensCreated()) {
-        CTokenGroupInfo grp(script);
         return grp.associatedGroup == tokenGroupManager.get()->GetMGTID();
     }
     return false;
 }
 
 bool CheckTokenGroups(const CTransaction &tx, CValidationState &state, const CCoinsViewCache &view, std::unordered_map<CTokenGroupID, CTokenGroupBalance>& gBalance)
+{
+    return CheckTokenGroups(tx, CTokenGroupTxData(tx), state, view, gBalance);
+}
+
+bool CheckTokenGroups(const CTransaction &tx, const CTokenGroupTxData &tgTxData, CValidationState &state, const CCoinsViewCache &view,
+                      std::unordered_map<CTokenGroupID, CTokenGroupBalance>& gBalance, const CTokenGroupBlockData *pBlockData)
 {
     gBalance.clear();
 
@@ -81,10 +86,8 @@ bool CheckTokenGroups(const CTransaction &tx, CValidationState &state, const CCo
     bool anyInputsGroupManagement = false;
 
     // Iterate through all the outputs constructing the final balances of every group.
-    for (const auto &outp : tx.vout)
+    for (const CTokenGroupInfo &tokenGrp : tgTxData.vOutputs)
     {
-        const CScript &scriptPubKey = outp.scriptPubKey;
-        CTokenGroupInfo tokenGrp(scriptPubKey);
         if (tokenGrp.invalid)
             return state.Invalid(false, REJECT_INVALID, "bad OP_GROUP");
         if (tokenGrp.associatedGroup != NoGroup)
@@ -127,9 +130,9 @@ bool CheckTokenGroups(const CTransaction &tx, CValidationState &state, const CCo
         if (coin.nHeight < Params().GetConsensus().ATPStartHeight)
             continue;
 
-        anyInputsGroupManagement = anyInputsGroupManagement || IsMGTInput(script);
+        const CTokenGroupInfo tokenGrp = pBlockData ? pBlockData->GetOutput(prevout, script) : CTokenGroupInfo(script);
+        anyInputsGroupManagement = anyInputsGroupManagement || IsMGTInput(tokenGrp);
 
-        CTokenGroupInfo tokenGrp(script);
         // The prevout should never be invalid because that would mean that this node accepted a block with an
         // invalid OP_GROUP tx in it.
         if (tokenGrp.invalid)
@@ -40,6 +40,10 @@ public:
 
 // Verify that the token groups in this transaction properly balance
 bool CheckTokenGroups(const CTransaction &tx, CValidationState &state, const CCoinsViewCache &view, std::unordered_map<CTokenGroupID, CTokenGroupBalance>& gBalance);
+// Same, using the already parsed outputs of the transaction and, when connecting a block,
+// the parsed outputs of the earlier transactions in the block
+bool CheckTokenGroups(const CTransaction &tx, const CTokenGroupTxData &tgTxData, CValidationState &state, const CCoinsViewCache &view,
+                      std::unordered_map<CTokenGroupID, CTokenGroupBalance>& gBalance, const CTokenGroupBlockData *pBlockData = nullptr);
 
 bool AnyInputsGrouped(const CTransaction &transaction, const int nHeight, const CCoinsViewCache& view, const CTokenGroupID tgID);
 bool GetTokenBalance(const CTransaction& tx, const CTokenGroupID& tgID, CValidationState& state, const CCoinsViewCache& view, CAmount& nCredit, CAmount& nDebit);
@@ -83,11 +83,17 @@ void CDSNotificationInterface::TransactionAddedToMempool(const CTransactionRef&
     llmq::quorumInstantSendManager->TransactionAddedToMempool(ptx);
     llmq::chainLocksHandler->TransactionAddedToMempool(ptx, nAcceptTime);
     CCoinJoin::TransactionAddedToMempool(ptx);
+#ifdef ENABLE_WALLET
+    stakingManager->TransactionAddedToMempool(ptx);
+#endif // ENABLE_WALLET
 }
 
 void CDSNotificationInterface::TransactionRemovedFromMempool(const CTransactionRef& ptx, MemPoolRemovalReason reason)
 {
     llmq::quorumInstantSendManager->TransactionRemovedFromMempool(ptx);
+#ifdef ENABLE_WALLET
+    stakingManager->TransactionRemovedFromMempool(ptx);
+#endif // ENABLE_WALLET
 }
 
 void CDSNotificationInterface::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted)
@@ -103,6 +109,9 @@ void CDSNotificationInterface::BlockConnected(const std::shared_ptr<const CBlock
     llmq::quorumInstantSendManager->BlockConnected(pblock, pindex, vtxConflicted);
     llmq::chainLocksHandler->BlockConnected(pblock, pindex, vtxConflicted);
     CCoinJoin::BlockConnected(pblock, pindex, vtxConflicted);
+#ifdef ENABLE_WALLET
+    stakingManager->BlockConnected(pblock, pindex, vtxConflicted);
+#endif // ENABLE_WALLET
 }
 
 void CDSNotificationInterface::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected)
@@ -110,6 +119,9 @@ void CDSNotificationInterface::BlockDisconnected(const std::shared_ptr<const CBl
     llmq::quorumInstantSendManager->BlockDisconnected(pblock, pindexDisconnected);
     llmq::chainLocksHandler->BlockDisconnected(pblock, pindexDisconnected);
     CCoinJoin::BlockDisconnected(pblock, pindexDisconnected);
+#ifdef ENABLE_WALLET
+    stakingManager->BlockDisconnected(pblock, pindexDisconnected);
+#endif // ENABLE_WALLET
 }
 
 void CDSNotificationInterface::NotifyMasternodeListChanged(bool undo, const CDeterministicMNList& oldMNList, const CDeterministicMNListDiff& diff)
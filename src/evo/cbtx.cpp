@@ -172,6 +172,9 @@ bool CalcCbTxMerkleRootMNList(const CBlock& block, const CBlockIndex* pindexPrev
     static int64_t nTimeSMNL = 0;
     static int64_t nTimeMerkle = 0;
 
+    static CDeterministicMNList mnListCached;
+    static CSimplifiedMNListMerkleTree smlTreeCached;
+
     int64_t nTime1 = GetTimeMicros();
 
     try {
@@ -184,33 +187,30 @@ bool CalcCbTxMerkleRootMNList(const CBlock& block, const CBlockIndex* pindexPrev
         int64_t nTime2 = GetTimeMicros(); nTimeDMN += nTime2 - nTime1;
         LogPrint(BCLog::BENCHMARK, "            - BuildNewListFromBlock: %.2fms [%.2fs]\n", 0.001 * (nTime2 - nTime1), nTimeDMN * 0.000001);
 
-        CSimplifiedMNList sml(tmpMNList);
-
-        int64_t nTime3 = GetTimeMicros(); nTimeSMNL += nTime3 - nTime2;
-        LogPrint(BCLog::BENCHMARK, "            - CSimplifiedMNList: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeSMNL * 0.000001);
-
-        static CSimplifiedMNList smlCached;
-        static uint256 merkleRootCached;
-        static bool mutatedCached{false};
-
-        if (sml.mnList == smlCached.mnList) {
-            merkleRootRet = merkleRootCached;
-            if (mutatedCached) {
-                return state.DoS(100, false, REJECT_INVALID, "mutated-cached-calc-cb-mnmerkleroot");
+        // The tree of the last previous block's list is kept and forked for each block built on top of it.
+        // Moving it to another previous block (next block or reorg) only applies the diff between the lists.
+        auto prevMNList = deterministicMNManager->GetListForBlock(pindexPrev);
+        if (mnListCached.GetBlockHash() != prevMNList.GetBlockHash()) {
+            if (smlTreeCached.size() == 0) {
+                smlTreeCached = CSimplifiedMNListMerkleTree(CSimplifiedMNList(prevMNList));
+            } else {
+                smlTreeCached.ApplyDiff(mnListCached, prevMNList, mnListCached.BuildDiff(prevMNList));
             }
-            return true;
+            smlTreeCached.CalcMerkleRoot();
+            mnListCached = prevMNList;
         }
+        CSimplifiedMNListMerkleTree smlTree(smlTreeCached);
+        smlTree.ApplyDiff(prevMNList, tmpMNList, prevMNList.BuildDiff(tmpMNList));
+
+        int64_t nTime3 = GetTimeMicros(); nTimeSMNL += nTime3 - nTime2;
+        LogPrint(BCLog::BENCHMARK, "            - CSimplifiedMNListMerkleTree: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeSMNL * 0.000001);
 
         bool mutated = false;
-        merkleRootRet = sml.CalcMerkleRoot(&mutated);
+        merkleRootRet = smlTree.CalcMerkleRoot(&mutated);
 
         int64_t nTime4 = GetTimeMicros(); nTimeMerkle += nTime4 - nTime3;
         LogPrint(BCLog::BENCHMARK, "            - CalcMerkleRoot: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), nTimeMerkle * 0.000001);
 
-        smlCached = std::move(sml);
-        merkleRootCached = merkleRootRet;
-        mutatedCached = mutated;
-
         if (mutated) {
             return state.DoS(100, false, REJECT_INVALID, "mutated-calc-cb-mnmerkleroot");
         }
@@ -218,6 +218,9 @@ bool CalcCbTxMerkleRootMNList(const CBlock& block, const CBlockIndex* pindexPrev
         return true;
     } catch (const std::exception& e) {
         LogPrintf("%s -- failed: %s\n", __func__, e.what());
+        // the cached tree may be partially updated
+        mnListCached = CDeterministicMNList();
+        smlTreeCached = CSimplifiedMNListMerkleTree();
         return state.DoS(100, false, REJECT_INVALID, "failed-calc-cb-mnmerkleroot");
     }
 }
@@ -21,9 +21,14 @@
 
 #include <univalue.h>
 
+#include <future>
+
 static const std::string DB_LIST_SNAPSHOT = "dmn_S";
 static const std::string DB_LIST_DIFF = "dmn_D";
 
+// minimum number of MN scores a worker thread of CalculateScores gets
+static const size_t SCORES_PER_WORKER_MIN = 1000;
+
 std::unique_ptr<CDeterministicMNManager> deterministicMNManager;
 
 std::string CDeterministicMNState::ToString() const
@@ -215,20 +220,37 @@ static bool CompareByLastPaid(const CDeterministicMNCPtr& _a, const CDeterminist
     return CompareByLastPaid(*_a, *_b);
 }
 
-CDeterministicMNCPtr CDeterministicMNList::GetMNPayee() const
+void CDeterministicMNList::AddToPaymentOrder(const CDeterministicMNCPtr& dmn)
 {
-    if (mnMap.size() == 0) {
-        return nullptr;
+    if (!IsMNValid(dmn)) {
+        return;
     }
+    auto it = std::upper_bound(mnPaymentOrder.begin(), mnPaymentOrder.end(), dmn, [](const CDeterministicMNCPtr& a, const CDeterministicMNCPtr& b) {
+        return CompareByLastPaid(a, b);
+    });
+    mnPaymentOrder = mnPaymentOrder.insert(it - mnPaymentOrder.begin(), dmn);
+}
 
-    CDeterministicMNCPtr best;
-    ForEachMN(true, [&](const CDeterministicMNCPtr& dmn) {
-        if (!best || CompareByLastPaid(dmn, best)) {
-            best = dmn;
-        }
+void CDeterministicMNList::RemoveFromPaymentOrder(const CDeterministicMNCPtr& dmn)
+{
+    if (!IsMNValid(dmn)) {
+        return;
+    }
+    auto it = std::lower_bound(mnPaymentOrder.begin(), mnPaymentOrder.end(), dmn, [](const CDeterministicMNCPtr& a, const CDeterministicMNCPtr& b) {
+        return CompareByLastPaid(a, b);
     });
+    if (it == mnPaymentOrder.end() || (*it)->proTxHash != dmn->proTxHash) {
+        throw(std::runtime_error(strprintf("%s: Can't find masternode %s in the payment order", __func__, dmn->proTxHash.ToString())));
+    }
+    mnPaymentOrder = mnPaymentOrder.erase(it - mnPaymentOrder.begin());
+}
 
-    return best;
+CDeterministicMNCPtr CDeterministicMNList::GetMNPayee() const
+{
+    if (mnPaymentOrder.empty()) {
+        return nullptr;
+    }
+    return mnPaymentOrder.front();
 }
 
 std::vector<CDeterministicMNCPtr> CDeterministicMNList::GetProjectedMNPayees(int nCount) const
@@ -239,15 +261,9 @@ std::vector<CDeterministicMNCPtr> CDeterministicMNList::GetProjectedMNPayees(int
 
     std::vector<CDeterministicMNCPtr> result;
     result.reserve(nCount);
-
-    ForEachMN(true, [&](const CDeterministicMNCPtr& dmn) {
-        result.emplace_back(dmn);
-    });
-    std::sort(result.begin(), result.end(), [&](const CDeterministicMNCPtr& a, const CDeterministicMNCPtr& b) {
-        return CompareByLastPaid(a, b);
-    });
-
-    result.resize(nCount);
+    for (auto it = mnPaymentOrder.begin(); result.size() < (size_t)nCount; ++it) {
+        result.emplace_back(*it);
+    }
 
     return result;
 }
@@ -256,47 +272,74 @@ std::vector<CDeterministicMNCPtr> CDeterministicMNList::CalculateQuorum(size_t m
 {
     auto scores = CalculateScores(modifier);
 
-    // sort is descending order
-    std::sort(scores.rbegin(), scores.rend(), [](const std::pair<arith_uint256, CDeterministicMNCPtr>& a, std::pair<arith_uint256, CDeterministicMNCPtr>& b) {
+    // descending order, only the top maxSize entries need to be sorted
+    size_t nResultSize = std::min(maxSize, scores.size());
+    std::partial_sort(scores.begin(), scores.begin() + nResultSize, scores.end(), [](const std::pair<arith_uint256, CDeterministicMNCPtr>& a, const std::pair<arith_uint256, CDeterministicMNCPtr>& b) {
         if (a.first == b.first) {
             // this should actually never happen, but we should stay compatible with how the non deterministic MNs did the sorting
-            return a.second->collateralOutpoint < b.second->collateralOutpoint;
+            return b.second->collateralOutpoint < a.second->collateralOutpoint;
         }
-        return a.first < b.first;
+        return b.first < a.first;
     });
 
     // take top maxSize entries and return it
     std::vector<CDeterministicMNCPtr> result;
-    result.resize(std::min(maxSize, scores.size()));
+    result.resize(nResultSize);
     for (size_t i = 0; i < result.size(); i++) {
         result[i] = std::move(scores[i].second);
     }
     return result;
 }
 
-std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> CDeterministicMNList::CalculateScores(const uint256& modifier) const
+std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> CDeterministicMNList::CalculateScores(const uint256& modifier, size_t nMaxWorkers) const
 {
     std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> scores;
-    scores.reserve(GetAllMNsCount());
+    scores.reserve(GetValidMNsCount());
     ForEachMN(true, [&](const CDeterministicMNCPtr& dmn) {
         if (dmn->pdmnState->confirmedHash.IsNull()) {
             // we only take confirmed MNs into account to avoid hash grinding on the ProRegTxHash to sneak MNs into a
             // future quorums
             return;
         }
-        // calculate sha256(sha256(proTxHash, confirmedHash), modifier) per MN
-        // Please note that this is not a double-sha256 but a single-sha256
-        // The first part is already precalculated (confirmedHashWithProRegTxHash)
-        // TODO When https://github.com/bitcoin/bitcoin/pull/13191 gets backported, implement something that is similar but for single-sha256
-        uint256 h;
-        CSHA256 sha256;
-        sha256.Write(dmn->pdmnState->confirmedHashWithProRegTxHash.begin(), dmn->pdmnState->confirmedHashWithProRegTxHash.size());
-        sha256.Write(modifier.begin(), modifier.size());
-        sha256.Finalize(h.begin());
-
-        scores.emplace_back(UintToArith256(h), dmn);
+        scores.emplace_back(arith_uint256(), dmn);
     });
 
+    auto calcScores = [&](size_t nBegin, size_t nEnd) {
+        for (size_t i = nBegin; i < nEnd; i++) {
+            const auto& dmn = scores[i].second;
+            // calculate sha256(sha256(proTxHash, confirmedHash), modifier) per MN
+            // Please note that this is not a double-sha256 but a single-sha256
+            // The first part is already precalculated (confirmedHashWithProRegTxHash)
+            // TODO When https://github.com/bitcoin/bitcoin/pull/13191 gets backported, implement something that is similar but for single-sha256
+            uint256 h;
+            CSHA256 sha256;
+            sha256.Write(dmn->pdmnState->confirmedHashWithProRegTxHash.begin(), dmn->pdmnState->confirmedHashWithProRegTxHash.size());
+            sha256.Write(modifier.begin(), modifier.size());
+            sha256.Finalize(h.begin());
+            scores[i].first = UintToArith256(h);
+        }
+    };
+
+    // split large lists over the available cores, each worker writes its own range of scores
+    if (nMaxWorkers == 0) {
+        nMaxWorkers = std::max(GetNumCores(), 1);
+    }
+    size_t nWorkers = std::min(nMaxWorkers, scores.size() / SCORES_PER_WORKER_MIN);
+    if (nWorkers <= 1) {
+        calcScores(0, scores.size());
+        return scores;
+    }
+
+    size_t nChunkSize = (scores.size() + nWorkers - 1) / nWorkers;
+    std::vector<std::future<void>> futures;
+    for (size_t nBegin = nChunkSize; nBegin < scores.size(); nBegin += nChunkSize) {
+        futures.emplace_back(std::async(std::launch::async, calcScores, nBegin, std::min(nBegin + nChunkSize, scores.size())));
+    }
+    calcScores(0, nChunkSize);
+    for (auto& f : futures) {
+        f.get();
+    }
+
     return scores;
 }
 
@@ -478,6 +521,7 @@ void CDeterministicMNList::AddMN(const CDeterministicMNCPtr& dmn, bool fBumpTota
 
     mnMap = mnMap.set(dmn->proTxHash, dmn);
     mnInternalIdMap = mnInternalIdMap.set(dmn->GetInternalId(), dmn->proTxHash);
+    AddToPaymentOrder(dmn);
     if (fBumpTotalCount) {
         // nTotalRegisteredCount acts more like a checkpoint, not as a limit,
         nTotalRegisteredCount = std::max(dmn->GetInternalId() + 1, (uint64_t)nTotalRegisteredCount);
@@ -512,7 +556,9 @@ void CDeterministicMNList::UpdateMN(const CDeterministicMNCPtr& oldDmn, const CD
                 oldDmn->proTxHash.ToString(), pdmnState->pubKeyOperator.Get().ToString())));
     }
 
+    RemoveFromPaymentOrder(oldDmn);
     mnMap = mnMap.set(oldDmn->proTxHash, dmn);
+    AddToPaymentOrder(dmn);
 }
 
 void CDeterministicMNList::UpdateMN(const uint256& proTxHash, const CDeterministicMNStateCPtr& pdmnState)
@@ -567,10 +613,12 @@ void CDeterministicMNList::RemoveMN(const uint256& proTxHash)
 
     mnMap = mnMap.erase(proTxHash);
     mnInternalIdMap = mnInternalIdMap.erase(dmn->GetInternalId());
+    RemoveFromPaymentOrder(dmn);
 }
 
-CDeterministicMNManager::CDeterministicMNManager(CEvoDB& _evoDb) :
-    evoDb(_evoDb)
+CDeterministicMNManager::CDeterministicMNManager(CEvoDB& _evoDb, int _nSnapshotPeriod) :
+    evoDb(_evoDb),
+    nSnapshotPeriod(std::max(_nSnapshotPeriod, MIN_DMN_SNAPSHOT_PERIOD))
 {
 }
 
@@ -608,17 +656,7 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
         newList.SetBlockHash(block.GetHash());
 
         oldList = GetListForBlock(pindex->pprev);
-        diff = oldList.BuildDiff(newList);
-
-        evoDb.Write(std::make_pair(DB_LIST_DIFF, newList.GetBlockHash()), diff);
-        if ((nHeight % DISK_SNAPSHOT_PERIOD) == 0 || oldList.GetHeight() == -1) {
-            evoDb.Write(std::make_pair(DB_LIST_SNAPSHOT, newList.GetBlockHash()), newList);
-            mnListsCache.emplace(newList.GetBlockHash(), newList);
-            LogPrintf("CDeterministicMNManager::%s -- Wrote snapshot. nHeight=%d, mapCurMNs.allMNsCount=%d\n",
-                __func__, nHeight, newList.GetAllMNsCount());
-        }
-
-        diff.nHeight = pindex->nHeight;
+        diff = WriteListForBlock(pindex, oldList, newList);
         mnListDiffsCache.emplace(pindex->GetBlockHash(), diff);
     } catch (const std::exception& e) {
         LogPrintf("CDeterministicMNManager::%s -- internal error: %s\n", __func__, e.what());
@@ -666,7 +704,9 @@ bool CDeterministicMNManager::UndoBlock(const CBlock& block, const CBlockIndex*
 
         mnListsCache.erase(blockHash);
         mnListDiffsCache.erase(blockHash);
+        mnListsLRU.erase(blockHash);
     }
+    mnListDiffCache.BlockDisconnected();
 
     if (diff.HasChanges()) {
         auto inversedDiff = curList.BuildDiff(prevList);
@@ -971,6 +1011,9 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
             snapshot = itLists->second;
             break;
         }
+        if (mnListsLRU.get(pindex->GetBlockHash(), snapshot)) {
+            break;
+        }
 
         if (evoDb.Read(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), snapshot)) {
             mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
@@ -1009,24 +1052,96 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
         }
     }
 
+    bool fKeep = false;
     if (tipIndex) {
         // always keep a snapshot for the tip
         if (snapshot.GetBlockHash() == tipIndex->GetBlockHash()) {
-            mnListsCache.emplace(snapshot.GetBlockHash(), snapshot);
+            fKeep = true;
         } else {
             // keep snapshots for yet alive quorums
             for (auto& p_llmq : Params().GetConsensus().llmqs) {
                 if ((snapshot.GetHeight() % p_llmq.second.dkgInterval == 0) && (snapshot.GetHeight() + p_llmq.second.dkgInterval * (p_llmq.second.keepOldConnections + 1) >= tipIndex->nHeight)) {
-                    mnListsCache.emplace(snapshot.GetBlockHash(), snapshot);
+                    fKeep = true;
                     break;
                 }
             }
         }
     }
+    if (fKeep) {
+        mnListsCache.emplace(snapshot.GetBlockHash(), snapshot);
+    } else if (!listDiffIndexes.empty()) {
+        // the list had to be rebuilt from diffs, keep it around for lookups of the same or following blocks
+        mnListsLRU.insert(snapshot.GetBlockHash(), snapshot);
+    }
 
     return snapshot;
 }
 
+void CDeterministicMNManager::ForEachListInRange(const CBlockIndex* pindexStart, const CBlockIndex* pindexEnd, const std::function<bool(const CDeterministicMNList&)>& cb)
+{
+    assert(pindexEnd->GetAncestor(pindexStart->nHeight) == pindexStart);
+
+    std::vector<const CBlockIndex*> vIndexes;
+    for (const CBlockIndex* pindex = pindexEnd; pindex != pindexStart; pindex = pindex->pprev) {
+        vIndexes.emplace_back(pindex);
+    }
+
+    CDeterministicMNList mnList = GetListForBlock(pindexStart);
+    if (!cb(mnList)) {
+        return;
+    }
+
+    for (auto it = vIndexes.rbegin(); it != vIndexes.rend(); ++it) {
+        const CBlockIndex* pindex = *it;
+
+        // the diffs are only needed once, so the cache is used but not filled
+        CDeterministicMNListDiff diff;
+        bool fHaveDiff;
+        {
+            LOCK(cs);
+            auto itDiffs = mnListDiffsCache.find(pindex->GetBlockHash());
+            if (itDiffs != mnListDiffsCache.end()) {
+                diff = itDiffs->second;
+                fHaveDiff = true;
+            } else {
+                fHaveDiff = evoDb.Read(std::make_pair(DB_LIST_DIFF, pindex->GetBlockHash()), diff);
+            }
+        }
+
+        if (!fHaveDiff) {
+            // same as in GetListForBlock, no diff on disk means that it's the initial snapshot
+            mnList = CDeterministicMNList(pindex->GetBlockHash(), -1, 0);
+        } else if (diff.HasChanges()) {
+            mnList = mnList.ApplyDiff(pindex, diff);
+        } else {
+            mnList.SetBlockHash(pindex->GetBlockHash());
+            mnList.SetHeight(pindex->nHeight);
+        }
+
+        if (!cb(mnList)) {
+            return;
+        }
+    }
+}
+
+CDeterministicMNListDiff CDeterministicMNManager::WriteListForBlock(const CBlockIndex* pindex, const CDeterministicMNList& oldList, const CDeterministicMNList& newList)
+{
+    LOCK(cs);
+
+    CDeterministicMNListDiff diff = oldList.BuildDiff(newList);
+
+    evoDb.Write(std::make_pair(DB_LIST_DIFF, newList.GetBlockHash()), diff);
+    if ((pindex->nHeight % nSnapshotPeriod) == 0 || oldList.GetHeight() == -1) {
+        evoDb.Write(std::make_pair(DB_LIST_SNAPSHOT, newList.GetBlockHash()), newList);
+        mnListsCache.emplace(newList.GetBlockHash(), newList);
+        LogPrintf("CDeterministicMNManager::%s -- Wrote snapshot. nHeight=%d, mapCurMNs.allMNsCount=%d\n",
+            __func__, pindex->nHeight, newList.GetAllMNsCount());
+    }
+
+    diff.nHeight = pindex->nHeight;
+    return diff;
+}
+
 CDeterministicMNList CDeterministicMNManager::GetListAtChainTip()
 {
     LOCK(cs);
@@ -1209,7 +1324,7 @@ bool CDeterministicMNManager::UpgradeDBIfNeeded()
         CDeterministicMNList newMNList;
         UpgradeDiff(batch, pindex, curMNList, newMNList);
 
-        if ((nHeight % DISK_SNAPSHOT_PERIOD) == 0) {
+        if ((nHeight % nSnapshotPeriod) == 0) {
             batch.Write(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), newMNList);
             evoDb.GetRawDB().WriteBatch(batch);
             batch.Clear();
@@ -13,10 +13,13 @@
 #include <evo/simplifiedmns.h>
 #include <saltedhasher.h>
 #include <sync.h>
+#include <unordered_lru_cache.h>
 
+#include <immer/flex_vector.hpp>
 #include <immer/map.hpp>
 #include <immer/map_transient.hpp>
 
+#include <functional>
 #include <unordered_map>
 
 class CBlock;
@@ -309,6 +312,7 @@ public:
     typedef immer::map<uint256, CDeterministicMNCPtr> MnMap;
     typedef immer::map<uint64_t, uint256> MnInternalIdMap;
     typedef immer::map<uint256, std::pair<uint256, uint32_t> > MnUniquePropertyMap;
+    typedef immer::flex_vector<CDeterministicMNCPtr> MnPaymentOrder;
 
 private:
     uint256 blockHash;
@@ -321,6 +325,10 @@ private:
     // we keep track of this as checking for duplicates would otherwise be painfully slow
     MnUniquePropertyMap mnUniquePropertyMap;
 
+    // valid MNs in the order they get paid (see CompareByLastPaid), the front is the next payee
+    // kept up to date on every change so finding the payee doesn't need to sort the whole list
+    MnPaymentOrder mnPaymentOrder;
+
 public:
     CDeterministicMNList() = default;
     explicit CDeterministicMNList(const uint256& _blockHash, int _height, uint32_t _totalRegisteredCount) :
@@ -354,6 +362,7 @@ public:
         mnMap = MnMap();
         mnUniquePropertyMap = MnUniquePropertyMap();
         mnInternalIdMap = MnInternalIdMap();
+        mnPaymentOrder = MnPaymentOrder();
 
         SerializationOpBase(s, CSerActionUnserialize());
 
@@ -371,13 +380,7 @@ public:
 
     size_t GetValidMNsCount() const
     {
-        size_t count = 0;
-        for (const auto& p : mnMap) {
-            if (IsMNValid(p.second)) {
-                count++;
-            }
-        }
-        return count;
+        return mnPaymentOrder.size();
     }
 
     template <typename Callback>
@@ -453,7 +456,15 @@ public:
      * @return
      */
     std::vector<CDeterministicMNCPtr> CalculateQuorum(size_t maxSize, const uint256& modifier) const;
-    std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> CalculateScores(const uint256& modifier) const;
+
+    /**
+     * Calculates the scores of all confirmed valid MNs for the modifier, in the order of ForEachMN. Large lists are
+     * hashed by up to nMaxWorkers threads, 0 uses one per core
+     * @param modifier
+     * @param nMaxWorkers
+     * @return
+     */
+    std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> CalculateScores(const uint256& modifier, size_t nMaxWorkers = 0) const;
 
     /**
      * Calculates the maximum penalty which is allowed at the height of this MN list. It is dynamic and might change
@@ -514,6 +525,9 @@ public:
     }
 
 private:
+    void AddToPaymentOrder(const CDeterministicMNCPtr& dmn);
+    void RemoveFromPaymentOrder(const CDeterministicMNCPtr& dmn);
+
     template <typename T>
     NODISCARD bool AddUniqueProperty(const CDeterministicMNCPtr& dmn, const T& v)
     {
@@ -663,24 +677,33 @@ public:
     }
 };
 
+/** Default for -dmnsnapshotperiod, write a full list snapshot once per day */
+static const int DEFAULT_DMN_SNAPSHOT_PERIOD = 576;
+static const int MIN_DMN_SNAPSHOT_PERIOD = 16;
+/** Number of recently used historic lists kept in memory */
+static const size_t DMN_LISTS_LRU_SIZE = 128;
+
 class CDeterministicMNManager
 {
-    static const int DISK_SNAPSHOT_PERIOD = 576; // once per day
     static const int DISK_SNAPSHOTS = 3; // keep cache for 3 disk snapshots to have 2 full days covered
-    static const int LIST_DIFFS_CACHE_SIZE = DISK_SNAPSHOT_PERIOD * DISK_SNAPSHOTS;
+    static const int LIST_DIFFS_CACHE_SIZE = DEFAULT_DMN_SNAPSHOT_PERIOD * DISK_SNAPSHOTS;
 
 public:
     CCriticalSection cs;
 
 private:
     CEvoDB& evoDb;
+    // blocks between two snapshots written to disk, lists in between are rebuilt by replaying diffs
+    const int nSnapshotPeriod;
 
     std::unordered_map<uint256, CDeterministicMNList, StaticSaltedHasher> mnListsCache;
     std::unordered_map<uint256, CDeterministicMNListDiff, StaticSaltedHasher> mnListDiffsCache;
+    // historic lists which are not kept in mnListsCache, lookups of nearby blocks start from these
+    unordered_lru_cache<uint256, CDeterministicMNList, StaticSaltedHasher, DMN_LISTS_LRU_SIZE> mnListsLRU;
     const CBlockIndex* tipIndex{nullptr};
 
 public:
-    explicit CDeterministicMNManager(CEvoDB& _evoDb);
+    explicit CDeterministicMNManager(CEvoDB& _evoDb, int _nSnapshotPeriod = DEFAULT_DMN_SNAPSHOT_PERIOD);
 
     bool ProcessBlock(const CBlock& block, const CBlockIndex* pindex, CValidationState& state, const CCoinsViewCache& view, bool fJustCheck);
     bool UndoBlock(const CBlock& block, const CBlockIndex* pindex);
@@ -695,6 +718,20 @@ public:
     CDeterministicMNList GetListForBlock(const CBlockIndex* pindex);
     CDeterministicMNList GetListAtChainTip();
 
+    /**
+     * Calls cb with the list of pindexStart and then with the lists of its descendants up to and including pindexEnd.
+     * Only the list of pindexStart is looked up, the following ones are built by replaying the diffs in order, which
+     * is much cheaper than a GetListForBlock call per block. Stops when cb returns false.
+     * @param pindexStart must be an ancestor of pindexEnd or pindexEnd itself
+     */
+    void ForEachListInRange(const CBlockIndex* pindexStart, const CBlockIndex* pindexEnd, const std::function<bool(const CDeterministicMNList&)>& cb);
+
+    /**
+     * Writes the diff from oldList to the list of pindex, and a snapshot if one is due at this height
+     * @return the written diff
+     */
+    CDeterministicMNListDiff WriteListForBlock(const CBlockIndex* pindex, const CDeterministicMNList& oldList, const CDeterministicMNList& newList);
+
     // Test if given TX is a ProRegTx which also contains the collateral at index n
     static bool IsProTxWithCollateral(const CTransactionRef& tx, uint32_t n);
 
@@ -13,6 +13,8 @@
 #include <base58.h>
 #include <chainparams.h>
 #include <consensus/merkle.h>
+#include <hash.h>
+#include <statsd_client.h>
 #include <univalue.h>
 #include <validation.h>
 
@@ -87,6 +89,130 @@ uint256 CSimplifiedMNList::CalcMerkleRoot(bool* pmutated) const
     return ComputeMerkleRoot(leaves, pmutated);
 }
 
+CSimplifiedMNListMerkleTree::CSimplifiedMNListMerkleTree(const CSimplifiedMNList& sml)
+{
+    vProRegTxHashes.reserve(sml.mnList.size());
+    vLevels[0].reserve(sml.mnList.size());
+    for (const auto& e : sml.mnList) {
+        vProRegTxHashes.emplace_back(e->proRegTxHash);
+        vLevels[0].emplace_back(e->CalcHash());
+    }
+    nFirstMovedLeaf = 0;
+}
+
+void CSimplifiedMNListMerkleTree::AddOrUpdate(const CSimplifiedMNListEntry& entry)
+{
+    auto it = std::lower_bound(vProRegTxHashes.begin(), vProRegTxHashes.end(), entry.proRegTxHash);
+    size_t pos = it - vProRegTxHashes.begin();
+    uint256 hash = entry.CalcHash();
+
+    if (it != vProRegTxHashes.end() && *it == entry.proRegTxHash) {
+        if (vLevels[0][pos] != hash) {
+            vLevels[0][pos] = hash;
+            setChangedLeaves.emplace(pos);
+        }
+        return;
+    }
+
+    vProRegTxHashes.insert(it, entry.proRegTxHash);
+    vLevels[0].insert(vLevels[0].begin() + pos, hash);
+    nFirstMovedLeaf = std::min(nFirstMovedLeaf, pos);
+}
+
+void CSimplifiedMNListMerkleTree::Remove(const uint256& proRegTxHash)
+{
+    auto it = std::lower_bound(vProRegTxHashes.begin(), vProRegTxHashes.end(), proRegTxHash);
+    if (it == vProRegTxHashes.end() || *it != proRegTxHash) {
+        return;
+    }
+    size_t pos = it - vProRegTxHashes.begin();
+
+    vProRegTxHashes.erase(it);
+    vLevels[0].erase(vLevels[0].begin() + pos);
+    nFirstMovedLeaf = std::min(nFirstMovedLeaf, pos);
+}
+
+void CSimplifiedMNListMerkleTree::ApplyDiff(const CDeterministicMNList& fromList, const CDeterministicMNList& toList, const CDeterministicMNListDiff& diff)
+{
+    for (const auto& id : diff.removedMns) {
+        auto dmn = fromList.GetMNByInternalId(id);
+        if (!dmn) {
+            throw std::runtime_error(strprintf("%s: can't find a removed masternode with internalId=%d", __func__, id));
+        }
+        Remove(dmn->proTxHash);
+    }
+    for (const auto& dmn : diff.addedMNs) {
+        AddOrUpdate(CSimplifiedMNListEntry(*dmn));
+    }
+    for (const auto& p : diff.updatedMNs) {
+        auto dmn = toList.GetMNByInternalId(p.first);
+        if (!dmn) {
+            throw std::runtime_error(strprintf("%s: can't find an updated masternode with internalId=%d", __func__, p.first));
+        }
+        AddOrUpdate(CSimplifiedMNListEntry(*dmn));
+    }
+}
+
+uint256 CSimplifiedMNListMerkleTree::CalcMerkleRoot(bool* pmutated)
+{
+    // Same tree as ComputeMerkleRoot: the last node of a level with an odd size is paired with itself
+    size_t nFirstMoved = nFirstMovedLeaf;
+    std::set<size_t> setChanged = std::move(setChangedLeaves);
+    size_t nLevel = 0;
+    for (; vLevels[nLevel].size() > 1; nLevel++) {
+        if (vLevels.size() == nLevel + 1) {
+            vLevels.emplace_back();
+        }
+        const auto& level = vLevels[nLevel];
+        auto& parents = vLevels[nLevel + 1];
+        size_t nParents = (level.size() + 1) / 2;
+        parents.resize(nParents);
+
+        auto hashParent = [&](size_t pos) {
+            const uint256& left = level[pos * 2];
+            const uint256& right = pos * 2 + 1 < level.size() ? level[pos * 2 + 1] : left;
+            parents[pos] = Hash(left.begin(), left.end(), right.begin(), right.end());
+        };
+
+        std::set<size_t> setChangedParents;
+        for (size_t pos : setChanged) {
+            if (pos < nFirstMoved) {
+                setChangedParents.emplace(pos / 2);
+            }
+        }
+        nFirstMoved /= 2;
+        for (size_t pos : setChangedParents) {
+            if (pos < nFirstMoved) {
+                hashParent(pos);
+            }
+        }
+        for (size_t pos = nFirstMoved; pos < nParents; pos++) {
+            hashParent(pos);
+        }
+        setChanged = std::move(setChangedParents);
+    }
+    vLevels.resize(nLevel + 1);
+
+    setChangedLeaves.clear();
+    nFirstMovedLeaf = std::numeric_limits<size_t>::max();
+
+    if (pmutated) {
+        *pmutated = false;
+        for (const auto& level : vLevels) {
+            for (size_t pos = 0; pos + 1 < level.size(); pos += 2) {
+                if (level[pos] == level[pos + 1]) {
+                    *pmutated = true;
+                }
+            }
+        }
+    }
+
+    if (vLevels.back().empty()) {
+        return uint256();
+    }
+    return vLevels.back()[0];
+}
+
 CSimplifiedMNListDiff::CSimplifiedMNListDiff() = default;
 
 CSimplifiedMNListDiff::~CSimplifiedMNListDiff() = default;
@@ -244,3 +370,47 @@ bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& bloc
 
     return true;
 }
+
+CSimplifiedMNListDiffCache mnListDiffCache;
+
+bool CSimplifiedMNListDiffCache::GetPayload(const uint256& baseBlockHash, const uint256& blockHash, int nVersion, std::vector<unsigned char>& payloadRet, std::string& errorRet)
+{
+    uint256 key = SerializeHash(std::make_tuple(baseBlockHash, blockHash, nVersion));
+    {
+        LOCK(cs);
+        if (payloadCache.get(key, payloadRet)) {
+            nHits++;
+            statsClient.inc("mnlistdiff.cache.hit", 1.0f);
+            return true;
+        }
+    }
+    nMisses++;
+    statsClient.inc("mnlistdiff.cache.miss", 1.0f);
+
+    // keep cs_main until the entry is added, so a disconnected block can't leave a stale entry behind
+    LOCK(cs_main);
+
+    CSimplifiedMNListDiff mnListDiff;
+    if (!BuildSimplifiedMNListDiff(baseBlockHash, blockHash, mnListDiff, errorRet)) {
+        return false;
+    }
+
+    payloadRet.clear();
+    CVectorWriter{SER_NETWORK, nVersion, payloadRet, 0, mnListDiff};
+
+    LOCK(cs);
+    payloadCache.insert(key, payloadRet);
+    return true;
+}
+
+void CSimplifiedMNListDiffCache::BlockDisconnected()
+{
+    LOCK(cs);
+    payloadCache.clear();
+}
+
+size_t CSimplifiedMNListDiffCache::Size()
+{
+    LOCK(cs);
+    return payloadCache.size();
+}
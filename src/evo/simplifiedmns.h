@@ -9,11 +9,20 @@
 #include <merkleblock.h>
 #include <netaddress.h>
 #include <pubkey.h>
+#include <saltedhasher.h>
 #include <serialize.h>
+#include <sync.h>
+#include <unordered_lru_cache.h>
 #include <version.h>
 
+#include <atomic>
+#include <limits>
+#include <set>
+
 class UniValue;
+class CBlockIndex;
 class CDeterministicMNList;
+class CDeterministicMNListDiff;
 class CDeterministicMN;
 
 namespace llmq
@@ -84,6 +93,39 @@ public:
     uint256 CalcMerkleRoot(bool* pmutated = nullptr) const;
 };
 
+/**
+ * Merkle tree of a simplified MN list which is updated in place as masternodes are added, updated
+ * and removed. Only the leaves of changed entries are rehashed, inner nodes are rehashed on the paths
+ * of updated entries and to the right of the first added or removed entry. The root equals the one
+ * of CSimplifiedMNList::CalcMerkleRoot for the same entries.
+ */
+class CSimplifiedMNListMerkleTree
+{
+private:
+    // sorted like the entries of CSimplifiedMNList
+    std::vector<uint256> vProRegTxHashes;
+    // vLevels[0] holds the leaf hashes, vLevels.back() the root
+    std::vector<std::vector<uint256>> vLevels = std::vector<std::vector<uint256>>(1);
+
+    // leaves changed since the last CalcMerkleRoot, and the first leaf moved by an insertion or removal
+    std::set<size_t> setChangedLeaves;
+    size_t nFirstMovedLeaf{std::numeric_limits<size_t>::max()};
+
+public:
+    CSimplifiedMNListMerkleTree() = default;
+    explicit CSimplifiedMNListMerkleTree(const CSimplifiedMNList& sml);
+
+    size_t size() const { return vProRegTxHashes.size(); }
+
+    void AddOrUpdate(const CSimplifiedMNListEntry& entry);
+    void Remove(const uint256& proRegTxHash);
+    /// Apply the changes between two deterministic MN lists, diff must be fromList.BuildDiff(toList)
+    void ApplyDiff(const CDeterministicMNList& fromList, const CDeterministicMNList& toList, const CDeterministicMNListDiff& diff);
+
+    /// Rehash the nodes touched since the last call and return the root
+    uint256 CalcMerkleRoot(bool* pmutated = nullptr);
+};
+
 /// P2P messages
 
 class CGetSimplifiedMNListDiff
@@ -147,4 +189,32 @@ public:
 
 bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& blockHash, CSimplifiedMNListDiff& mnListDiffRet, std::string& errorRet);
 
+/**
+ * Cache of serialized MNLISTDIFF payloads by the requested (baseBlockHash, blockHash) pair and protocol version.
+ * Both blocks are in the active chain when an entry is added and the diff between two blocks never changes,
+ * so entries only get invalid when a block is disconnected. Hits are served without cs_main.
+ */
+class CSimplifiedMNListDiffCache
+{
+private:
+    static const size_t MAX_CACHE_SIZE = 128;
+
+    CCriticalSection cs;
+    unordered_lru_cache<uint256, std::vector<unsigned char>, StaticSaltedHasher, MAX_CACHE_SIZE> payloadCache;
+
+    std::atomic<uint64_t> nHits{0};
+    std::atomic<uint64_t> nMisses{0};
+
+public:
+    /// Get the serialized diff from the cache or build it with BuildSimplifiedMNListDiff
+    bool GetPayload(const uint256& baseBlockHash, const uint256& blockHash, int nVersion, std::vector<unsigned char>& payloadRet, std::string& errorRet);
+    void BlockDisconnected();
+
+    size_t Size();
+    uint64_t GetHits() const { return nHits; }
+    uint64_t GetMisses() const { return nMisses; }
+};
+
+extern CSimplifiedMNListDiffCache mnListDiffCache;
+
 #endif // BITCOIN_EVO_SIMPLIFIEDMNS_H
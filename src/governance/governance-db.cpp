@@ -0,0 +1,247 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <governance/governance-db.h>
+#include <util.h>
+
+std::unique_ptr<CGovernanceDb> governanceDb;
+
+/**
+ * Serializes the fields of an object without the vote records and votes, which the governance
+ * database keeps under their own keys
+ */
+class CGovernanceObjectRecord
+{
+private:
+    CGovernanceObject& govobj;
+
+public:
+    explicit CGovernanceObjectRecord(CGovernanceObject& govobjIn) : govobj(govobjIn) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        govobj.SerializationOp(s, ser_action, false);
+    }
+};
+
+/** Erase all keys with the prefix and object hash of start */
+template <typename K>
+static void EraseObjectKeys(CDBWrapper& db, CDBBatch& batch, const K& start)
+{
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(start);
+
+    while (pcursor->Valid()) {
+        K k;
+        if (!pcursor->GetKey(k) || std::get<0>(k) != std::get<0>(start) || std::get<1>(k) != std::get<1>(start)) {
+            break;
+        }
+        batch.Erase(k);
+        pcursor->Next();
+    }
+}
+
+CGovernanceDb::CGovernanceDb(size_t nCacheSize, bool fMemory, bool fWipe) :
+    db(fMemory ? "" : (GetDataDir() / "governance"), nCacheSize, fMemory, fWipe)
+{
+}
+
+bool CGovernanceDb::WriteObject(CGovernanceObject& govobj)
+{
+    CGovernanceObjectRecord record(govobj);
+    if (!db.Write(std::make_tuple(std::string("gov_o"), govobj.GetHash()), record)) {
+        return false;
+    }
+    govobj.fDirtyRecord = false;
+    return true;
+}
+
+bool CGovernanceDb::WriteObjects(std::map<uint256, CGovernanceObject>& mapObjects)
+{
+    std::vector<CGovernanceObject*> vecWritten;
+    CDBBatch batch(db);
+    for (auto& objPair : mapObjects) {
+        if (!objPair.second.fDirtyRecord) {
+            continue;
+        }
+        CGovernanceObjectRecord record(objPair.second);
+        batch.Write(std::make_tuple(std::string("gov_o"), objPair.first), record);
+        vecWritten.emplace_back(&objPair.second);
+
+        if (batch.SizeEstimate() >= (1 << 24)) {
+            if (!db.WriteBatch(batch)) {
+                return false;
+            }
+            batch.Clear();
+        }
+    }
+    if (!db.WriteBatch(batch)) {
+        return false;
+    }
+    // objects of a failed batch stay dirty and are written again on the next flush
+    for (auto pObj : vecWritten) {
+        pObj->fDirtyRecord = false;
+    }
+    return true;
+}
+
+bool CGovernanceDb::WriteObjectVotes(const CGovernanceObject& govobj)
+{
+    LOCK(govobj.cs);
+
+    uint256 nParentHash = govobj.GetHash();
+    CDBBatch batch(db);
+    for (const auto& recPair : govobj.mapCurrentMNVotes) {
+        batch.Write(std::make_tuple(std::string("gov_r"), nParentHash, recPair.first), recPair.second);
+    }
+    for (const auto& vote : govobj.fileVotes.GetVotes()) {
+        batch.Write(std::make_tuple(std::string("gov_v"), nParentHash, vote.GetHash()), vote);
+
+        if (batch.SizeEstimate() >= (1 << 24)) {
+            if (!db.WriteBatch(batch)) {
+                return false;
+            }
+            batch.Clear();
+        }
+    }
+    return db.WriteBatch(batch);
+}
+
+bool CGovernanceDb::EraseObject(const uint256& nHash)
+{
+    CDBBatch batch(db);
+    batch.Erase(std::make_tuple(std::string("gov_o"), nHash));
+    EraseObjectKeys(db, batch, std::make_tuple(std::string("gov_r"), nHash, COutPoint(uint256(), 0)));
+    EraseObjectKeys(db, batch, std::make_tuple(std::string("gov_v"), nHash, uint256()));
+    return db.WriteBatch(batch);
+}
+
+bool CGovernanceDb::ReadObjects(std::map<uint256, CGovernanceObject>& mapObjects)
+{
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+
+    auto start = std::make_tuple(std::string("gov_o"), uint256());
+    pcursor->Seek(start);
+
+    while (pcursor->Valid()) {
+        decltype(start) k;
+        if (!pcursor->GetKey(k) || std::get<0>(k) != "gov_o") {
+            break;
+        }
+
+        CGovernanceObject& govobj = mapObjects[std::get<1>(k)];
+        CGovernanceObjectRecord record(govobj);
+        if (!pcursor->GetValue(record)) {
+            return error("%s: failed to read governance object %s", __func__, std::get<1>(k).ToString());
+        }
+        govobj.fVotesLoaded = false;
+        govobj.fDirtyRecord = false;
+
+        pcursor->Next();
+    }
+
+    auto startRec = std::make_tuple(std::string("gov_r"), uint256(), COutPoint(uint256(), 0));
+    pcursor->Seek(startRec);
+
+    while (pcursor->Valid()) {
+        decltype(startRec) k;
+        if (!pcursor->GetKey(k) || std::get<0>(k) != "gov_r") {
+            break;
+        }
+
+        auto it = mapObjects.find(std::get<1>(k));
+        if (it != mapObjects.end()) {
+            vote_rec_t& voteRecord = it->second.mapCurrentMNVotes[std::get<2>(k)];
+            if (!pcursor->GetValue(voteRecord)) {
+                return error("%s: failed to read vote record of %s for governance object %s", __func__,
+                    std::get<2>(k).ToStringShort(), std::get<1>(k).ToString());
+            }
+        }
+
+        pcursor->Next();
+    }
+
+    return true;
+}
+
+void CGovernanceDb::ReadVoteHashes(const uint256& nParentHash, std::vector<uint256>& vecHashes)
+{
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+
+    auto start = std::make_tuple(std::string("gov_v"), nParentHash, uint256());
+    pcursor->Seek(start);
+
+    while (pcursor->Valid()) {
+        decltype(start) k;
+        if (!pcursor->GetKey(k) || std::get<0>(k) != "gov_v" || std::get<1>(k) != nParentHash) {
+            break;
+        }
+        vecHashes.emplace_back(std::get<2>(k));
+        pcursor->Next();
+    }
+}
+
+void CGovernanceDb::ReadVotes(const uint256& nParentHash, std::vector<CGovernanceVote>& vecVotes)
+{
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+
+    auto start = std::make_tuple(std::string("gov_v"), nParentHash, uint256());
+    pcursor->Seek(start);
+
+    while (pcursor->Valid()) {
+        decltype(start) k;
+        if (!pcursor->GetKey(k) || std::get<0>(k) != "gov_v" || std::get<1>(k) != nParentHash) {
+            break;
+        }
+        CGovernanceVote vote;
+        if (pcursor->GetValue(vote)) {
+            vecVotes.emplace_back(vote);
+        } else {
+            LogPrintf("CGovernanceDb::%s -- failed to read vote %s for governance object %s\n", __func__,
+                std::get<2>(k).ToString(), nParentHash.ToString());
+        }
+        pcursor->Next();
+    }
+}
+
+bool CGovernanceDb::ReadVote(const uint256& nParentHash, const uint256& nHash, CGovernanceVote& vote)
+{
+    return db.Read(std::make_tuple(std::string("gov_v"), nParentHash, nHash), vote);
+}
+
+bool CGovernanceDb::HasVote(const uint256& nParentHash, const uint256& nHash)
+{
+    return db.Exists(std::make_tuple(std::string("gov_v"), nParentHash, nHash));
+}
+
+bool CGovernanceDb::WriteVote(const CGovernanceVote& vote, const vote_rec_t& voteRecord, const std::set<uint256>& setReplaced)
+{
+    const uint256& nParentHash = vote.GetParentHash();
+
+    CDBBatch batch(db);
+    batch.Write(std::make_tuple(std::string("gov_v"), nParentHash, vote.GetHash()), vote);
+    batch.Write(std::make_tuple(std::string("gov_r"), nParentHash, vote.GetMasternodeOutpoint()), voteRecord);
+    for (const auto& nHash : setReplaced) {
+        batch.Erase(std::make_tuple(std::string("gov_v"), nParentHash, nHash));
+    }
+    return db.WriteBatch(batch);
+}
+
+bool CGovernanceDb::RemoveVotes(const uint256& nParentHash, const COutPoint& mnOutpoint, const vote_rec_t* pVoteRecord, const std::set<uint256>& setRemoved)
+{
+    CDBBatch batch(db);
+    auto recKey = std::make_tuple(std::string("gov_r"), nParentHash, mnOutpoint);
+    if (pVoteRecord) {
+        batch.Write(recKey, *pVoteRecord);
+    } else {
+        batch.Erase(recKey);
+    }
+    for (const auto& nHash : setRemoved) {
+        batch.Erase(std::make_tuple(std::string("gov_v"), nParentHash, nHash));
+    }
+    return db.WriteBatch(batch);
+}
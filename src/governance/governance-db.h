@@ -0,0 +1,76 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_GOVERNANCE_GOVERNANCE_DB_H
+#define BITCOIN_GOVERNANCE_GOVERNANCE_DB_H
+
+#include <dbwrapper.h>
+#include <governance/governance-object.h>
+#include <governance/governance-vote.h>
+#include <uint256.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * LevelDB store of the governance objects and their votes, replacing governance.dat
+ *
+ * Keys:
+ *   ("gov_o", objHash)                -> object without its votes
+ *   ("gov_r", objHash, mnOutpoint)    -> vote_rec_t of the masternode
+ *   ("gov_v", objHash, voteHash)      -> CGovernanceVote
+ *   ("gov_s")                         -> remaining state of the governance manager
+ *
+ * Votes and vote records are written as they are accepted. Changed object records and the
+ * manager state are flushed on maintenance and shutdown. On startup only the objects and the compact
+ * vote records are read, the signed votes of an object are read on first use.
+ */
+class CGovernanceDb
+{
+private:
+    CDBWrapper db;
+
+public:
+    CGovernanceDb(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    bool IsEmpty() { return db.IsEmpty(); }
+
+    bool WriteObject(CGovernanceObject& govobj);
+    /// Write the records of the objects which changed since they were last written
+    bool WriteObjects(std::map<uint256, CGovernanceObject>& mapObjects);
+    /// Write the vote records and votes of an object which was loaded with its votes (governance.dat import)
+    bool WriteObjectVotes(const CGovernanceObject& govobj);
+    bool EraseObject(const uint256& nHash);
+    /// Read all objects with their vote records, the votes themselves are left on disk
+    bool ReadObjects(std::map<uint256, CGovernanceObject>& mapObjects);
+
+    void ReadVoteHashes(const uint256& nParentHash, std::vector<uint256>& vecHashes);
+    void ReadVotes(const uint256& nParentHash, std::vector<CGovernanceVote>& vecVotes);
+    bool ReadVote(const uint256& nParentHash, const uint256& nHash, CGovernanceVote& vote);
+    bool HasVote(const uint256& nParentHash, const uint256& nHash);
+
+    /// Store an accepted vote together with the updated record of its masternode and drop the votes it replaced
+    bool WriteVote(const CGovernanceVote& vote, const vote_rec_t& voteRecord, const std::set<uint256>& setReplaced);
+    /// Drop removed votes of a masternode, pVoteRecord is the remaining record or nullptr if none is left
+    bool RemoveVotes(const uint256& nParentHash, const COutPoint& mnOutpoint, const vote_rec_t* pVoteRecord, const std::set<uint256>& setRemoved);
+
+    template <typename T>
+    bool ReadState(T& state)
+    {
+        return db.Read(std::string("gov_s"), state);
+    }
+
+    template <typename T>
+    bool WriteState(const T& state)
+    {
+        return db.Write(std::string("gov_s"), state);
+    }
+};
+
+extern std::unique_ptr<CGovernanceDb> governanceDb;
+
+#endif // BITCOIN_GOVERNANCE_GOVERNANCE_DB_H
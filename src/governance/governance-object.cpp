@@ -4,6 +4,7 @@
 
 #include <governance/governance-object.h>
 #include <core_io.h>
+#include <governance/governance-db.h>
 #include <governance/governance-validators.h>
 #include <governance/governance.h>
 #include <masternode/masternode-meta.h>
@@ -36,7 +37,9 @@ CGovernanceObject::CGovernanceObject() :
     fExpired(false),
     fUnparsable(false),
     mapCurrentMNVotes(),
-    fileVotes()
+    fileVotes(),
+    fVotesLoaded(true),
+    fDirtyRecord(true)
 {
     // PARSE JSON DATA STORAGE (VCHDATA)
     LoadData();
@@ -63,7 +66,9 @@ CGovernanceObject::CGovernanceObject(const uint256& nHashParentIn, int nRevision
     fExpired(false),
     fUnparsable(false),
     mapCurrentMNVotes(),
-    fileVotes()
+    fileVotes(),
+    fVotesLoaded(true),
+    fDirtyRecord(true)
 {
     // PARSE JSON DATA STORAGE (VCHDATA)
     LoadData();
@@ -90,17 +95,22 @@ CGovernanceObject::CGovernanceObject(const CGovernanceObject& other) :
     fExpired(other.fExpired),
     fUnparsable(other.fUnparsable),
     mapCurrentMNVotes(other.mapCurrentMNVotes),
-    fileVotes(other.fileVotes)
+    fileVotes(other.fileVotes),
+    fVotesLoaded(other.fVotesLoaded),
+    fDirtyRecord(other.fDirtyRecord)
 {
 }
 
 bool CGovernanceObject::ProcessVote(CNode* pfrom,
     const CGovernanceVote& vote,
     CGovernanceException& exception,
-    CConnman& connman)
+    CConnman& connman,
+    bool fSigVerified)
 {
     LOCK(cs);
 
+    LoadVotes();
+
     // do not process already known valid votes twice
     if (fileVotes.HasVote(vote.GetHash())) {
         // nothing to do here, not an error
@@ -185,7 +195,7 @@ bool CGovernanceObject::ProcessVote(CNode* pfrom,
     bool onlyVotingKeyAllowed = nObjectType == GOVERNANCE_OBJECT_PROPOSAL && vote.GetSignal() == VOTE_SIGNAL_FUNDING;
 
     // Finally check that the vote is actually valid (done last because of cost of signature verification)
-    if (!vote.IsValid(onlyVotingKeyAllowed)) {
+    if (!vote.IsValid(onlyVotingKeyAllowed, !fSigVerified)) {
         std::ostringstream ostr;
         ostr << "CGovernanceObject::ProcessVote -- Invalid vote"
              << ", MN outpoint = " << vote.GetMasternodeOutpoint().ToStringShort()
@@ -208,7 +218,10 @@ bool CGovernanceObject::ProcessVote(CNode* pfrom,
     }
 
     voteInstanceRef = vote_instance_t(vote.GetOutcome(), nVoteTimeUpdate, vote.GetTimestamp());
-    fileVotes.AddVote(vote);
+    std::set<uint256> replacedVotes = fileVotes.AddVote(vote);
+    if (governanceDb && !governanceDb->WriteVote(vote, voteRecordRef, replacedVotes)) {
+        LogPrintf("CGovernanceObject::ProcessVote -- failed to write vote %s to the database\n", vote.GetHash().ToString());
+    }
     fDirtyCache = true;
     // SEND NOTIFICATION TO SCRIPT/ZMQ
     GetMainSignals().NotifyGovernanceVote(std::make_shared<const CGovernanceVote>(vote));
@@ -224,7 +237,11 @@ void CGovernanceObject::ClearMasternodeVotes()
     auto it = mapCurrentMNVotes.begin();
     while (it != mapCurrentMNVotes.end()) {
         if (!mnList.HasMNByCollateral(it->first)) {
-            fileVotes.RemoveVotesFromMasternode(it->first);
+            LoadVotes();
+            std::set<uint256> removedVotes = fileVotes.RemoveVotesFromMasternode(it->first);
+            if (governanceDb && !governanceDb->RemoveVotes(GetHash(), it->first, nullptr, removedVotes)) {
+                LogPrintf("CGovernanceObject::%s -- failed to remove votes of MN %s for %s from the database\n", __func__, it->first.ToStringShort(), GetHash().ToString());
+            }
             mapCurrentMNVotes.erase(it++);
             fDirtyCache = true;
         } else {
@@ -243,6 +260,7 @@ std::set<uint256> CGovernanceObject::RemoveInvalidVotes(const COutPoint& mnOutpo
         return {};
     }
 
+    LoadVotes();
     auto removedVotes = fileVotes.RemoveInvalidVotes(mnOutpoint, nObjectType == GOVERNANCE_OBJECT_PROPOSAL);
     if (removedVotes.empty()) {
         return {};
@@ -260,6 +278,10 @@ std::set<uint256> CGovernanceObject::RemoveInvalidVotes(const COutPoint& mnOutpo
     }
     if (it->second.mapInstances.empty()) {
         mapCurrentMNVotes.erase(it);
+        it = mapCurrentMNVotes.end();
+    }
+    if (governanceDb && !governanceDb->RemoveVotes(nParentHash, mnOutpoint, it != mapCurrentMNVotes.end() ? &it->second : nullptr, removedVotes)) {
+        LogPrintf("CGovernanceObject::%s -- failed to remove invalid votes of MN %s for %s from the database\n", __func__, mnOutpoint.ToStringShort(), nParentHash.ToString());
     }
 
     if (!removedVotes.empty()) {
@@ -274,6 +296,22 @@ std::set<uint256> CGovernanceObject::RemoveInvalidVotes(const COutPoint& mnOutpo
     return removedVotes;
 }
 
+void CGovernanceObject::LoadVotes()
+{
+    LOCK(cs);
+
+    if (fVotesLoaded) {
+        return;
+    }
+
+    std::vector<CGovernanceVote> vecVotes;
+    if (governanceDb) {
+        governanceDb->ReadVotes(GetHash(), vecVotes);
+    }
+    fileVotes.LoadVotes(vecVotes);
+    fVotesLoaded = true;
+}
+
 uint256 CGovernanceObject::GetHash() const
 {
     // Note: doesn't match serialization
@@ -701,6 +739,7 @@ void CGovernanceObject::UpdateSentinelVariables()
         fCachedDelete = true;
         if (nDeletionTime == 0) {
             nDeletionTime = GetAdjustedTime();
+            fDirtyRecord = true;
         }
     }
     if (GetAbsoluteYesCount(VOTE_SIGNAL_ENDORSED) >= nAbsVoteReq) fCachedEndorsed = true;
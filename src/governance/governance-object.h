@@ -18,6 +18,7 @@
 
 #include <univalue.h>
 
+class CGovernanceDb;
 class CGovernanceManager;
 class CGovernanceTriggerManager;
 class CGovernanceObject;
@@ -98,6 +99,8 @@ struct vote_rec_t {
 
 class CGovernanceObject
 {
+    friend class CGovernanceDb;
+
 public: // Types
     typedef std::map<COutPoint, vote_rec_t> vote_m_t;
 
@@ -163,6 +166,12 @@ private:
 
     CGovernanceObjectVoteFile fileVotes;
 
+    /// false while the votes of an object read from the governance database are only on disk
+    bool fVotesLoaded;
+
+    /// the record stored in the governance database is missing or outdated (see CGovernanceDb::WriteObjects)
+    bool fDirtyRecord;
+
 public:
     CGovernanceObject();
 
@@ -229,7 +238,10 @@ public:
 
     void SetExpired()
     {
-        fExpired = true;
+        if (!fExpired) {
+            fExpired = true;
+            fDirtyRecord = true;
+        }
     }
 
     const CGovernanceObjectVoteFile& GetVoteFile() const
@@ -237,6 +249,19 @@ public:
         return fileVotes;
     }
 
+    bool AreVotesLoaded() const
+    {
+        return fVotesLoaded;
+    }
+
+    bool IsSetDirtyRecord() const
+    {
+        return fDirtyRecord;
+    }
+
+    /// Read the votes of an object loaded from the governance database into its vote file
+    void LoadVotes();
+
     // Signature related functions
 
     void SetMasternodeOutpoint(const COutPoint& outpoint);
@@ -263,6 +288,7 @@ public:
         fCachedDelete = true;
         if (nDeletionTime == 0) {
             nDeletionTime = nDeletionTime_;
+            fDirtyRecord = true;
         }
     }
 
@@ -297,6 +323,13 @@ public:
 
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        SerializationOp(s, ser_action, true);
+    }
+
+    /// The governance database stores the vote records and votes under their own keys, fWithVotes=false leaves them out
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, bool fWithVotes)
     {
         // SERIALIZE DATA FOR SAVING/LOADING OR NETWORK FUNCTIONS
         READWRITE(nHashParent);
@@ -311,12 +344,14 @@ public:
         }
         if (s.GetType() & SER_DISK) {
             // Only include these for the disk file format
-            LogPrint(BCLog::GOBJECT, "CGovernanceObject::SerializationOp Reading/writing votes from/to disk\n");
             READWRITE(nDeletionTime);
             READWRITE(fExpired);
-            READWRITE(mapCurrentMNVotes);
-            READWRITE(fileVotes);
-            LogPrint(BCLog::GOBJECT, "CGovernanceObject::SerializationOp hash = %s, vote count = %d\n", GetHash().ToString(), fileVotes.GetVoteCount());
+            if (fWithVotes) {
+                LogPrint(BCLog::GOBJECT, "CGovernanceObject::SerializationOp Reading/writing votes from/to disk\n");
+                READWRITE(mapCurrentMNVotes);
+                READWRITE(fileVotes);
+                LogPrint(BCLog::GOBJECT, "CGovernanceObject::SerializationOp hash = %s, vote count = %d\n", GetHash().ToString(), fileVotes.GetVoteCount());
+            }
         }
 
         // AFTER DESERIALIZATION OCCURS, CACHED VARIABLES MUST BE CALCULATED MANUALLY
@@ -331,7 +366,8 @@ public:
     bool ProcessVote(CNode* pfrom,
         const CGovernanceVote& vote,
         CGovernanceException& exception,
-        CConnman& connman);
+        CConnman& connman,
+        bool fSigVerified = false);
 
     /// Called when MN's which have voted on this object have been removed
     void ClearMasternodeVotes();
@@ -216,7 +216,7 @@ bool CGovernanceVote::CheckSignature(const CBLSPublicKey& pubKey) const
     return true;
 }
 
-bool CGovernanceVote::IsValid(bool useVotingKey) const
+bool CGovernanceVote::IsValid(bool useVotingKey, bool fCheckSignature) const
 {
     if (nTime > GetAdjustedTime() + (60 * 60)) {
         LogPrint(BCLog::GOBJECT, "CGovernanceVote::IsValid -- vote is too far ahead of current time - %s - nTime %lli - Max Time %lli\n", GetHash().ToString(), nTime, GetAdjustedTime() + (60 * 60));
@@ -241,6 +241,10 @@ bool CGovernanceVote::IsValid(bool useVotingKey) const
         return false;
     }
 
+    if (!fCheckSignature) {
+        return true;
+    }
+
     if (useVotingKey) {
         return CheckSignature(dmn->pdmnState->keyIDVoting);
     } else {
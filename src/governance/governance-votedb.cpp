@@ -19,16 +19,22 @@ CGovernanceObjectVoteFile::CGovernanceObjectVoteFile(const CGovernanceObjectVote
     RebuildIndex();
 }
 
-void CGovernanceObjectVoteFile::AddVote(const CGovernanceVote& vote)
+std::set<uint256> CGovernanceObjectVoteFile::AddVote(const CGovernanceVote& vote)
 {
     uint256 nHash = vote.GetHash();
     // make sure to never add/update already known votes
     if (HasVote(nHash))
-        return;
+        return {};
     listVotes.push_front(vote);
     mapVoteIndex.emplace(nHash, listVotes.begin());
     ++nMemoryVotes;
-    RemoveOldVotes(vote);
+    return RemoveOldVotes(vote);
+}
+
+void CGovernanceObjectVoteFile::LoadVotes(const std::vector<CGovernanceVote>& vecVotes)
+{
+    listVotes = vote_l_t(vecVotes.begin(), vecVotes.end());
+    RebuildIndex();
 }
 
 bool CGovernanceObjectVoteFile::HasVote(const uint256& nHash) const
@@ -55,11 +61,14 @@ std::vector<CGovernanceVote> CGovernanceObjectVoteFile::GetVotes() const
     return vecResult;
 }
 
-void CGovernanceObjectVoteFile::RemoveVotesFromMasternode(const COutPoint& outpointMasternode)
+std::set<uint256> CGovernanceObjectVoteFile::RemoveVotesFromMasternode(const COutPoint& outpointMasternode)
 {
+    std::set<uint256> removedVotes;
+
     auto it = listVotes.begin();
     while (it != listVotes.end()) {
         if (it->GetMasternodeOutpoint() == outpointMasternode) {
+            removedVotes.emplace(it->GetHash());
             --nMemoryVotes;
             mapVoteIndex.erase(it->GetHash());
             listVotes.erase(it++);
@@ -67,6 +76,8 @@ void CGovernanceObjectVoteFile::RemoveVotesFromMasternode(const COutPoint& outpo
             ++it;
         }
     }
+
+    return removedVotes;
 }
 
 std::set<uint256> CGovernanceObjectVoteFile::RemoveInvalidVotes(const COutPoint& outpointMasternode, bool fProposal)
@@ -91,8 +102,10 @@ std::set<uint256> CGovernanceObjectVoteFile::RemoveInvalidVotes(const COutPoint&
     return removedVotes;
 }
 
-void CGovernanceObjectVoteFile::RemoveOldVotes(const CGovernanceVote& vote)
+std::set<uint256> CGovernanceObjectVoteFile::RemoveOldVotes(const CGovernanceVote& vote)
 {
+    std::set<uint256> removedVotes;
+
     auto it = listVotes.begin();
     while (it != listVotes.end()) {
         if (it->GetMasternodeOutpoint() == vote.GetMasternodeOutpoint() // same masternode
@@ -100,6 +113,7 @@ void CGovernanceObjectVoteFile::RemoveOldVotes(const CGovernanceVote& vote)
             && it->GetSignal() == vote.GetSignal() // same signal (e.g. "funding", "delete", etc.)
             && it->GetTimestamp() < vote.GetTimestamp()) // older than new vote
         {
+            removedVotes.emplace(it->GetHash());
             --nMemoryVotes;
             mapVoteIndex.erase(it->GetHash());
             listVotes.erase(it++);
@@ -107,6 +121,8 @@ void CGovernanceObjectVoteFile::RemoveOldVotes(const CGovernanceVote& vote)
             ++it;
         }
     }
+
+    return removedVotes;
 }
 
 void CGovernanceObjectVoteFile::RebuildIndex()
@@ -7,6 +7,7 @@
 
 #include <list>
 #include <map>
+#include <set>
 
 #include <governance/governance-vote.h>
 #include <serialize.h>
@@ -15,11 +16,9 @@
 
 /**
  * Represents the collection of votes associated with a given CGovernanceObject
- * Recently received votes are held in memory until a maximum size is reached after
- * which older votes a flushed to a disk file.
  *
- * Note: This is a stub implementation that doesn't limit the number of votes held
- * in memory and doesn't flush to disk.
+ * Votes are also written one by one to the governance database (see CGovernanceDb).
+ * Objects loaded from it start with an empty file which is filled on first use.
  */
 class CGovernanceObjectVoteFile
 {
@@ -41,9 +40,14 @@ public:
     CGovernanceObjectVoteFile(const CGovernanceObjectVoteFile& other);
 
     /**
-     * Add a vote to the file
+     * Add a vote to the file, returns the hashes of the older votes it replaced
      */
-    void AddVote(const CGovernanceVote& vote);
+    std::set<uint256> AddVote(const CGovernanceVote& vote);
+
+    /**
+     * Replace the contents of the file with votes read from disk
+     */
+    void LoadVotes(const std::vector<CGovernanceVote>& vecVotes);
 
     /**
      * Return true if the vote with this hash is currently cached in memory
@@ -62,7 +66,7 @@ public:
 
     std::vector<CGovernanceVote> GetVotes() const;
 
-    void RemoveVotesFromMasternode(const COutPoint& outpointMasternode);
+    std::set<uint256> RemoveVotesFromMasternode(const COutPoint& outpointMasternode);
     std::set<uint256> RemoveInvalidVotes(const COutPoint& outpointMasternode, bool fProposal);
 
     ADD_SERIALIZE_METHODS;
@@ -79,7 +83,7 @@ public:
 
 private:
     // Drop older votes for the same gobject from the same masternode
-    void RemoveOldVotes(const CGovernanceVote& vote);
+    std::set<uint256> RemoveOldVotes(const CGovernanceVote& vote);
 
     void RebuildIndex();
 };
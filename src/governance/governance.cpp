@@ -3,8 +3,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <governance/governance.h>
+#include <bls/bls_batchverifier.h>
 #include <consensus/validation.h>
 #include <governance/governance-classes.h>
+#include <governance/governance-db.h>
 #include <governance/governance-validators.h>
 #include <init.h>
 #include <masternode/masternode-meta.h>
@@ -16,6 +18,8 @@
 #include <spork.h>
 #include <validation.h>
 
+#include <cxxtimer.hpp>
+
 CGovernanceManager governance;
 
 int nSubmittedFinalBudget;
@@ -64,7 +68,13 @@ bool CGovernanceManager::HaveVoteForHash(const uint256& nHash) const
     LOCK(cs);
 
     CGovernanceObject* pGovobj = nullptr;
-    return cmapVoteToObject.Get(nHash, pGovobj) && pGovobj->GetVoteFile().HasVote(nHash);
+    if (!cmapVoteToObject.Get(nHash, pGovobj)) {
+        return false;
+    }
+    if (!pGovobj->AreVotesLoaded()) {
+        return governanceDb && governanceDb->HasVote(pGovobj->GetHash(), nHash);
+    }
+    return pGovobj->GetVoteFile().HasVote(nHash);
 }
 
 int CGovernanceManager::GetVoteCount() const
@@ -78,7 +88,19 @@ bool CGovernanceManager::SerializeVoteForHash(const uint256& nHash, CDataStream&
     LOCK(cs);
 
     CGovernanceObject* pGovobj = nullptr;
-    return cmapVoteToObject.Get(nHash, pGovobj) && pGovobj->GetVoteFile().SerializeVoteToStream(nHash, ss);
+    if (!cmapVoteToObject.Get(nHash, pGovobj)) {
+        return false;
+    }
+    if (!pGovobj->AreVotesLoaded()) {
+        // answer single vote requests from the database instead of reading the whole vote file
+        CGovernanceVote vote;
+        if (!governanceDb || !governanceDb->ReadVote(pGovobj->GetHash(), nHash, vote)) {
+            return false;
+        }
+        ss << vote;
+        return true;
+    }
+    return pGovobj->GetVoteFile().SerializeVoteToStream(nHash, ss);
 }
 
 void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman, bool enable_bip61)
@@ -237,18 +259,10 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strComm
             return;
         }
 
-        CGovernanceException exception;
-        if (ProcessVote(pfrom, vote, exception, connman)) {
-            LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- %s new\n", strHash);
-            masternodeSync.BumpAssetLastTime("MNGOVERNANCEOBJECTVOTE");
-            vote.Relay(connman);
-        } else {
-            LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- Rejected vote, error = %s\n", exception.what());
-            if ((exception.GetNodePenalty() != 0) && masternodeSync.IsSynced()) {
-                LOCK(cs_main);
-                Misbehaving(pfrom->GetId(), exception.GetNodePenalty());
-            }
-            return;
+        // the signature is verified together with other received votes, see ProcessPendingVotes
+        LOCK(cs);
+        if (setPendingVotes.emplace(nHash).second) {
+            mapPendingVotes[pfrom->GetId()].emplace_back(vote);
         }
     }
 }
@@ -308,6 +322,11 @@ void CGovernanceManager::AddGovernanceObject(CGovernanceObject& govobj, CConnman
         return;
     }
 
+    if (governanceDb && !governanceDb->WriteObject(objpair.first->second)) {
+        // stays dirty, FlushToDb retries
+        LogPrintf("CGovernanceManager::AddGovernanceObject -- failed to write governance object %s to the database\n", nHash.ToString());
+    }
+
     // SHOULD WE ADD THIS OBJECT TO ANY OTHER MANAGERS?
 
     LogPrint(BCLog::GOBJECT, "CGovernanceManager::AddGovernanceObject -- Before trigger block, GetDataAsPlainString = %s, nObjectType = %d\n",
@@ -331,8 +350,9 @@ void CGovernanceManager::AddGovernanceObject(CGovernanceObject& govobj, CConnman
 
     // WE MIGHT HAVE PENDING/ORPHAN VOTES FOR THIS OBJECT
 
+    // votes must go to the stored object, they are indexed and persisted with it
     CGovernanceException exception;
-    CheckOrphanVotes(govobj, exception, connman);
+    CheckOrphanVotes(objpair.first->second, exception, connman);
 
     // SEND NOTIFICATION TO SCRIPT/ZMQ
     GetMainSignals().NotifyGovernanceObject(std::make_shared<const CGovernanceObject>(govobj));
@@ -423,6 +443,9 @@ void CGovernanceManager::UpdateCachesAndClean()
             }
 
             mapErasedGovernanceObjects.insert(std::make_pair(nHash, nTimeExpired));
+            if (governanceDb && !governanceDb->EraseObject(nHash)) {
+                LogPrintf("CGovernanceManager::UpdateCachesAndClean -- failed to erase governance object %s from the database\n", strHash);
+            }
             mapObjects.erase(it++);
         } else {
             // NOTE: triggers are handled via triggerman
@@ -547,6 +570,10 @@ void CGovernanceManager::DoMaintenance(CConnman& connman)
     // CHECK AND REMOVE - REPROCESS GOVERNANCE OBJECTS
 
     UpdateCachesAndClean();
+
+    // PERSIST OBJECT STATE, VOTES ARE WRITTEN AS THEY ARRIVE
+
+    FlushToDb();
 }
 
 bool CGovernanceManager::ConfirmInventoryRequest(const CInv& inv)
@@ -568,7 +595,7 @@ bool CGovernanceManager::ConfirmInventoryRequest(const CInv& inv)
         break;
     }
     case MSG_GOVERNANCE_OBJECT_VOTE: {
-        if (cmapVoteToObject.HasKey(inv.hash)) {
+        if (cmapVoteToObject.HasKey(inv.hash) || setPendingVotes.count(inv.hash)) {
             LogPrint(BCLog::GOBJECT, "CGovernanceManager::ConfirmInventoryRequest already have governance vote, returning false\n");
             return false;
         }
@@ -632,6 +659,7 @@ void CGovernanceManager::SyncSingleObjVotes(CNode* pnode, const uint256& nProp,
         return;
     }
 
+    govobj.LoadVotes();
     auto fileVotes = govobj.GetVoteFile();
 
     for (const auto& vote : fileVotes.GetVotes()) {
@@ -790,7 +818,7 @@ bool CGovernanceManager::MasternodeRateCheck(const CGovernanceObject& govobj, bo
     return false;
 }
 
-bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman)
+bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman, bool fSigVerified)
 {
     ENTER_CRITICAL_SECTION(cs);
     uint256 nHashVote = vote.GetHash();
@@ -839,11 +867,170 @@ bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote,
         return false;
     }
 
-    bool fOk = govobj.ProcessVote(pfrom, vote, exception, connman) && cmapVoteToObject.Insert(nHashVote, &govobj);
+    bool fOk = govobj.ProcessVote(pfrom, vote, exception, connman, fSigVerified) && cmapVoteToObject.Insert(nHashVote, &govobj);
     LEAVE_CRITICAL_SECTION(cs);
     return fOk;
 }
 
+void CGovernanceManager::ProcessPendingVotes(CConnman& connman)
+{
+    while (!ShutdownRequested() && ProcessPendingVotesBatch(connman)) {
+    }
+}
+
+bool CGovernanceManager::CollectPendingVotes(size_t nMaxBatchSize, std::unordered_map<NodeId, std::vector<CGovernanceVote>>& votesByNode)
+{
+    LOCK(cs);
+
+    bool fMore = false;
+    for (auto it = mapPendingVotes.begin(); it != mapPendingVotes.end(); ) {
+        auto& listVotes = it->second;
+        auto& vecBatch = votesByNode[it->first];
+        while (!listVotes.empty() && vecBatch.size() < nMaxBatchSize) {
+            vecBatch.emplace_back(listVotes.front());
+            listVotes.pop_front();
+        }
+        if (listVotes.empty()) {
+            it = mapPendingVotes.erase(it);
+        } else {
+            fMore = true;
+            ++it;
+        }
+    }
+    return fMore;
+}
+
+bool CGovernanceManager::ProcessPendingVotesBatch(CConnman& connman)
+{
+    std::unordered_map<NodeId, std::vector<CGovernanceVote>> votesByNode;
+
+    const size_t nMaxBatchSize{32};
+    bool fMore = CollectPendingVotes(nMaxBatchSize, votesByNode);
+    if (votesByNode.empty()) {
+        return false;
+    }
+
+    // Operator keys are chosen by their owners, so the verification must be secure against rogue public keys.
+    // A failing batch is retried per source and then per vote, so only the peers which sent bad votes are punished.
+    CBLSBatchVerifier<NodeId, uint256> batchVerifier(true, true);
+    std::set<uint256> setVerified;
+    std::set<uint256> setBatched;
+    std::set<uint256> setBadVotes;
+    std::set<NodeId> setBadNodes;
+
+    cxxtimer::Timer prepareTimer(true);
+    size_t nVerifyCount = 0;
+    auto mnList = deterministicMNManager->GetListAtChainTip();
+    for (const auto& p : votesByNode) {
+        NodeId nodeId = p.first;
+        for (const auto& vote : p.second) {
+            int nObjectType;
+            {
+                LOCK(cs);
+                auto it = mapObjects.find(vote.GetParentHash());
+                if (it == mapObjects.end()) {
+                    // orphan votes are verified once their object arrives
+                    continue;
+                }
+                nObjectType = it->second.GetObjectType();
+            }
+            auto dmn = mnList.GetMNByCollateral(vote.GetMasternodeOutpoint());
+            if (!dmn) {
+                // rejected by ProcessVote
+                continue;
+            }
+
+            uint256 nHash = vote.GetHash();
+            if (nObjectType == GOVERNANCE_OBJECT_PROPOSAL && vote.GetSignal() == VOTE_SIGNAL_FUNDING) {
+                // voting keys are ECDSA keys, which can't be aggregated
+                if (vote.CheckSignature(dmn->pdmnState->keyIDVoting)) {
+                    setVerified.emplace(nHash);
+                } else {
+                    setBadVotes.emplace(nHash);
+                    setBadNodes.emplace(nodeId);
+                }
+                continue;
+            }
+
+            const CBLSPublicKey& pubKey = dmn->pdmnState->pubKeyOperator.Get();
+            CBLSSignature sig(vote.GetSignature());
+            if (!sig.IsValid() || !pubKey.IsValid()) {
+                setBadVotes.emplace(nHash);
+                setBadNodes.emplace(nodeId);
+                continue;
+            }
+            batchVerifier.PushMessage(nodeId, nHash, vote.GetSignatureHash(), sig, pubKey);
+            setBatched.emplace(nHash);
+            nVerifyCount++;
+        }
+    }
+    prepareTimer.stop();
+
+    cxxtimer::Timer verifyTimer(true);
+    batchVerifier.Verify();
+    verifyTimer.stop();
+
+    LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- verified votes. count=%d, pt=%d, vt=%d, nodes=%d\n", __func__,
+        nVerifyCount, prepareTimer.count(), verifyTimer.count(), votesByNode.size());
+
+    for (const auto& p : votesByNode) {
+        NodeId nodeId = p.first;
+        if (batchVerifier.badSources.count(nodeId)) {
+            setBadNodes.emplace(nodeId);
+        }
+
+        CNode* pnode = nullptr;
+        connman.ForNode(nodeId, [&](CNode* pnodeIn) {
+            pnode = pnodeIn->AddRef();
+            return true;
+        });
+
+        for (const auto& vote : p.second) {
+            uint256 nHash = vote.GetHash();
+            if (setBadVotes.count(nHash) || batchVerifier.badMessages.count(nHash)) {
+                LogPrintf("CGovernanceManager::%s -- Invalid vote signature, MN outpoint = %s, vote hash = %s, peer=%d\n", __func__,
+                    vote.GetMasternodeOutpoint().ToStringShort(), nHash.ToString(), nodeId);
+                LOCK(cs);
+                AddInvalidVote(vote);
+                continue;
+            }
+
+            CGovernanceException exception;
+            if (ProcessVote(pnode, vote, exception, connman, setVerified.count(nHash) || setBatched.count(nHash))) {
+                LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- %s new\n", nHash.ToString());
+                masternodeSync.BumpAssetLastTime("MNGOVERNANCEOBJECTVOTE");
+                vote.Relay(connman);
+            } else {
+                LogPrint(BCLog::GOBJECT, "MNGOVERNANCEOBJECTVOTE -- Rejected vote, error = %s\n", exception.what());
+                if ((exception.GetNodePenalty() != 0) && masternodeSync.IsSynced()) {
+                    LOCK(cs_main);
+                    Misbehaving(nodeId, exception.GetNodePenalty());
+                }
+            }
+        }
+
+        if (setBadNodes.count(nodeId) && masternodeSync.IsSynced()) {
+            LOCK(cs_main);
+            Misbehaving(nodeId, 20);
+        }
+
+        if (pnode) {
+            pnode->Release();
+        }
+    }
+
+    {
+        LOCK(cs);
+        for (const auto& p : votesByNode) {
+            for (const auto& vote : p.second) {
+                setPendingVotes.erase(vote.GetHash());
+            }
+        }
+    }
+
+    return fMore;
+}
+
 void CGovernanceManager::CheckPostponedObjects(CConnman& connman)
 {
     if (!masternodeSync.IsSynced()) return;
@@ -929,10 +1116,17 @@ void CGovernanceManager::RequestGovernanceObject(CNode* pfrom, const uint256& nH
 
         if (pObj) {
             filter = CBloomFilter(Params().GetConsensus().nGovernanceFilterElements, GOVERNANCE_FILTER_FP_RATE, GetRandInt(999999), BLOOM_UPDATE_ALL);
-            std::vector<CGovernanceVote> vecVotes = pObj->GetVoteFile().GetVotes();
-            nVoteCount = vecVotes.size();
-            for (const auto& vote : vecVotes) {
-                filter.insert(vote.GetHash());
+            std::vector<uint256> vecVoteHashes;
+            if (pObj->AreVotesLoaded()) {
+                for (const auto& vote : pObj->GetVoteFile().GetVotes()) {
+                    vecVoteHashes.emplace_back(vote.GetHash());
+                }
+            } else if (governanceDb) {
+                governanceDb->ReadVoteHashes(nHash, vecVoteHashes);
+            }
+            nVoteCount = vecVoteHashes.size();
+            for (const auto& nVoteHash : vecVoteHashes) {
+                filter.insert(nVoteHash);
             }
         }
     }
@@ -1084,6 +1278,17 @@ void CGovernanceManager::RebuildIndexes()
     cmapVoteToObject.Clear();
     for (auto& objPair : mapObjects) {
         CGovernanceObject& govobj = objPair.second;
+        if (!govobj.AreVotesLoaded()) {
+            // only the keys of the stored votes are read, the votes stay on disk until needed
+            std::vector<uint256> vecVoteHashes;
+            if (governanceDb) {
+                governanceDb->ReadVoteHashes(objPair.first, vecVoteHashes);
+            }
+            for (const auto& nVoteHash : vecVoteHashes) {
+                cmapVoteToObject.Insert(nVoteHash, &govobj);
+            }
+            continue;
+        }
         std::vector<CGovernanceVote> vecVotes = govobj.GetVoteFile().GetVotes();
         for (size_t i = 0; i < vecVotes.size(); ++i) {
             cmapVoteToObject.Insert(vecVotes[i].GetHash(), &govobj);
@@ -1108,6 +1313,68 @@ void CGovernanceManager::AddCachedTriggers()
     }
 }
 
+bool CGovernanceManager::LoadFromDb()
+{
+    LOCK(cs);
+
+    Clear();
+
+    if (!governanceDb) {
+        return false;
+    }
+
+    std::string strVersion;
+    DbState state(*this, strVersion);
+    if (governanceDb->ReadState(state) && strVersion != SERIALIZATION_VERSION_STRING) {
+        LogPrintf("CGovernanceManager::%s -- unknown governance database version %s, ignoring stored state\n", __func__, strVersion);
+    }
+
+    if (!governanceDb->ReadObjects(mapObjects)) {
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool CGovernanceManager::FlushToDb()
+{
+    LOCK(cs);
+
+    if (!governanceDb) {
+        return false;
+    }
+
+    std::string strVersion = SERIALIZATION_VERSION_STRING;
+    if (!governanceDb->WriteObjects(mapObjects)) {
+        LogPrintf("CGovernanceManager::%s -- failed to write governance objects\n", __func__);
+        return false;
+    }
+    if (!governanceDb->WriteState(DbState(*this, strVersion))) {
+        LogPrintf("CGovernanceManager::%s -- failed to write governance state\n", __func__);
+        return false;
+    }
+    return true;
+}
+
+bool CGovernanceManager::ImportToDb()
+{
+    LOCK(cs);
+
+    if (!governanceDb) {
+        return false;
+    }
+
+    for (const auto& objPair : mapObjects) {
+        if (!governanceDb->WriteObjectVotes(objPair.second)) {
+            LogPrintf("CGovernanceManager::%s -- failed to write votes of governance object %s\n", __func__, objPair.first.ToString());
+            return false;
+        }
+    }
+
+    return FlushToDb();
+}
+
 void CGovernanceManager::InitOnLoad()
 {
     LOCK(cs);
@@ -21,6 +21,9 @@
 
 #include <univalue.h>
 
+#include <list>
+#include <unordered_map>
+
 class CGovernanceManager;
 class CGovernanceTriggerManager;
 class CGovernanceObject;
@@ -204,6 +207,10 @@ private:
 
     hash_s_t setRequestedVotes;
 
+    // received votes waiting for batched signature verification, see ProcessPendingVotes
+    std::unordered_map<NodeId, std::list<CGovernanceVote>> mapPendingVotes;
+    hash_s_t setPendingVotes;
+
     bool fRateChecksEnabled;
 
     // used to check for changed voting keys
@@ -229,6 +236,36 @@ private:
         }
     };
 
+    /// Everything of governance.dat except the objects, stored as one record of the governance database
+    class DbState
+    {
+        CGovernanceManager& manager;
+        std::string& strVersion;
+
+    public:
+        DbState(CGovernanceManager& _manager, std::string& _strVersion) :
+            manager(_manager),
+            strVersion(_strVersion)
+        {
+        }
+
+        ADD_SERIALIZE_METHODS;
+
+        template <typename Stream, typename Operation>
+        inline void SerializationOp(Stream& s, Operation ser_action)
+        {
+            READWRITE(strVersion);
+            if (strVersion != SERIALIZATION_VERSION_STRING) {
+                return;
+            }
+            READWRITE(manager.mapErasedGovernanceObjects);
+            READWRITE(manager.cmapInvalidVotes);
+            READWRITE(manager.cmmapOrphanVotes);
+            READWRITE(manager.mapLastMasternodeObject);
+            READWRITE(manager.lastMNListForVotingKeys);
+        }
+    };
+
 public:
     // critical section to protect the inner data structures
     mutable CCriticalSection cs;
@@ -251,6 +288,9 @@ public:
 
     void DoMaintenance(CConnman& connman);
 
+    /// Verify the signatures of received votes in batches and process them, called from the scheduler
+    void ProcessPendingVotes(CConnman& connman);
+
     CGovernanceObject* FindGovernanceObject(const uint256& nHash);
 
     // These commands are only used in RPC
@@ -279,6 +319,13 @@ public:
     std::string ToString() const;
     UniValue ToJson() const;
 
+    /// Read the objects, their vote records and the remaining state from the governance database
+    bool LoadFromDb();
+    /// Write the changed object records and the remaining state, votes are already written as they are accepted
+    bool FlushToDb();
+    /// Write everything including the votes, used once after loading a governance.dat
+    bool ImportToDb();
+
     ADD_SERIALIZE_METHODS;
 
     template <typename Stream, typename Operation>
@@ -364,7 +411,10 @@ private:
         cmapInvalidVotes.Insert(vote.GetHash(), vote);
     }
 
-    bool ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman);
+    bool ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman, bool fSigVerified = false);
+
+    bool CollectPendingVotes(size_t nMaxBatchSize, std::unordered_map<NodeId, std::vector<CGovernanceVote>>& votesByNode);
+    bool ProcessPendingVotesBatch(CConnman& connman);
 
     /// Called to indicate a requested object has been received
     bool AcceptObjectMessage(const uint256& nHash);
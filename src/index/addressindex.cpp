@@ -0,0 +1,231 @@
+// Copyright (c) 2014-2015 The Bitcoin Core developers
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <hash.h>
+#include <index/addressindex.h>
+#include <script/script.h>
+#include <txdb.h>
+#include <undo.h>
+#include <util.h>
+#include <validation.h>
+
+constexpr char DB_ADDRESSINDEX = 'a';
+constexpr char DB_ADDRESSUNSPENTINDEX = 'u';
+
+std::unique_ptr<AddressIndex> g_addressindex;
+
+int GetAddressIndexType(const CScript& script, uint160& hashBytes)
+{
+    if (script.IsPayToScriptHash()) {
+        hashBytes = uint160(std::vector<unsigned char>(script.begin()+2, script.begin()+22));
+        return 2;
+    } else if (script.IsPayToPublicKeyHash()) {
+        hashBytes = uint160(std::vector<unsigned char>(script.begin()+3, script.begin()+23));
+        return 1;
+    } else if (script.IsPayToPublicKey()) {
+        hashBytes = Hash160(script.begin()+1, script.end()-1);
+        return 1;
+    }
+    hashBytes.SetNull();
+    return 0;
+}
+
+bool ReadBlockUndo(const CBlock& block, const CBlockIndex* pindex, CBlockUndo& block_undo)
+{
+    if (pindex->nHeight == 0) {
+        return true;
+    }
+    if (!UndoReadFromDisk(block_undo, pindex)) {
+        return error("%s: failed to read undo data of block %s", __func__, pindex->GetBlockHash().ToString());
+    }
+    if (block_undo.vtxundo.size() + 1 != block.vtx.size()) {
+        return error("%s: block and undo data of block %s inconsistent", __func__, pindex->GetBlockHash().ToString());
+    }
+    return true;
+}
+
+AddressIndex::AddressIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(MakeUnique<BaseIndex::DB>(GetDataDir() / "indexes" / "addressindex", n_cache_size, f_memory, f_wipe))
+{}
+
+bool AddressIndex::Init()
+{
+    if (!m_db->MigrateLegacyData(*pblocktree, GetName(), {DB_ADDRESSINDEX, DB_ADDRESSUNSPENTINDEX})) {
+        return false;
+    }
+    return BaseIndex::Init();
+}
+
+bool AddressIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    CBlockUndo block_undo;
+    if (!ReadBlockUndo(block, pindex, block_undo)) {
+        return false;
+    }
+
+    CDBBatch batch(*m_db);
+    for (unsigned int i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        const uint256 txhash = tx.GetHash();
+        uint160 hashBytes;
+
+        if (i > 0 && !tx.HasZerocoinSpendInputs()) {
+            const CTxUndo& tx_undo = block_undo.vtxundo[i - 1];
+            for (unsigned int j = 0; j < tx.vin.size(); j++) {
+                const COutPoint& input = tx.vin[j].prevout;
+                const CTxOut& prevout = tx_undo.vprevout[j].out;
+                int addressType = GetAddressIndexType(prevout.scriptPubKey, hashBytes);
+                if (addressType == 0) {
+                    continue;
+                }
+
+                // record spending activity
+                batch.Write(std::make_pair(DB_ADDRESSINDEX, CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, j, true)), prevout.nValue * -1);
+
+                // remove address from unspent index
+                batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressUnspentKey(addressType, hashBytes, input.hash, input.n)));
+            }
+        }
+
+        for (unsigned int k = 0; k < tx.vout.size(); k++) {
+            const CTxOut& out = tx.vout[k];
+            int addressType = GetAddressIndexType(out.scriptPubKey, hashBytes);
+            if (addressType == 0) {
+                continue;
+            }
+
+            // record receiving activity
+            batch.Write(std::make_pair(DB_ADDRESSINDEX, CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, k, false)), out.nValue);
+
+            // record unspent output
+            batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressUnspentKey(addressType, hashBytes, txhash, k)), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight));
+        }
+    }
+
+    return m_db->WriteBatch(batch);
+}
+
+bool AddressIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    CDBBatch batch(*m_db);
+    for (const CBlockIndex* pindex = current_tip; pindex != new_tip; pindex = pindex->pprev) {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            return error("%s: failed to read block %s from disk", __func__, pindex->GetBlockHash().ToString());
+        }
+        CBlockUndo block_undo;
+        if (!ReadBlockUndo(block, pindex, block_undo)) {
+            return false;
+        }
+
+        // undo transactions in reverse order
+        for (unsigned int i = block.vtx.size(); i-- > 0;) {
+            const CTransaction& tx = *block.vtx[i];
+            const uint256 txhash = tx.GetHash();
+            uint160 hashBytes;
+
+            for (unsigned int k = tx.vout.size(); k-- > 0;) {
+                const CTxOut& out = tx.vout[k];
+                int addressType = GetAddressIndexType(out.scriptPubKey, hashBytes);
+                if (addressType == 0) {
+                    continue;
+                }
+
+                // undo receiving activity
+                batch.Erase(std::make_pair(DB_ADDRESSINDEX, CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, k, false)));
+
+                // undo unspent index
+                batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressUnspentKey(addressType, hashBytes, txhash, k)));
+            }
+
+            if (i == 0 || tx.HasZerocoinSpendInputs()) {
+                continue;
+            }
+
+            const CTxUndo& tx_undo = block_undo.vtxundo[i - 1];
+            for (unsigned int j = tx.vin.size(); j-- > 0;) {
+                const COutPoint& input = tx.vin[j].prevout;
+                const Coin& coin = tx_undo.vprevout[j];
+                int addressType = GetAddressIndexType(coin.out.scriptPubKey, hashBytes);
+                if (addressType == 0) {
+                    continue;
+                }
+
+                // undo spending activity
+                batch.Erase(std::make_pair(DB_ADDRESSINDEX, CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, j, true)));
+
+                // restore unspent index
+                batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressUnspentKey(addressType, hashBytes, input.hash, input.n)), CAddressUnspentValue(coin.out.nValue, coin.out.scriptPubKey, coin.nHeight));
+            }
+        }
+    }
+
+    if (!m_db->WriteBatch(batch)) {
+        return false;
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+bool AddressIndex::ReadAddressIndex(uint160 addressHash, int type,
+                                    std::vector<std::pair<CAddressIndexKey, CAmount> >& addressIndex,
+                                    int start, int end) const
+{
+    std::unique_ptr<CDBIterator> pcursor(m_db->NewIterator());
+
+    if (start > 0 && end > 0) {
+        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, start)));
+    } else {
+        pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorKey(type, addressHash)));
+    }
+
+    while (pcursor->Valid()) {
+        std::pair<char, CAddressIndexKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX && key.second.hashBytes == addressHash) {
+            if (end > 0 && key.second.blockHeight > end) {
+                break;
+            }
+            CAmount nValue;
+            if (pcursor->GetValue(nValue)) {
+                addressIndex.push_back(std::make_pair(key.second, nValue));
+                pcursor->Next();
+            } else {
+                return error("failed to get address index value");
+            }
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool AddressIndex::ReadAddressUnspentIndex(uint160 addressHash, int type,
+                                           std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >& unspentOutputs) const
+{
+    std::unique_ptr<CDBIterator> pcursor(m_db->NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressIndexIteratorKey(type, addressHash)));
+
+    while (pcursor->Valid()) {
+        std::pair<char, CAddressUnspentKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_ADDRESSUNSPENTINDEX && key.second.hashBytes == addressHash) {
+            CAddressUnspentValue nValue;
+            if (pcursor->GetValue(nValue)) {
+                unspentOutputs.push_back(std::make_pair(key.second, nValue));
+                pcursor->Next();
+            } else {
+                return error("failed to get address unspent value");
+            }
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2014-2015 The Bitcoin Core developers
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_ADDRESSINDEX_H
+#define BITCOIN_INDEX_ADDRESSINDEX_H
+
+#include <amount.h>
+#include <chain.h>
+#include <index/base.h>
+#include <spentindex.h>
+
+class CBlockUndo;
+class CScript;
+
+/**
+ * Extract the address hash that the address and spent indexes record for a script.
+ * Returns the address type (1 for P2PKH and P2PK, 2 for P2SH) or 0 if the script is not indexed.
+ */
+int GetAddressIndexType(const CScript& script, uint160& hashBytes);
+
+/** Read the undo data of a block and check that it matches the block. Genesis has no undo data. */
+bool ReadBlockUndo(const CBlock& block, const CBlockIndex* pindex, CBlockUndo& block_undo);
+
+/**
+ * AddressIndex records the receiving and spending activity of every address as well as its
+ * unspent outputs. Spent outputs are taken from the block undo data, so the index can be
+ * built in the background without access to the UTXO set.
+ */
+class AddressIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+protected:
+    bool Init() override;
+
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+    const char* GetName() const override { return "addressindex"; }
+
+public:
+    /** Constructs the index, which becomes available to be queried. */
+    explicit AddressIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /** Get the activity of an address, optionally limited to a range of heights. */
+    bool ReadAddressIndex(uint160 addressHash, int type,
+                          std::vector<std::pair<CAddressIndexKey, CAmount> >& addressIndex,
+                          int start = 0, int end = 0) const;
+
+    /** Get the unspent outputs of an address. */
+    bool ReadAddressUnspentIndex(uint160 addressHash, int type,
+                                 std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >& unspentOutputs) const;
+};
+
+/** The global address index, used by the address RPCs. May be null. */
+extern std::unique_ptr<AddressIndex> g_addressindex;
+
+#endif // BITCOIN_INDEX_ADDRESSINDEX_H
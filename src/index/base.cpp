@@ -0,0 +1,461 @@
+// Copyright (c) 2017-2018 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <index/base.h>
+#include <init.h>
+#include <tinyformat.h>
+#include <txdb.h>
+#include <ui_interface.h>
+#include <util.h>
+#include <validation.h>
+#include <warnings.h>
+
+constexpr char DB_BEST_BLOCK = 'B';
+constexpr char DB_LEGACY_MIGRATION = 'M';
+
+constexpr size_t LEGACY_MIGRATION_BATCH_SIZE = 16 << 20;
+
+constexpr int64_t SYNC_LOG_INTERVAL = 30; // seconds
+constexpr int64_t SYNC_LOCATOR_WRITE_INTERVAL = 30; // seconds
+
+template<typename... Args>
+static void FatalError(const char* fmt, const Args&... args)
+{
+    std::string strMessage = tfm::format(fmt, args...);
+    SetMiscWarning(strMessage);
+    LogPrintf("*** %s\n", strMessage);
+    uiInterface.ThreadSafeMessageBox(
+        "Error: A fatal internal error occurred, see debug.log for details",
+        "", CClientUIInterface::MSG_ERROR);
+    StartShutdown();
+}
+
+BaseIndex::DB::DB(const fs::path& path, size_t n_cache_size, bool f_memory, bool f_wipe, bool f_obfuscate) :
+    CDBWrapper(path, n_cache_size, f_memory, f_wipe, f_obfuscate)
+{}
+
+bool BaseIndex::DB::ReadBestBlock(CBlockLocator& locator) const
+{
+    bool success = Read(DB_BEST_BLOCK, locator);
+    if (!success) {
+        locator.SetNull();
+    }
+    return success;
+}
+
+void BaseIndex::DB::WriteBestBlock(CDBBatch& batch, const CBlockLocator& locator)
+{
+    batch.Write(DB_BEST_BLOCK, locator);
+}
+
+namespace {
+
+/** Key or value of a database entry, copied as it is stored. */
+struct RawDBEntry
+{
+    std::vector<char> data;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s.write(data.data(), data.size());
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        data.resize(s.size());
+        s.read(data.data(), data.size());
+    }
+};
+
+} // namespace
+
+bool BaseIndex::DB::MigrateLegacyData(CBlockTreeDB& block_tree_db, const std::string& name, const std::vector<char>& prefixes)
+{
+    bool f_legacy_index = false;
+    block_tree_db.ReadFlag(name, f_legacy_index);
+
+    CBlockLocator locator;
+    if (f_legacy_index) {
+        // Entries of an earlier build of this database may be stale, drop them before taking over
+        // the legacy entries, which are in sync with the chain as it was loaded.
+        CDBBatch batch(*this);
+        batch.Erase(DB_BEST_BLOCK);
+        std::unique_ptr<CDBIterator> cursor(NewIterator());
+        for (char prefix : prefixes) {
+            for (cursor->Seek(prefix); cursor->Valid(); cursor->Next()) {
+                RawDBEntry key;
+                if (!cursor->GetKey(key) || key.data.empty() || key.data[0] != prefix) {
+                    break;
+                }
+                batch.Erase(key);
+            }
+        }
+        if (!WriteBatch(batch, true)) {
+            return error("%s: failed to clear %s database", __func__, name);
+        }
+
+        {
+            LOCK(cs_main);
+            locator = chainActive.GetLocator();
+        }
+        // The marker holds the best block of the legacy entries while they are moved, so an
+        // interrupted migration resumes on the next start.
+        if (!block_tree_db.Write(std::make_pair(DB_LEGACY_MIGRATION, name), locator, true) ||
+            !block_tree_db.WriteFlag(name, false)) {
+            return error("%s: failed to start migration of %s", __func__, name);
+        }
+    } else if (!block_tree_db.Read(std::make_pair(DB_LEGACY_MIGRATION, name), locator)) {
+        return true;
+    }
+
+    LogPrintf("Moving %s data from the block tree database. This may take a while...\n", name);
+    uiInterface.ShowProgress(strprintf(_("Upgrading %s database..."), name), 0, true);
+    for (size_t i = 0; i < prefixes.size(); ++i) {
+        const char prefix = prefixes[i];
+        CDBBatch batch_newdb(*this);
+        CDBBatch batch_olddb(block_tree_db);
+        std::unique_ptr<CDBIterator> cursor(block_tree_db.NewIterator());
+        for (cursor->Seek(prefix); cursor->Valid(); cursor->Next()) {
+            if (ShutdownRequested()) {
+                return error("%s: migration of %s interrupted", __func__, name);
+            }
+
+            RawDBEntry key, value;
+            if (!cursor->GetKey(key) || key.data.empty() || key.data[0] != prefix) {
+                break;
+            }
+            if (!cursor->GetValue(value)) {
+                return error("%s: cannot read %s entry from the block tree database", __func__, name);
+            }
+            batch_newdb.Write(key, value);
+            batch_olddb.Erase(key);
+
+            if (batch_newdb.SizeEstimate() > LEGACY_MIGRATION_BATCH_SIZE) {
+                // Sync the new entries before erasing the old ones, so a crash never loses data.
+                if (!WriteBatch(batch_newdb, true) || !block_tree_db.WriteBatch(batch_olddb)) {
+                    return error("%s: failed to move %s entries", __func__, name);
+                }
+                batch_newdb.Clear();
+                batch_olddb.Clear();
+            }
+        }
+        if (!WriteBatch(batch_newdb, true) || !block_tree_db.WriteBatch(batch_olddb)) {
+            return error("%s: failed to move %s entries", __func__, name);
+        }
+        block_tree_db.CompactRange(prefix, static_cast<char>(prefix + 1));
+        uiInterface.ShowProgress(strprintf(_("Upgrading %s database..."), name), (i + 1) * 100 / prefixes.size(), true);
+    }
+
+    CDBBatch batch(*this);
+    WriteBestBlock(batch, locator);
+    if (!WriteBatch(batch, true) || !block_tree_db.Erase(std::make_pair(DB_LEGACY_MIGRATION, name), true)) {
+        return error("%s: failed to finish migration of %s", __func__, name);
+    }
+    uiInterface.ShowProgress("", 100, false);
+    LogPrintf("Moved %s data from the block tree database.\n", name);
+    return true;
+}
+
+BaseIndex::~BaseIndex()
+{
+    Interrupt();
+    Stop();
+}
+
+bool BaseIndex::Init()
+{
+    CBlockLocator locator;
+    if (!GetDB().ReadBestBlock(locator)) {
+        locator.SetNull();
+    }
+
+    LOCK(cs_main);
+    if (locator.IsNull()) {
+        m_best_block_index = nullptr;
+    } else {
+        m_best_block_index = FindForkInGlobalIndex(chainActive, locator);
+    }
+    m_synced = m_best_block_index.load() == chainActive.Tip();
+    return true;
+}
+
+static const CBlockIndex* NextSyncBlock(const CBlockIndex* pindex_prev)
+{
+    AssertLockHeld(cs_main);
+
+    if (!pindex_prev) {
+        return chainActive.Genesis();
+    }
+
+    const CBlockIndex* pindex = chainActive.Next(pindex_prev);
+    if (pindex) {
+        return pindex;
+    }
+
+    return chainActive.Next(chainActive.FindFork(pindex_prev));
+}
+
+void BaseIndex::ThreadSync()
+{
+    const CBlockIndex* pindex = m_best_block_index.load();
+    if (!m_synced) {
+        auto& consensus_params = Params().GetConsensus();
+
+        int64_t last_log_time = 0;
+        int64_t last_locator_write_time = 0;
+        while (true) {
+            if (m_interrupt) {
+                m_best_block_index = pindex;
+                // No need to handle errors in Commit. If it fails, the error will be already be
+                // logged. The best way to recover is to continue, as index cannot be corrupted by
+                // a missed commit to disk for an advanced index state.
+                Commit();
+                return;
+            }
+
+            {
+                LOCK(cs_main);
+                const CBlockIndex* pindex_next = NextSyncBlock(pindex);
+                if (!pindex_next) {
+                    m_best_block_index = pindex;
+                    m_synced = true;
+                    // No need to handle errors in Commit. See rationale above.
+                    Commit();
+                    break;
+                }
+                if (pindex_next->pprev != pindex && !Rewind(pindex, pindex_next->pprev)) {
+                    FatalError("%s: Failed to rewind index %s to a previous chain tip",
+                               __func__, GetName());
+                    return;
+                }
+                pindex = pindex_next;
+            }
+
+            int64_t current_time = GetTime();
+            if (last_log_time + SYNC_LOG_INTERVAL < current_time) {
+                LogPrintf("Syncing %s with block chain from height %d\n",
+                          GetName(), pindex->nHeight);
+                last_log_time = current_time;
+            }
+
+            if (last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
+                m_best_block_index = pindex;
+                last_locator_write_time = current_time;
+                // No need to handle errors in Commit. See rationale above.
+                Commit();
+            }
+
+            CBlock block;
+            if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
+                FatalError("%s: Failed to read block %s from disk",
+                           __func__, pindex->GetBlockHash().ToString());
+                return;
+            }
+            if (!WriteBlock(block, pindex)) {
+                FatalError("%s: Failed to write block %s to index database",
+                           __func__, pindex->GetBlockHash().ToString());
+                return;
+            }
+        }
+    }
+
+    if (pindex) {
+        LogPrintf("%s is enabled at height %d\n", GetName(), pindex->nHeight);
+    } else {
+        LogPrintf("%s is enabled\n", GetName());
+    }
+}
+
+bool BaseIndex::Commit()
+{
+    CDBBatch batch(GetDB());
+    if (!CommitInternal(batch) || !GetDB().WriteBatch(batch)) {
+        return error("%s: Failed to commit latest %s state", __func__, GetName());
+    }
+    return true;
+}
+
+bool BaseIndex::CommitInternal(CDBBatch& batch)
+{
+    LOCK(cs_main);
+    GetDB().WriteBestBlock(batch, chainActive.GetLocator(m_best_block_index));
+    return true;
+}
+
+bool BaseIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    assert(current_tip == m_best_block_index);
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    // In the case of a reorg, ensure persisted block locator is not stale.
+    m_best_block_index = new_tip;
+    if (!Commit()) {
+        // If commit fails, revert the best block index to avoid corruption.
+        m_best_block_index = current_tip;
+        return false;
+    }
+
+    return true;
+}
+
+void BaseIndex::BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex,
+                               const std::vector<CTransactionRef>& txn_conflicted)
+{
+    if (!m_synced) {
+        return;
+    }
+
+    const CBlockIndex* best_block_index = m_best_block_index.load();
+    if (!best_block_index) {
+        if (pindex->nHeight != 0) {
+            FatalError("%s: First block connected is not the genesis block (height=%d)",
+                       __func__, pindex->nHeight);
+            return;
+        }
+    } else {
+        // Ensure block connects to an ancestor of the current best block. This should be the case
+        // most of the time, but may not be immediately after the sync thread catches up and sets
+        // m_synced. Consider the case where there is a reorg and the blocks on the stale branch are
+        // in the ValidationInterface queue backlog even after the sync thread has caught up to the
+        // new chain tip. In this unlikely event, log a warning and let the queue clear.
+        if (best_block_index->GetAncestor(pindex->nHeight - 1) != pindex->pprev) {
+            LogPrintf("%s: WARNING: Block %s does not connect to an ancestor of " /* Continued */
+                      "known best chain (tip=%s); not updating index\n",
+                      __func__, pindex->GetBlockHash().ToString(),
+                      best_block_index->GetBlockHash().ToString());
+            return;
+        }
+        if (best_block_index != pindex->pprev && !Rewind(best_block_index, pindex->pprev)) {
+            FatalError("%s: Failed to rewind index %s to a previous chain tip",
+                       __func__, GetName());
+            return;
+        }
+    }
+
+    if (WriteBlock(*block, pindex)) {
+        m_best_block_index = pindex;
+    } else {
+        FatalError("%s: Failed to write block %s to index",
+                   __func__, pindex->GetBlockHash().ToString());
+        return;
+    }
+}
+
+void BaseIndex::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    if (!m_synced) {
+        return;
+    }
+
+    // Rewind right away so that the index does not serve data of a disconnected block until the
+    // next block is connected. If the disconnected block is not the best block of the index, the
+    // notification is stale and the rewind is left to BlockConnected.
+    const CBlockIndex* best_block_index = m_best_block_index.load();
+    if (best_block_index != pindex) {
+        LogPrintf("%s: WARNING: Disconnected block %s is not the best block of the index " /* Continued */
+                  "(tip=%s); not rewinding index\n",
+                  __func__, pindex->GetBlockHash().ToString(),
+                  best_block_index ? best_block_index->GetBlockHash().ToString() : "null");
+        return;
+    }
+
+    if (!Rewind(pindex, pindex->pprev)) {
+        FatalError("%s: Failed to rewind index %s to a previous chain tip",
+                   __func__, GetName());
+    }
+}
+
+void BaseIndex::SetBestChain(const CBlockLocator& locator)
+{
+    if (!m_synced) {
+        return;
+    }
+
+    const uint256& locator_tip_hash = locator.vHave.front();
+    const CBlockIndex* locator_tip_index;
+    {
+        LOCK(cs_main);
+        locator_tip_index = LookupBlockIndex(locator_tip_hash);
+    }
+
+    if (!locator_tip_index) {
+        FatalError("%s: First block (hash=%s) in locator was not found",
+                   __func__, locator_tip_hash.ToString());
+        return;
+    }
+
+    // This checks that SetBestChain callbacks are received after BlockConnected. The check may fail
+    // immediately after the sync thread catches up and sets m_synced. Consider the case where
+    // there is a reorg and the blocks on the stale branch are in the ValidationInterface queue
+    // backlog even after the sync thread has caught up to the new chain tip. In this unlikely
+    // event, log a warning and let the queue clear.
+    const CBlockIndex* best_block_index = m_best_block_index.load();
+    if (best_block_index->GetAncestor(locator_tip_index->nHeight) != locator_tip_index) {
+        LogPrintf("%s: WARNING: Locator contains block (hash=%s) not on known best " /* Continued */
+                  "chain (tip=%s); not writing index locator\n",
+                  __func__, locator_tip_hash.ToString(),
+                  best_block_index->GetBlockHash().ToString());
+        return;
+    }
+
+    // No need to handle errors in Commit. If it fails, the error will be already be logged. The
+    // best way to recover is to continue, as index cannot be corrupted by a missed commit to disk
+    // for an advanced index state.
+    Commit();
+}
+
+bool BaseIndex::BlockUntilSyncedToCurrentChain()
+{
+    AssertLockNotHeld(cs_main);
+
+    if (!m_synced) {
+        return false;
+    }
+
+    {
+        // Skip the queue-draining stuff if we know we're caught up with
+        // chainActive.Tip().
+        LOCK(cs_main);
+        const CBlockIndex* chain_tip = chainActive.Tip();
+        const CBlockIndex* best_block_index = m_best_block_index.load();
+        if (best_block_index->GetAncestor(chain_tip->nHeight) == chain_tip) {
+            return true;
+        }
+    }
+
+    LogPrintf("%s: %s is catching up on block notifications\n", __func__, GetName());
+    SyncWithValidationInterfaceQueue();
+    return true;
+}
+
+void BaseIndex::Interrupt()
+{
+    m_interrupt();
+}
+
+void BaseIndex::Start()
+{
+    // Need to register this ValidationInterface before running Init(), so that
+    // callbacks are not missed if Init sets m_synced to true.
+    RegisterValidationInterface(this);
+    if (!Init()) {
+        FatalError("%s: %s failed to initialize", __func__, GetName());
+        return;
+    }
+
+    m_thread_sync = std::thread(&TraceThread<std::function<void()>>, GetName(),
+                                std::bind(&BaseIndex::ThreadSync, this));
+}
+
+void BaseIndex::Stop()
+{
+    UnregisterValidationInterface(this);
+
+    if (m_thread_sync.joinable()) {
+        m_thread_sync.join();
+    }
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2014-2015 The Bitcoin Core developers
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <index/addressindex.h>
+#include <index/spentindex.h>
+#include <txdb.h>
+#include <undo.h>
+#include <util.h>
+#include <validation.h>
+
+constexpr char DB_SPENTINDEX = 'p';
+
+std::unique_ptr<SpentIndex> g_spentindex;
+
+SpentIndex::SpentIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(MakeUnique<BaseIndex::DB>(GetDataDir() / "indexes" / "spentindex", n_cache_size, f_memory, f_wipe))
+{}
+
+bool SpentIndex::Init()
+{
+    if (!m_db->MigrateLegacyData(*pblocktree, GetName(), {DB_SPENTINDEX})) {
+        return false;
+    }
+    return BaseIndex::Init();
+}
+
+bool SpentIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    CBlockUndo block_undo;
+    if (!ReadBlockUndo(block, pindex, block_undo)) {
+        return false;
+    }
+
+    CDBBatch batch(*m_db);
+    for (unsigned int i = 1; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        if (tx.HasZerocoinSpendInputs()) {
+            continue;
+        }
+
+        const uint256 txhash = tx.GetHash();
+        const CTxUndo& tx_undo = block_undo.vtxundo[i - 1];
+        for (unsigned int j = 0; j < tx.vin.size(); j++) {
+            const COutPoint& input = tx.vin[j].prevout;
+            const CTxOut& prevout = tx_undo.vprevout[j].out;
+            uint160 hashBytes;
+            int addressType = GetAddressIndexType(prevout.scriptPubKey, hashBytes);
+
+            // add the spent index to determine the txid and input that spent an output
+            // and to find the amount and address from an input
+            batch.Write(std::make_pair(DB_SPENTINDEX, CSpentIndexKey(input.hash, input.n)),
+                        CSpentIndexValue(txhash, j, pindex->nHeight, prevout.nValue, addressType, hashBytes));
+        }
+    }
+
+    return m_db->WriteBatch(batch);
+}
+
+bool SpentIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    CDBBatch batch(*m_db);
+    for (const CBlockIndex* pindex = current_tip; pindex != new_tip; pindex = pindex->pprev) {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            return error("%s: failed to read block %s from disk", __func__, pindex->GetBlockHash().ToString());
+        }
+
+        for (unsigned int i = 1; i < block.vtx.size(); i++) {
+            const CTransaction& tx = *block.vtx[i];
+            if (tx.HasZerocoinSpendInputs()) {
+                continue;
+            }
+            for (const CTxIn& txin : tx.vin) {
+                // undo and delete the spent index
+                batch.Erase(std::make_pair(DB_SPENTINDEX, CSpentIndexKey(txin.prevout.hash, txin.prevout.n)));
+            }
+        }
+    }
+
+    if (!m_db->WriteBatch(batch)) {
+        return false;
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+bool SpentIndex::ReadSpentIndex(const CSpentIndexKey& key, CSpentIndexValue& value) const
+{
+    return m_db->Read(std::make_pair(DB_SPENTINDEX, key), value);
+}
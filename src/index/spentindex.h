@@ -0,0 +1,44 @@
+// Copyright (c) 2014-2015 The Bitcoin Core developers
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SPENTINDEX_H
+#define BITCOIN_INDEX_SPENTINDEX_H
+
+#include <chain.h>
+#include <index/base.h>
+#include <spentindex.h>
+
+/**
+ * SpentIndex maps every spent outpoint to the transaction input that spent it, together with
+ * the amount and address of the spent output.
+ */
+class SpentIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+protected:
+    bool Init() override;
+
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+    const char* GetName() const override { return "spentindex"; }
+
+public:
+    /** Constructs the index, which becomes available to be queried. */
+    explicit SpentIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /** Look up the input spending an outpoint. */
+    bool ReadSpentIndex(const CSpentIndexKey& key, CSpentIndexValue& value) const;
+};
+
+/** The global spent index, used by the spent info RPCs. May be null. */
+extern std::unique_ptr<SpentIndex> g_spentindex;
+
+#endif // BITCOIN_INDEX_SPENTINDEX_H
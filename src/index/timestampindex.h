@@ -0,0 +1,43 @@
+// Copyright (c) 2014-2015 The Bitcoin Core developers
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_TIMESTAMPINDEX_H
+#define BITCOIN_INDEX_TIMESTAMPINDEX_H
+
+#include <chain.h>
+#include <index/base.h>
+#include <spentindex.h>
+
+/**
+ * TimestampIndex maps block timestamps to the hashes of the blocks on the active chain.
+ */
+class TimestampIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+protected:
+    bool Init() override;
+
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+    const char* GetName() const override { return "timestampindex"; }
+
+public:
+    /** Constructs the index, which becomes available to be queried. */
+    explicit TimestampIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /** Get the hashes of all blocks with a timestamp in [low, high]. */
+    bool ReadTimestampIndex(const unsigned int& high, const unsigned int& low, std::vector<uint256>& hashes) const;
+};
+
+/** The global timestamp index, used by getblockhashes. May be null. */
+extern std::unique_ptr<TimestampIndex> g_timestampindex;
+
+#endif // BITCOIN_INDEX_TIMESTAMPINDEX_H
@@ -0,0 +1,251 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <consensus/tokengroups.h>
+#include <index/addressindex.h>
+#include <index/tokenindex.h>
+#include <script/standard.h>
+#include <undo.h>
+#include <util.h>
+#include <validation.h>
+
+#include <unordered_map>
+
+constexpr char DB_TOKENSUPPLY = 'g';
+constexpr char DB_TOKENBALANCE = 'b';
+
+std::unique_ptr<TokenIndex> g_tokenindex;
+
+/** Map a grouped script to the address type and hash used as balance key. Returns 0 if it has no address. */
+static uint8_t GetTokenAddress(const CScript& script, uint160& hashBytes)
+{
+    CTxDestination dest;
+    if (!ExtractDestination(script, dest)) {
+        return 0;
+    }
+    if (const CKeyID* keyID = boost::get<CKeyID>(&dest)) {
+        hashBytes = *keyID;
+        return 1;
+    }
+    if (const CScriptID* scriptID = boost::get<CScriptID>(&dest)) {
+        hashBytes = *scriptID;
+        return 2;
+    }
+    return 0;
+}
+
+/**
+ * Accumulate the token movements of a block. The per-transaction tally is the input/output
+ * part of the balance CheckTokenGroups builds; a surplus of outputs is a mint and a surplus of
+ * inputs is a melt. nSign is -1 to accumulate the reverse of the block when rewinding.
+ */
+void TokenIndex::AccumulateBlockDeltas(const CBlock& block, const CBlockUndo& block_undo, int nSign,
+                                       std::map<CTokenGroupID, CTokenGroupSupply>& supply_deltas,
+                                       std::map<CTokenBalanceKey, CAmount>& balance_deltas)
+{
+    const int nATPStartHeight = Params().GetConsensus().ATPStartHeight;
+
+    for (unsigned int i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = *block.vtx[i];
+        std::unordered_map<CTokenGroupID, CTokenGroupBalance> gBalance;
+        uint160 hashBytes;
+
+        for (const CTxOut& out : tx.vout) {
+            CTokenGroupInfo tokenGrp(out.scriptPubKey);
+            if (tokenGrp.invalid || tokenGrp.associatedGroup == NoGroup || tokenGrp.isAuthority()) {
+                continue;
+            }
+            gBalance[tokenGrp.associatedGroup].output += tokenGrp.quantity;
+            uint8_t addressType = GetTokenAddress(out.scriptPubKey, hashBytes);
+            if (addressType != 0) {
+                balance_deltas[CTokenBalanceKey(tokenGrp.associatedGroup, addressType, hashBytes)] += nSign * tokenGrp.quantity;
+            }
+        }
+
+        if (i > 0 && !tx.HasZerocoinSpendInputs()) {
+            const CTxUndo& tx_undo = block_undo.vtxundo[i - 1];
+            for (const Coin& coin : tx_undo.vprevout) {
+                // no prior coins can be grouped.
+                if (coin.nHeight < nATPStartHeight) {
+                    continue;
+                }
+                CTokenGroupInfo tokenGrp(coin.out.scriptPubKey);
+                if (tokenGrp.invalid || tokenGrp.associatedGroup == NoGroup || tokenGrp.isAuthority()) {
+                    continue;
+                }
+                gBalance[tokenGrp.associatedGroup].input += tokenGrp.quantity;
+                uint8_t addressType = GetTokenAddress(coin.out.scriptPubKey, hashBytes);
+                if (addressType != 0) {
+                    balance_deltas[CTokenBalanceKey(tokenGrp.associatedGroup, addressType, hashBytes)] -= nSign * tokenGrp.quantity;
+                }
+            }
+        }
+
+        for (const auto& txo : gBalance) {
+            const CTokenGroupBalance& bal = txo.second;
+            CTokenGroupSupply& delta = supply_deltas[txo.first];
+            delta.nSupply += nSign * (bal.output - bal.input);
+            if (bal.output > bal.input) {
+                delta.nMinted += nSign * (bal.output - bal.input);
+            } else {
+                delta.nMelted += nSign * (bal.input - bal.output);
+            }
+        }
+    }
+}
+
+TokenIndex::TokenIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(MakeUnique<BaseIndex::DB>(GetDataDir() / "indexes" / "tokenindex", n_cache_size, f_memory, f_wipe))
+{}
+
+bool TokenIndex::CommitDeltas(const std::map<CTokenGroupID, CTokenGroupSupply>& supply_deltas,
+                              const std::map<CTokenBalanceKey, CAmount>& balance_deltas)
+{
+    std::map<CTokenGroupID, CTokenGroupSupply> supplies;
+    for (const auto& entry : supply_deltas) {
+        CTokenGroupSupply& supply = supplies[entry.first];
+        m_db->Read(std::make_pair(DB_TOKENSUPPLY, entry.first), supply);
+        supply.nSupply += entry.second.nSupply;
+        supply.nMinted += entry.second.nMinted;
+        supply.nMelted += entry.second.nMelted;
+    }
+
+    CDBBatch batch(*m_db);
+    for (const auto& entry : balance_deltas) {
+        if (entry.second == 0) {
+            continue;
+        }
+        CAmount nBalance = 0;
+        m_db->Read(std::make_pair(DB_TOKENBALANCE, entry.first), nBalance);
+        CAmount nNewBalance = nBalance + entry.second;
+
+        // keep the holder count in step with the set of non-zero balances
+        CTokenGroupSupply& supply = supplies[entry.first.tokenGroupID];
+        if (nBalance == 0) {
+            supply.nHolders++;
+        }
+        if (nNewBalance == 0) {
+            supply.nHolders--;
+            batch.Erase(std::make_pair(DB_TOKENBALANCE, entry.first));
+        } else {
+            batch.Write(std::make_pair(DB_TOKENBALANCE, entry.first), nNewBalance);
+        }
+    }
+
+    for (const auto& entry : supplies) {
+        batch.Write(std::make_pair(DB_TOKENSUPPLY, entry.first), entry.second);
+    }
+
+    return m_db->WriteBatch(batch);
+}
+
+bool TokenIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    if (pindex->nHeight < Params().GetConsensus().ATPStartHeight) {
+        return true;
+    }
+
+    CBlockUndo block_undo;
+    if (!ReadBlockUndo(block, pindex, block_undo)) {
+        return false;
+    }
+
+    std::map<CTokenGroupID, CTokenGroupSupply> supply_deltas;
+    std::map<CTokenBalanceKey, CAmount> balance_deltas;
+    AccumulateBlockDeltas(block, block_undo, 1, supply_deltas, balance_deltas);
+    if (supply_deltas.empty()) {
+        return true;
+    }
+
+    return CommitDeltas(supply_deltas, balance_deltas);
+}
+
+bool TokenIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    std::map<CTokenGroupID, CTokenGroupSupply> supply_deltas;
+    std::map<CTokenBalanceKey, CAmount> balance_deltas;
+    for (const CBlockIndex* pindex = current_tip; pindex != new_tip; pindex = pindex->pprev) {
+        if (pindex->nHeight < Params().GetConsensus().ATPStartHeight) {
+            break;
+        }
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            return error("%s: failed to read block %s from disk", __func__, pindex->GetBlockHash().ToString());
+        }
+        CBlockUndo block_undo;
+        if (!ReadBlockUndo(block, pindex, block_undo)) {
+            return false;
+        }
+        AccumulateBlockDeltas(block, block_undo, -1, supply_deltas, balance_deltas);
+    }
+
+    if (!supply_deltas.empty() && !CommitDeltas(supply_deltas, balance_deltas)) {
+        return false;
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+bool TokenIndex::GetTokenSupply(const CTokenGroupID& tgID, CTokenGroupSupply& supply) const
+{
+    return m_db->Read(std::make_pair(DB_TOKENSUPPLY, tgID), supply);
+}
+
+bool TokenIndex::GetAllTokenSupplies(std::vector<std::pair<CTokenGroupID, CTokenGroupSupply> >& supplies) const
+{
+    std::unique_ptr<CDBIterator> pcursor(m_db->NewIterator());
+
+    pcursor->Seek(DB_TOKENSUPPLY);
+
+    while (pcursor->Valid()) {
+        std::pair<char, CTokenGroupID> key;
+        if (pcursor->GetKey(key) && key.first == DB_TOKENSUPPLY) {
+            CTokenGroupSupply supply;
+            if (pcursor->GetValue(supply)) {
+                supplies.emplace_back(key.second, supply);
+                pcursor->Next();
+            } else {
+                return error("failed to get token supply value");
+            }
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
+
+CAmount TokenIndex::GetTokenBalance(const CTokenGroupID& tgID, uint8_t addressType, const uint160& hashBytes) const
+{
+    CAmount nBalance = 0;
+    m_db->Read(std::make_pair(DB_TOKENBALANCE, CTokenBalanceKey(tgID, addressType, hashBytes)), nBalance);
+    return nBalance;
+}
+
+bool TokenIndex::GetTokenHolders(const CTokenGroupID& tgID, std::vector<std::pair<CTokenBalanceKey, CAmount> >& holders) const
+{
+    std::unique_ptr<CDBIterator> pcursor(m_db->NewIterator());
+
+    pcursor->Seek(std::make_pair(DB_TOKENBALANCE, tgID));
+
+    while (pcursor->Valid()) {
+        std::pair<char, CTokenBalanceKey> key;
+        if (pcursor->GetKey(key) && key.first == DB_TOKENBALANCE && key.second.tokenGroupID == tgID) {
+            CAmount nBalance;
+            if (pcursor->GetValue(nBalance)) {
+                holders.emplace_back(key.second, nBalance);
+                pcursor->Next();
+            } else {
+                return error("failed to get token balance value");
+            }
+        } else {
+            break;
+        }
+    }
+
+    return true;
+}
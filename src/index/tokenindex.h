@@ -0,0 +1,121 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_TOKENINDEX_H
+#define BITCOIN_INDEX_TOKENINDEX_H
+
+#include <amount.h>
+#include <chain.h>
+#include <index/base.h>
+#include <serialize.h>
+#include <tokens/groups.h>
+#include <uint256.h>
+
+#include <map>
+#include <vector>
+
+class CBlockUndo;
+
+/** Chain-wide totals of a token group. */
+struct CTokenGroupSupply
+{
+    CAmount nSupply;
+    CAmount nMinted;
+    CAmount nMelted;
+    int64_t nHolders;
+
+    CTokenGroupSupply() : nSupply(0), nMinted(0), nMelted(0), nHolders(0) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(nSupply);
+        READWRITE(nMinted);
+        READWRITE(nMelted);
+        READWRITE(nHolders);
+    }
+};
+
+/** A token balance record, keyed by group first so that all holders of a group are adjacent. */
+struct CTokenBalanceKey
+{
+    CTokenGroupID tokenGroupID;
+    uint8_t addressType;
+    uint160 hashBytes;
+
+    CTokenBalanceKey() : addressType(0) {}
+    CTokenBalanceKey(const CTokenGroupID& tgID, uint8_t type, const uint160& hash)
+        : tokenGroupID(tgID), addressType(type), hashBytes(hash) {}
+
+    bool operator<(const CTokenBalanceKey& other) const
+    {
+        if (tokenGroupID != other.tokenGroupID) return tokenGroupID < other.tokenGroupID;
+        if (addressType != other.addressType) return addressType < other.addressType;
+        return hashBytes < other.hashBytes;
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(tokenGroupID);
+        READWRITE(addressType);
+        READWRITE(hashBytes);
+    }
+};
+
+/**
+ * TokenIndex keeps the circulating supply, the minted and melted totals and the per-address
+ * balances of every token group. Grouped inputs are taken from the block undo data, so the
+ * index is built in the background like the address index. Authority outputs carry no
+ * amount and are not counted.
+ */
+class TokenIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+protected:
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+    const char* GetName() const override { return "tokenindex"; }
+
+public:
+    /** Constructs the index, which becomes available to be queried. */
+    explicit TokenIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /**
+     * Accumulate the token movements of a block. nSign is -1 to accumulate the reverse of the
+     * block when rewinding.
+     */
+    static void AccumulateBlockDeltas(const CBlock& block, const CBlockUndo& block_undo, int nSign,
+                                      std::map<CTokenGroupID, CTokenGroupSupply>& supply_deltas,
+                                      std::map<CTokenBalanceKey, CAmount>& balance_deltas);
+
+    /** Apply accumulated supply and balance deltas to the database. */
+    bool CommitDeltas(const std::map<CTokenGroupID, CTokenGroupSupply>& supply_deltas,
+                      const std::map<CTokenBalanceKey, CAmount>& balance_deltas);
+
+    /** Get the totals of a token group. Returns false if the group has never been seen. */
+    bool GetTokenSupply(const CTokenGroupID& tgID, CTokenGroupSupply& supply) const;
+
+    /** Get the totals of all token groups seen on chain. */
+    bool GetAllTokenSupplies(std::vector<std::pair<CTokenGroupID, CTokenGroupSupply> >& supplies) const;
+
+    /** Get the balance of an address in a token group. Returns zero if the address holds none. */
+    CAmount GetTokenBalance(const CTokenGroupID& tgID, uint8_t addressType, const uint160& hashBytes) const;
+
+    /** Get all addresses holding a non-zero balance of a token group. */
+    bool GetTokenHolders(const CTokenGroupID& tgID, std::vector<std::pair<CTokenBalanceKey, CAmount> >& holders) const;
+};
+
+/** The global token index, used by the token supply and balance RPCs. May be null. */
+extern std::unique_ptr<TokenIndex> g_tokenindex;
+
+#endif // BITCOIN_INDEX_TOKENINDEX_H
@@ -24,6 +24,12 @@
 #include <fs.h>
 #include <httpserver.h>
 #include <httprpc.h>
+#include <index/addressindex.h>
+#include <index/blockfilterindex.h>
+#include <index/spentindex.h>
+#include <index/timestampindex.h>
+#include <index/tokenindex.h>
+#include <index/txindex.h>
 #include <key.h>
 #include <validation.h>
 #include <miner.h>
@@ -54,6 +60,7 @@
 #include <dsnotificationinterface.h>
 #include <flat-database.h>
 #include <governance/governance.h>
+#include <governance/governance-db.h>
 #include <masternode/masternode-meta.h>
 #include <masternode/masternode-payments.h>
 #include <masternode/masternode-sync.h>
@@ -220,6 +227,8 @@ static std::unique_ptr<ECCVerifyHandle> globalVerifyHandle;
 static boost::thread_group threadGroup;
 static CScheduler scheduler;
 
+static std::vector<BlockFilterType> g_enabled_filter_types;
+
 void Interrupt()
 {
     InterruptHTTPServer();
@@ -231,6 +240,22 @@ void Interrupt()
     InterruptMapPort();
     if (g_connman)
         g_connman->Interrupt();
+    if (g_txindex) {
+        g_txindex->Interrupt();
+    }
+    if (g_addressindex) {
+        g_addressindex->Interrupt();
+    }
+    if (g_spentindex) {
+        g_spentindex->Interrupt();
+    }
+    if (g_timestampindex) {
+        g_timestampindex->Interrupt();
+    }
+    if (g_tokenindex) {
+        g_tokenindex->Interrupt();
+    }
+    ForEachBlockFilterIndex([](BlockFilterIndex& index) { index.Interrupt(); });
 }
 
 /** Preparing steps before shutting down or restarting the wallet */
@@ -266,7 +291,12 @@ void PrepareShutdown()
     // using the other before destroying them.
     if (peerLogic) UnregisterValidationInterface(peerLogic.get());
     if (g_connman) g_connman->Stop();
-    // if (g_txindex) g_txindex->Stop(); //TODO watch out when backporting bitcoin#13033 (don't accidently put the reset here, as we've already backported bitcoin#13894)
+    if (g_txindex) g_txindex->Stop();
+    if (g_addressindex) g_addressindex->Stop();
+    if (g_spentindex) g_spentindex->Stop();
+    if (g_timestampindex) g_timestampindex->Stop();
+    if (g_tokenindex) g_tokenindex->Stop();
+    ForEachBlockFilterIndex([](BlockFilterIndex& index) { index.Stop(); });
 
     StopTorControl();
 
@@ -288,8 +318,7 @@ void PrepareShutdown()
         CFlatDB<CSporkManager> flatdb6("sporks.dat", "magicSporkCache");
         flatdb6.Dump(sporkManager);
         if (!fDisableGovernance) {
-            CFlatDB<CGovernanceManager> flatdb3("governance.dat", "magicGovernanceCache");
-            flatdb3.Dump(governance);
+            governance.FlushToDb();
         }
     }
 
@@ -297,7 +326,13 @@ void PrepareShutdown()
     // destruct and reset all to nullptr.
     peerLogic.reset();
     g_connman.reset();
-    //g_txindex.reset(); //TODO watch out when backporting bitcoin#13033 (re-enable this, was backported via bitcoin#13894)
+    governanceDb.reset();
+    g_txindex.reset();
+    g_addressindex.reset();
+    g_spentindex.reset();
+    g_timestampindex.reset();
+    g_tokenindex.reset();
+    DestroyAllBlockFilterIndexes();
 
     if (g_is_mempool_loaded && gArgs.GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
         DumpMempool();
@@ -492,6 +527,7 @@ void SetupServerArgs()
     gArgs.AddArg("-datadir=<dir>", "Specify data directory", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize), true, OptionsCategory::OPTIONS);
     gArgs.AddArg("-dbcache=<n>", strprintf("Set database cache size in megabytes (%d to %d, default: %d)", nMinDbCache, nMaxDbCache, nDefaultDbCache), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-dmnsnapshotperiod=<n>", strprintf("Write a full masternode list snapshot every <n> blocks, lower values make historic masternode list lookups faster at the cost of disk space (minimum: %d, default: %d)", MIN_DMN_SNAPSHOT_PERIOD, DEFAULT_DMN_SNAPSHOT_PERIOD), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-debuglogfile=<file>", strprintf("Specify location of debug log file. Relative paths will be prefixed by a net-specific datadir location. (0 to disable; default: %s)", DEFAULT_DEBUGLOGFILE), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-loadblock=<file>", "Imports blocks from external blk000??.dat file on startup", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-maxmempool=<n>", strprintf("Keep the transaction memory pool below <n> megabytes (default: %u)", DEFAULT_MAX_MEMPOOL_SIZE), false, OptionsCategory::OPTIONS);
@@ -514,12 +550,17 @@ void SetupServerArgs()
 #endif
     gArgs.AddArg("-version", "Print version and exit", false, OptionsCategory::OPTIONS);
 
+    gArgs.AddArg("-blockfilterindex=<type>",
+                 strprintf("Maintain an index of compact filters by block (default: %s, values: %s).", DEFAULT_BLOCKFILTERINDEX, ListBlockFilterTypes()) +
+                 " If <type> is not supplied or if <type> = 1, indexes for all known types are enabled.",
+                 false, OptionsCategory::INDEXING);
     gArgs.AddArg("-addressindex", strprintf("Maintain a full address index, used to query for the balance, txids and unspent outputs for addresses (default: %u)", DEFAULT_ADDRESSINDEX), false, OptionsCategory::INDEXING);
     gArgs.AddArg("-reindex", "Rebuild chain state and block index from the blk*.dat files on disk", false, OptionsCategory::INDEXING);
     gArgs.AddArg("-reindex-chainstate", "Rebuild chain state from the currently indexed blocks", false, OptionsCategory::INDEXING);
     gArgs.AddArg("-reindex-tokens", "Rebuld the token database", false, OptionsCategory::INDEXING);
     gArgs.AddArg("-spentindex", strprintf("Maintain a full spent index, used to query the spending txid and input index for an outpoint (default: %u)", DEFAULT_SPENTINDEX), false, OptionsCategory::INDEXING);
     gArgs.AddArg("-timestampindex", strprintf("Maintain a timestamp index for block hashes, used to query blocks hashes by a range of timestamps (default: %u)", DEFAULT_TIMESTAMPINDEX), false, OptionsCategory::INDEXING);
+    gArgs.AddArg("-tokenindex", strprintf("Maintain token supply and per-address token balances, used by the gettokensupply, listtokenholders and gettokenaddressbalance rpc calls (default: %u)", DEFAULT_TOKENINDEX), false, OptionsCategory::INDEXING);
     gArgs.AddArg("-txindex", strprintf("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)", DEFAULT_TXINDEX), false, OptionsCategory::INDEXING);
 
     gArgs.AddArg("-addnode=<ip>", "Add a node to connect to and attempt to keep the connection open (see the `addnode` RPC command help for more info). This option can be specified multiple times to add multiple nodes.", false, OptionsCategory::CONNECTION);
@@ -541,9 +582,11 @@ void SetupServerArgs()
     gArgs.AddArg("-maxsendbuffer=<n>", strprintf("Maximum per-connection send buffer, <n>*1000 bytes (default: %u)", DEFAULT_MAXSENDBUFFER), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-maxtimeadjustment", strprintf("Maximum allowed median peer time offset adjustment. Local perspective of time may be influenced by peers forward or backward by this amount. (default: %u seconds)", DEFAULT_MAX_TIME_ADJUSTMENT), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-maxuploadtarget=<n>", strprintf("Tries to keep outbound traffic under the given target (in MiB per 24h), 0 = no limit (default: %d)", DEFAULT_MAX_UPLOAD_TARGET), false, OptionsCategory::CONNECTION);
+    gArgs.AddArg("-msghandlerthreads=<n>", strprintf("Number of threads to process peer messages on, peers are distributed over them (1 to %d, default: %d)", MAX_MSGHANDLER_THREADS, DEFAULT_MSGHANDLER_THREADS), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-onion=<ip:port>", "Use separate SOCKS5 proxy to reach peers via Tor hidden services (default: -proxy)", false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-onlynet=<net>", "Make outgoing connections only through network <net> (ipv4, ipv6 or onion). Incoming connections are not affected by this option. This option can be specified multiple times to allow multiple networks.", false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-peerbloomfilters", strprintf("Support filtering of blocks and transaction with bloom filters (default: %u)", DEFAULT_PEERBLOOMFILTERS), false, OptionsCategory::CONNECTION);
+    gArgs.AddArg("-peerblockfilters", strprintf("Serve compact block filters to peers per BIP 157 (default: %u)", DEFAULT_PEERBLOCKFILTERS), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-peertimeout=<n>", strprintf("Specify p2p connection timeout in seconds. This option determines the amount of time a peer may be inactive before the connection to it is dropped. (minimum: 1, default: %d)", DEFAULT_PEER_CONNECT_TIMEOUT), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-permitbaremultisig", strprintf("Relay non-P2SH multisig (default: %u)", DEFAULT_PERMIT_BAREMULTISIG), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-port=<port>", strprintf("Listen for connections on <port> (default: %u or testnet: %u)", defaultChainParams->GetDefaultPort(), testnetChainParams->GetDefaultPort()), false, OptionsCategory::CONNECTION);
@@ -587,6 +630,7 @@ void SetupServerArgs()
     gArgs.AddArg("-checklevel=<n>", strprintf("How thorough the block verification of -checkblocks is (0-4, default: %u)", DEFAULT_CHECKLEVEL), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkmempool=<n>", strprintf("Run checks every <n> transactions (default: %u)", defaultChainParams->DefaultConsistencyChecks()), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkpoints", strprintf("Disable expensive verification for known chain history (default: %u)", DEFAULT_CHECKPOINTS_ENABLED), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-checkzerocoinspends", strprintf("Verify the signatures and serials of zerocoin spends in blocks that are not assumed valid (default: %u)", DEFAULT_CHECK_ZEROCOIN_SPENDS), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-deprecatedrpc=<method>", "Allows deprecated RPC method(s) to be used", true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-dropmessagestest=<n>", "Randomly drop 1 of every <n> network messages", true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-limitancestorcount=<n>", strprintf("Do not accept transactions if number of in-mempool ancestors is <n> or more (default: %u)", DEFAULT_ANCESTOR_LIMIT), true, OptionsCategory::DEBUG_TEST);
@@ -668,6 +712,7 @@ void SetupServerArgs()
     gArgs.AddArg("-staking=<n>", strprintf(_("Enable staking functionality (0-1, default: %u)"), 1), false, OptionsCategory::BLOCK_CREATION);
     gArgs.AddArg("-bytzstake=<n>", strprintf(_("Enable or disable staking functionality for BYTZ inputs (0-1, default: %u)"), 1), false, OptionsCategory::BLOCK_CREATION);
     gArgs.AddArg("-reservebalance=<n>", "Keep the specified amount available for spending at all times (default: 0)", false, OptionsCategory::BLOCK_CREATION);
+    gArgs.AddArg("-stakingthreads=<n>", strprintf("Set the number of threads used to search for stake kernels (0 = auto, max %d, default: %d)", MAX_STAKING_THREADS, DEFAULT_STAKING_THREADS), false, OptionsCategory::BLOCK_CREATION);
 #endif // ENABLE_WALLET
 
     gArgs.AddArg("-statsenabled", strprintf("Publish internal stats to statsd (default: %u)", DEFAULT_STATSD_ENABLE), false, OptionsCategory::STATSD);
@@ -1064,18 +1109,6 @@ void InitParameterInteraction()
         }
     }
 
-    // Make sure additional indexes are recalculated correctly in VerifyDB
-    // (we must reconnect blocks whenever we disconnect them for these indexes to work)
-    bool fAdditionalIndexes =
-        gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX) ||
-        gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX) ||
-        gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX);
-
-    if (fAdditionalIndexes && gArgs.GetArg("-checklevel", DEFAULT_CHECKLEVEL) < 4) {
-        gArgs.ForceSetArg("-checklevel", "4");
-        LogPrintf("%s: parameter interaction: additional indexes -> setting -checklevel=4\n", __func__);
-    }
-
     if (gArgs.IsArgSet("-masternodeblsprivkey") && gArgs.SoftSetBoolArg("-disablewallet", true)) {
         LogPrintf("%s: parameter interaction: -masternodeblsprivkey set -> setting -disablewallet=1\n", __func__);
     }
@@ -1194,10 +1227,36 @@ bool AppInitParameterInteraction()
         return InitError(strprintf(_("Specified blocks directory \"%s\" does not exist."), gArgs.GetArg("-blocksdir", "").c_str()));
     }
 
+    // parse and validate enabled filter types
+    std::string blockfilterindex_value = gArgs.GetArg("-blockfilterindex", DEFAULT_BLOCKFILTERINDEX);
+    if (blockfilterindex_value == "" || blockfilterindex_value == "1") {
+        g_enabled_filter_types = AllBlockFilterTypes();
+    } else if (blockfilterindex_value != "0") {
+        const std::vector<std::string> names = gArgs.GetArgs("-blockfilterindex");
+        g_enabled_filter_types.reserve(names.size());
+        for (const auto& name : names) {
+            BlockFilterType filter_type;
+            if (!BlockFilterTypeByName(name, filter_type)) {
+                return InitError(strprintf(_("Unknown -blockfilterindex value %s."), name));
+            }
+            g_enabled_filter_types.push_back(filter_type);
+        }
+    }
+
     // if using block pruning, then disallow txindex and require disabling governance validation
     if (gArgs.GetArg("-prune", 0)) {
         if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX))
             return InitError(_("Prune mode is incompatible with -txindex."));
+        if (!g_enabled_filter_types.empty()) {
+            return InitError(_("Prune mode is incompatible with -blockfilterindex."));
+        }
+        if (gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX) ||
+            gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
+            return InitError(_("Prune mode is incompatible with -addressindex and -spentindex."));
+        }
+        if (gArgs.GetBoolArg("-tokenindex", DEFAULT_TOKENINDEX)) {
+            return InitError(_("Prune mode is incompatible with -tokenindex."));
+        }
         if (!gArgs.GetBoolArg("-disablegovernance", false)) {
             return InitError(_("Prune mode is incompatible with -disablegovernance=false."));
         }
@@ -1297,6 +1356,7 @@ bool AppInitParameterInteraction()
     }
     fCheckBlockIndex = gArgs.GetBoolArg("-checkblockindex", chainparams.DefaultConsistencyChecks());
     fCheckpointsEnabled = gArgs.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
+    fCheckZerocoinSpends = gArgs.GetBoolArg("-checkzerocoinspends", DEFAULT_CHECK_ZEROCOIN_SPENDS);
 
     hashAssumeValid = uint256S(gArgs.GetArg("-assumevalid", chainparams.GetConsensus().defaultAssumeValid.GetHex()));
     if (!hashAssumeValid.IsNull())
@@ -1426,6 +1486,14 @@ bool AppInitParameterInteraction()
     if (gArgs.GetBoolArg("-peerbloomfilters", DEFAULT_PEERBLOOMFILTERS))
         nLocalServices = ServiceFlags(nLocalServices | NODE_BLOOM);
 
+    // Signal NODE_COMPACT_FILTERS if peerblockfilters and basic filters index are both enabled.
+    if (gArgs.GetBoolArg("-peerblockfilters", DEFAULT_PEERBLOCKFILTERS)) {
+        if (std::find(g_enabled_filter_types.begin(), g_enabled_filter_types.end(), BlockFilterType::BASIC_FILTER) == g_enabled_filter_types.end()) {
+            return InitError(_("Cannot set -peerblockfilters without -blockfilterindex."));
+        }
+        nLocalServices = ServiceFlags(nLocalServices | NODE_COMPACT_FILTERS);
+    }
+
     nMaxTipAge = gArgs.GetArg("-maxtipage", DEFAULT_MAX_TIP_AGE);
 
     if (gArgs.IsArgSet("-vbparams")) {
@@ -1741,6 +1809,15 @@ bool AppInitMain()
     if (nScriptCheckThreads) {
         for (int i=0; i<nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        // Inputs are prefetched before the scripts of a block are checked, so the same number of threads can be used
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadCoinPrefetch);
+        if (fCheckZerocoinSpends) {
+            // The zerocoin parameters are set up on first use, do that here before the workers can race for it
+            chainparams.Zerocoin_Params(false);
+            for (int i=0; i<nScriptCheckThreads-1; i++)
+                threadGroup.create_thread(&ThreadZerocoinSpendCheck);
+        }
     }
 
     std::vector<std::string> vSporkAddresses;
@@ -1944,9 +2021,26 @@ bool AppInitMain()
     int64_t nTotalCache = (gArgs.GetArg("-dbcache", nDefaultDbCache) << 20);
     nTotalCache = std::max(nTotalCache, nMinDbCache << 20); // total cache cannot be less than nMinDbCache
     nTotalCache = std::min(nTotalCache, nMaxDbCache << 20); // total cache cannot be greater than nMaxDbcache
-    int64_t nBlockTreeDBCache = nTotalCache / 8;
-    nBlockTreeDBCache = std::min(nBlockTreeDBCache, (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxBlockDBAndTxIndexCache : nMaxBlockDBCache) << 20);
+    int64_t nBlockTreeDBCache = std::min(nTotalCache / 8, nMaxBlockDBCache << 20);
     nTotalCache -= nBlockTreeDBCache;
+    int64_t nTxIndexCache = std::min(nTotalCache / 8, gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxTxIndexCache << 20 : 0);
+    nTotalCache -= nTxIndexCache;
+    int64_t nAddressIndexCache = 0;
+    size_t nAddressIndexes = gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX) +
+                             gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX) +
+                             gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX) +
+                             gArgs.GetBoolArg("-tokenindex", DEFAULT_TOKENINDEX);
+    if (nAddressIndexes > 0) {
+        nAddressIndexCache = std::min(nTotalCache / 8, nMaxAddressIndexCache << 20) / nAddressIndexes;
+        nTotalCache -= nAddressIndexCache * nAddressIndexes;
+    }
+    int64_t filter_index_cache = 0;
+    if (!g_enabled_filter_types.empty()) {
+        size_t n_indexes = g_enabled_filter_types.size();
+        int64_t max_cache = std::min(nTotalCache / 8, max_filter_index_cache << 20);
+        filter_index_cache = max_cache / n_indexes;
+        nTotalCache -= filter_index_cache * n_indexes;
+    }
     int64_t nCoinDBCache = std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20); // cap total coins db cache
     nTotalCache -= nCoinDBCache;
@@ -1955,6 +2049,16 @@ bool AppInitMain()
     int64_t nEvoDbCache = 1024 * 1024 * 16; // TODO
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1fMiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
+    if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
+        LogPrintf("* Using %.1fMiB for transaction index database\n", nTxIndexCache * (1.0 / 1024 / 1024));
+    }
+    if (nAddressIndexes > 0) {
+        LogPrintf("* Using %.1fMiB for each address, spent, timestamp and token index database\n", nAddressIndexCache * (1.0 / 1024 / 1024));
+    }
+    for (BlockFilterType filter_type : g_enabled_filter_types) {
+        LogPrintf("* Using %.1f MiB for %s block filter index database\n",
+                  filter_index_cache * (1.0 / 1024 / 1024), BlockFilterTypeName(filter_type));
+    }
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for in-memory UTXO set (plus up to %.1fMiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
 
@@ -1985,7 +2089,7 @@ bool AppInitMain()
                 evoDb.reset();
                 evoDb.reset(new CEvoDB(nEvoDbCache, false, fReset || fReindexChainState));
                 deterministicMNManager.reset();
-                deterministicMNManager.reset(new CDeterministicMNManager(*evoDb));
+                deterministicMNManager.reset(new CDeterministicMNManager(*evoDb, gArgs.GetArg("-dmnsnapshotperiod", DEFAULT_DMN_SNAPSHOT_PERIOD)));
                 zerocoinDB.reset();
                 zerocoinDB.reset(new CZerocoinDB(0, false, fReset || fReindexChainState));
                 pTokenDB.reset();
@@ -2004,9 +2108,8 @@ bool AppInitMain()
 
                 if (fRequestShutdown) break;
 
-                // LoadBlockIndex will load fTxIndex from the db, or set it if
-                // we're reindexing. It will also load fHavePruned if we've
-                // ever removed a block file from disk.
+                // LoadBlockIndex will load fHavePruned if we've ever removed a
+                // block file from disk.
                 // Note that it also sets fReindex based on the disk flag!
                 // From here on out fReindex and fReset mean something different!
                 if (!LoadBlockIndex(chainparams)) {
@@ -2014,7 +2117,7 @@ bool AppInitMain()
                     break;
                 }
 
-                if (!fDisableGovernance && !fTxIndex
+                if (!fDisableGovernance && !gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX)
                    && chainparams.NetworkIDString() != CBaseChainParams::REGTEST) { // TODO remove this when pruning is fixed. See https://github.com/dashpay/dash/pull/1817 and https://github.com/dashpay/dash/pull/1743
                     return InitError(_("Transaction index can't be disabled with governance validation enabled. Either start with -disablegovernance command line switch or enable transaction index."));
                 }
@@ -2028,30 +2131,6 @@ bool AppInitMain()
                 if (!chainparams.GetConsensus().hashDevnetGenesisBlock.IsNull() && !mapBlockIndex.empty() && mapBlockIndex.count(chainparams.GetConsensus().hashDevnetGenesisBlock) == 0)
                     return InitError(_("Incorrect or no devnet genesis block found. Wrong datadir for devnet specified?"));
 
-                // Check for changed -txindex state
-                if (fTxIndex != gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex to change -txindex");
-                    break;
-                }
-
-                // Check for changed -addressindex state
-                if (fAddressIndex != gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex to change -addressindex");
-                    break;
-                }
-
-                // Check for changed -timestampindex state
-                if (fTimestampIndex != gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex to change -timestampindex");
-                    break;
-                }
-
-                // Check for changed -spentindex state
-                if (fSpentIndex != gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
-                    strLoadError = _("You need to rebuild the database using -reindex to change -spentindex");
-                    break;
-                }
-
                 // Check for changed -prune state.  What we are concerned about is a user who has pruned blocks
                 // in the past, but is now trying to run unpruned.
                 if (fHavePruned && !fPruneMode) {
@@ -2205,6 +2284,44 @@ bool AppInitMain()
         return false;
     }
 
+    // ********************************************************* Step 7c: start indexers
+    // Earlier versions kept the indexes in the block tree database, an index moves its data out once it is started
+    for (const auto& legacy_index : {std::make_pair("txindex", DEFAULT_TXINDEX), std::make_pair("addressindex", DEFAULT_ADDRESSINDEX),
+                                     std::make_pair("spentindex", DEFAULT_SPENTINDEX), std::make_pair("timestampindex", DEFAULT_TIMESTAMPINDEX)}) {
+        bool fLegacyIndex = false;
+        if (!gArgs.GetBoolArg(std::string("-") + legacy_index.first, legacy_index.second) &&
+            pblocktree->ReadFlag(legacy_index.first, fLegacyIndex) && fLegacyIndex) {
+            LogPrintf("%s: blocks/index still holds %s data of an earlier version, start with -%s to move it or -reindex to remove it\n",
+                      __func__, legacy_index.first, legacy_index.first);
+        }
+    }
+
+    if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
+        g_txindex = MakeUnique<TxIndex>(nTxIndexCache, false, fReindex);
+        g_txindex->Start();
+    }
+    if (gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
+        g_addressindex = MakeUnique<AddressIndex>(nAddressIndexCache, false, fReindex);
+        g_addressindex->Start();
+    }
+    if (gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
+        g_spentindex = MakeUnique<SpentIndex>(nAddressIndexCache, false, fReindex);
+        g_spentindex->Start();
+    }
+    if (gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX)) {
+        g_timestampindex = MakeUnique<TimestampIndex>(nAddressIndexCache, false, fReindex);
+        g_timestampindex->Start();
+    }
+    if (gArgs.GetBoolArg("-tokenindex", DEFAULT_TOKENINDEX)) {
+        g_tokenindex = MakeUnique<TokenIndex>(nAddressIndexCache, false, fReindex);
+        g_tokenindex->Start();
+    }
+
+    for (const auto& filter_type : g_enabled_filter_types) {
+        InitBlockFilterIndex(filter_type, filter_index_cache, false, fReindex);
+        GetBlockFilterIndex(filter_type)->Start();
+    }
+
     fs::path est_path = GetDataDir() / FEE_ESTIMATES_FILENAME;
     CAutoFile est_filein(fsbridge::fopen(est_path, "rb"), SER_DISK, CLIENT_VERSION);
     // Allowed to fail as this file IS missing on first startup.
@@ -2314,17 +2431,21 @@ bool AppInitMain()
 
     strDBName = "governance.dat";
     uiInterface.InitMessage(_("Loading governance cache..."));
-    CFlatDB<CGovernanceManager> flatdb3(strDBName, "magicGovernanceCache");
+    governanceDb.reset(new CGovernanceDb(8 << 20, false, !fLoadCacheFiles || fDisableGovernance));
     if (fLoadCacheFiles && !fDisableGovernance) {
-        if(!flatdb3.Load(governance)) {
-            return InitError(_("Failed to load governance cache from") + "\n" + (pathDB / strDBName).string());
+        if (governanceDb->IsEmpty() && fs::exists(pathDB / strDBName)) {
+            // one-time migration of the old flat file into the governance database
+            CFlatDB<CGovernanceManager> flatdb3(strDBName, "magicGovernanceCache");
+            if (!flatdb3.Load(governance) || !governance.ImportToDb()) {
+                return InitError(_("Failed to load governance cache from") + "\n" + (pathDB / strDBName).string());
+            }
+            fs::remove(pathDB / strDBName);
+        } else if (!governance.LoadFromDb()) {
+            return InitError(_("Failed to load governance cache from") + "\n" + (pathDB / "governance").string());
         }
         governance.InitOnLoad();
     } else {
-        CGovernanceManager governanceTmp;
-        if(!flatdb3.Dump(governanceTmp)) {
-            return InitError(_("Failed to clear governance cache at") + "\n" + (pathDB / strDBName).string());
-        }
+        fs::remove(pathDB / strDBName);
     }
 
     strDBName = "netfulfilled.dat";
@@ -2349,6 +2470,7 @@ bool AppInitMain()
 
     if (!fDisableGovernance) {
         scheduler.scheduleEvery(std::bind(&CGovernanceManager::DoMaintenance, std::ref(governance), std::ref(*g_connman)), 60 * 5 * 1000);
+        scheduler.scheduleEvery(std::bind(&CGovernanceManager::ProcessPendingVotes, std::ref(governance), std::ref(*g_connman)), 100);
     }
 
     if (fMasternodeMode) {
@@ -2431,6 +2553,7 @@ bool AppInitMain()
     connOptions.nMaxOutbound = std::min(MAX_OUTBOUND_CONNECTIONS, connOptions.nMaxConnections);
     connOptions.nMaxAddnode = MAX_ADDNODE_CONNECTIONS;
     connOptions.nMaxFeeler = 1;
+    connOptions.nMsgHandlerThreads = gArgs.GetArg("-msghandlerthreads", DEFAULT_MSGHANDLER_THREADS);
     connOptions.nBestHeight = chain_active_height;
     connOptions.uiInterface = &uiInterface;
     connOptions.m_msgproc = peerLogic.get();
@@ -118,14 +118,59 @@ bool AccumulatorProofOfKnowledge:: Verify(const Accumulator& a, const CBigNum& v
 
     CBigNum c = CBigNum(hasher.GetHash()); //this hash should be of length k_prime bits
 
-    CBigNum st_1_prime = (valueOfCommitmentToCoin.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * sg.pow_mod(s_alpha, params->accumulatorPoKCommitmentGroup.modulus) * sh.pow_mod(s_phi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
-    CBigNum st_2_prime = (sg.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * ((valueOfCommitmentToCoin * sg.inverse(params->accumulatorPoKCommitmentGroup.modulus)).pow_mod(s_gamma, params->accumulatorPoKCommitmentGroup.modulus)) * sh.pow_mod(s_psi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
-    CBigNum st_3_prime = (sg.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * (sg * valueOfCommitmentToCoin).pow_mod(s_sigma, params->accumulatorPoKCommitmentGroup.modulus) * sh.pow_mod(s_xi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
-
-    CBigNum t_1_prime = (C_r.pow_mod(c, params->accumulatorModulus) * h_n.pow_mod(s_zeta, params->accumulatorModulus) * g_n.pow_mod(s_epsilon, params->accumulatorModulus)) % params->accumulatorModulus;
-    CBigNum t_2_prime = (C_e.pow_mod(c, params->accumulatorModulus) * h_n.pow_mod(s_eta, params->accumulatorModulus) * g_n.pow_mod(s_alpha, params->accumulatorModulus)) % params->accumulatorModulus;
-    CBigNum t_3_prime = ((a.getValue()).pow_mod(c, params->accumulatorModulus) * C_u.pow_mod(s_alpha, params->accumulatorModulus) * ((h_n.inverse(params->accumulatorModulus)).pow_mod(s_beta, params->accumulatorModulus))) % params->accumulatorModulus;
-    CBigNum t_4_prime = (C_r.pow_mod(s_alpha, params->accumulatorModulus) * ((h_n.inverse(params->accumulatorModulus)).pow_mod(s_delta, params->accumulatorModulus)) * ((g_n.inverse(params->accumulatorModulus)).pow_mod(s_beta, params->accumulatorModulus))) % params->accumulatorModulus;
+    const IntegerGroupParams& pokGroup = params->accumulatorPoKCommitmentGroup;
+    const IntegerGroupParams& qrnGroup = params->accumulatorQRNCommitmentGroup;
+    const CBigNum& pM = pokGroup.modulus;
+    const CBigNum& N = params->accumulatorModulus;
+    CBigNumCtx ctx;
+    CBigNum base, t;
+
+    // st_1' = C^c * sg^s_alpha * sh^s_phi
+    CBigNum st_1_prime;
+    ctx.pow_mod(st_1_prime, valueOfCommitmentToCoin, c, pM);
+    pokGroup.ghPowMod(t, s_alpha, s_phi, pM, ctx);
+    ctx.mul_mod(st_1_prime, st_1_prime, t, pM);
+
+    // st_2' = sg^c * (C * sg^-1)^s_gamma * sh^s_psi
+    CBigNum st_2_prime;
+    ctx.inverse(base, sg, pM);
+    ctx.mul_mod(base, valueOfCommitmentToCoin, base, pM);
+    ctx.pow_mod(st_2_prime, base, s_gamma, pM);
+    pokGroup.ghPowMod(t, c, s_psi, pM, ctx);
+    ctx.mul_mod(st_2_prime, st_2_prime, t, pM);
+
+    // st_3' = sg^c * (sg * C)^s_sigma * sh^s_xi
+    CBigNum st_3_prime;
+    ctx.mul_mod(base, sg, valueOfCommitmentToCoin, pM);
+    ctx.pow_mod(st_3_prime, base, s_sigma, pM);
+    pokGroup.ghPowMod(t, c, s_xi, pM, ctx);
+    ctx.mul_mod(st_3_prime, st_3_prime, t, pM);
+
+    // t_1' = C_r^c * h_n^s_zeta * g_n^s_epsilon
+    CBigNum t_1_prime;
+    ctx.pow_mod(t_1_prime, C_r, c, N);
+    qrnGroup.ghPowMod(t, s_epsilon, s_zeta, N, ctx);
+    ctx.mul_mod(t_1_prime, t_1_prime, t, N);
+
+    // t_2' = C_e^c * h_n^s_eta * g_n^s_alpha
+    CBigNum t_2_prime;
+    ctx.pow_mod(t_2_prime, C_e, c, N);
+    qrnGroup.ghPowMod(t, s_alpha, s_eta, N, ctx);
+    ctx.mul_mod(t_2_prime, t_2_prime, t, N);
+
+    // t_3' = A^c * C_u^s_alpha * (h_n^-1)^s_beta
+    CBigNum t_3_prime;
+    ctx.pow_mod(t_3_prime, a.getValue(), c, N);
+    ctx.pow_mod(t, C_u, s_alpha, N);
+    ctx.mul_mod(t_3_prime, t_3_prime, t, N);
+    qrnGroup.hPowMod(t, -s_beta, N, ctx);
+    ctx.mul_mod(t_3_prime, t_3_prime, t, N);
+
+    // t_4' = C_r^s_alpha * (h_n^-1)^s_delta * (g_n^-1)^s_beta
+    CBigNum t_4_prime;
+    ctx.pow_mod(t_4_prime, C_r, s_alpha, N);
+    qrnGroup.ghPowMod(t, -s_beta, -s_delta, N, ctx);
+    ctx.mul_mod(t_4_prime, t_4_prime, t, N);
 
     bool result_st1 = (st_1 == st_1_prime);
     bool result_st2 = (st_2 == st_2_prime);
@@ -123,15 +123,22 @@ bool CommitmentProofOfKnowledge::Verify(const CBigNum& A, const CBigNum& B) cons
         return false;
     }
 
+    CBigNumCtx ctx;
+    CBigNum t;
+
     // Compute T1 = g1^S1 * h1^S2 * inverse(A^{challenge}) mod p1
-    CBigNum T1 = A.pow_mod(this->challenge, ap->modulus).inverse(ap->modulus).mul_mod(
-                    (ap->g.pow_mod(S1, ap->modulus).mul_mod(ap->h.pow_mod(S2, ap->modulus), ap->modulus)),
-                    ap->modulus);
+    CBigNum T1;
+    ctx.pow_mod(T1, A, this->challenge, ap->modulus);
+    ctx.inverse(T1, T1, ap->modulus);
+    ap->ghPowMod(t, S1, S2, ap->modulus, ctx);
+    ctx.mul_mod(T1, T1, t, ap->modulus);
 
     // Compute T2 = g2^S1 * h2^S3 * inverse(B^{challenge}) mod p2
-    CBigNum T2 = B.pow_mod(this->challenge, bp->modulus).inverse(bp->modulus).mul_mod(
-                    (bp->g.pow_mod(S1, bp->modulus).mul_mod(bp->h.pow_mod(S3, bp->modulus), bp->modulus)),
-                    bp->modulus);
+    CBigNum T2;
+    ctx.pow_mod(T2, B, this->challenge, bp->modulus);
+    ctx.inverse(T2, T2, bp->modulus);
+    bp->ghPowMod(t, S1, S3, bp->modulus, ctx);
+    ctx.mul_mod(T2, T2, t, bp->modulus);
 
     // Hash T1 and T2 along with all of the public parameters
     CBigNum computedChallenge = calculateChallenge(A, B, T1, T2);
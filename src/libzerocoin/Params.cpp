@@ -34,7 +34,7 @@ AccumulatorAndProofParams::AccumulatorAndProofParams() {
     this->initialized = false;
 }
 
-IntegerGroupParams::IntegerGroupParams() {
+IntegerGroupParams::IntegerGroupParams() : fixedBaseTables(std::make_shared<FixedBaseTables>()) {
     this->initialized = false;
 }
 
@@ -45,4 +45,46 @@ CBigNum IntegerGroupParams::randomElement() const {
     return this->g.pow_mod(CBigNum::randBignum(this->groupOrder),this->modulus);
 }
 
+const IntegerGroupParams::FixedBaseTables* IntegerGroupParams::GetFixedBaseTables(const CBigNum& m) const {
+    FixedBaseTables* tables = this->fixedBaseTables.get();
+    std::call_once(tables->once, [&]() {
+        // Response values of the proofs exceed the modulus by the challenge and the
+        // statistical margin, twice its size covers all of them
+        const unsigned int nMaxExpBits = 2 * m.bitSize();
+        tables->g.reset(new CBigNumFixedBase(this->g, m, nMaxExpBits));
+        tables->h.reset(new CBigNumFixedBase(this->h, m, nMaxExpBits));
+    });
+    if (tables->g->getModulus() != m || tables->g->getBase() != this->g || tables->h->getBase() != this->h)
+        return nullptr;
+    return tables;
+}
+
+void IntegerGroupParams::gPowMod(CBigNum& r, const CBigNum& e, const CBigNum& m, CBigNumCtx& ctx) const {
+    const FixedBaseTables* tables = GetFixedBaseTables(m);
+    if (tables)
+        tables->g->pow_mod(r, e, ctx);
+    else
+        ctx.pow_mod(r, this->g, e, m);
+}
+
+void IntegerGroupParams::hPowMod(CBigNum& r, const CBigNum& e, const CBigNum& m, CBigNumCtx& ctx) const {
+    const FixedBaseTables* tables = GetFixedBaseTables(m);
+    if (tables)
+        tables->h->pow_mod(r, e, ctx);
+    else
+        ctx.pow_mod(r, this->h, e, m);
+}
+
+void IntegerGroupParams::ghPowMod(CBigNum& r, const CBigNum& e1, const CBigNum& e2, const CBigNum& m, CBigNumCtx& ctx) const {
+    const FixedBaseTables* tables = GetFixedBaseTables(m);
+    if (tables) {
+        tables->g->pow_mod2(r, e1, *tables->h, e2, ctx);
+        return;
+    }
+    CBigNum r2;
+    ctx.pow_mod(r2, this->h, e2, m);
+    ctx.pow_mod(r, this->g, e1, m);
+    ctx.mul_mod(r, r, r2, m);
+}
+
 } /* namespace libzerocoin */
@@ -17,6 +17,9 @@
 #include "bignum.h"
 #include "ZerocoinDefines.h"
 
+#include <memory>
+#include <mutex>
+
 namespace libzerocoin {
 
 class IntegerGroupParams {
@@ -32,6 +35,20 @@ public:
 	 * @return a random element in the group.
 	 */
 	CBigNum randomElement() const;
+
+	/**
+	 * Exponentiations of the generators, for verifiers. The powers of g and h
+	 * are precomputed on first use, for the modulus of that first call, and
+	 * other moduli fall back to a plain exponentiation. Not constant time.
+	 * @param r the result, may alias an exponent
+	 * @param m the modulus, which is not necessarily the modulus of the group
+	 */
+	void gPowMod(CBigNum& r, const CBigNum& e, const CBigNum& m, CBigNumCtx& ctx) const;
+	void hPowMod(CBigNum& r, const CBigNum& e, const CBigNum& m, CBigNumCtx& ctx) const;
+
+	/** r = g^e1 * h^e2 mod m */
+	void ghPowMod(CBigNum& r, const CBigNum& e1, const CBigNum& e2, const CBigNum& m, CBigNumCtx& ctx) const;
+
 	bool initialized;
 
 	/**
@@ -66,6 +83,19 @@ public:
 		    READWRITE(modulus);
 		    READWRITE(groupOrder);
 	}
+
+private:
+	struct FixedBaseTables {
+		std::once_flag once;
+		std::unique_ptr<CBigNumFixedBase> g;
+		std::unique_ptr<CBigNumFixedBase> h;
+	};
+
+	/** Shared by copies, which are checked against their own g, h and modulus before use */
+	std::shared_ptr<FixedBaseTables> fixedBaseTables;
+
+	/** The tables for modulus m, or nullptr if they were built for another group */
+	const FixedBaseTables* GetFixedBaseTables(const CBigNum& m) const;
 };
 
 class AccumulatorAndProofParams {
@@ -122,12 +122,18 @@ inline CBigNum SerialNumberSignatureOfKnowledge::challengeCalculation(const CBig
     return (g.pow_mod(exponent, params->serialNumberSoKCommitmentGroup.modulus) * h.pow_mod(h_exp, params->serialNumberSoKCommitmentGroup.modulus)) % params->serialNumberSoKCommitmentGroup.modulus;
 }
 
+// The verifier's version, with the generators raised through their precomputed powers
+void SerialNumberSignatureOfKnowledge::challengeCalculation(CBigNum& r, const CBigNum& a_exp, const CBigNum& b_exp,
+        const CBigNum& h_exp, CBigNumCtx& ctx) const {
+    const IntegerGroupParams& sokGroup = params->serialNumberSoKCommitmentGroup;
+
+    params->coinCommitmentGroup.ghPowMod(r, a_exp, b_exp, sokGroup.groupOrder, ctx);
+    sokGroup.ghPowMod(r, r, h_exp, sokGroup.modulus, ctx);
+}
+
 bool SerialNumberSignatureOfKnowledge::Verify(const CBigNum& coinSerialNumber, const CBigNum& valueOfCommitmentToCoin,
         const uint256 msghash, bool isInParamsValidationRange) const {
-    CBigNum a = params->coinCommitmentGroup.g;
-    CBigNum b = params->coinCommitmentGroup.h;
-    CBigNum g = params->serialNumberSoKCommitmentGroup.g;
-    CBigNum h = params->serialNumberSoKCommitmentGroup.h;
+    const IntegerGroupParams& sokGroup = params->serialNumberSoKCommitmentGroup;
 
     //// Params validation.
     if(isInParamsValidationRange) {
@@ -148,22 +154,23 @@ bool SerialNumberSignatureOfKnowledge::Verify(const CBigNum& coinSerialNumber, c
     unsigned char *hashbytes = (unsigned char*) &this->hash;
 
     try {
+        CBigNumCtx ctx;
+        CBigNum exp, t;
         for (uint32_t i = 0; i < params->zkp_iterations; i++) {
             int bit = i % 8;
             int byte = i / 8;
             bool challenge_bit = ((hashbytes[byte] >> bit) & 0x01);
             if (challenge_bit) {
                 CBigNum bn = SeedTo1024(sprime[i].getuint256());
-                if (bn > params->serialNumberSoKCommitmentGroup.groupOrder && isInParamsValidationRange)
+                if (bn > sokGroup.groupOrder && isInParamsValidationRange)
                     return error("SoK Verify() :: sprime in pos %d not in valid range", i);
-                tprime[i] = challengeCalculation(coinSerialNumber, s_notprime[i], bn);
+                challengeCalculation(tprime[i], coinSerialNumber, s_notprime[i], bn, ctx);
             } else {
-                CBigNum exp = b.pow_mod(s_notprime[i], params->serialNumberSoKCommitmentGroup.groupOrder);
-                tprime[i] = ((valueOfCommitmentToCoin.pow_mod(exp, params->serialNumberSoKCommitmentGroup.modulus) %
-                              params->serialNumberSoKCommitmentGroup.modulus) *
-                             (h.pow_mod(sprime[i], params->serialNumberSoKCommitmentGroup.modulus) %
-                              params->serialNumberSoKCommitmentGroup.modulus)) %
-                            params->serialNumberSoKCommitmentGroup.modulus;
+                // commitment^(b^s) * h^s' mod p2
+                params->coinCommitmentGroup.hPowMod(exp, s_notprime[i], sokGroup.groupOrder, ctx);
+                ctx.pow_mod(tprime[i], valueOfCommitmentToCoin, exp, sokGroup.modulus);
+                sokGroup.hPowMod(t, sprime[i], sokGroup.modulus, ctx);
+                ctx.mul_mod(tprime[i], tprime[i], t, sokGroup.modulus);
             }
         }
         for (uint32_t i = 0; i < params->zkp_iterations; i++) {
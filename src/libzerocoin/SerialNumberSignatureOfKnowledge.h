@@ -70,6 +70,8 @@ private:
     std::vector<CBigNum> sprime;
     inline CBigNum challengeCalculation(const CBigNum& a_exp, const CBigNum& b_exp,
                                        const CBigNum& h_exp) const;
+    void challengeCalculation(CBigNum& r, const CBigNum& a_exp, const CBigNum& b_exp,
+                              const CBigNum& h_exp, CBigNumCtx& ctx) const;
 };
 
 } /* namespace libzerocoin */
@@ -36,6 +36,9 @@ class CBigNum
 {
 #if defined(USE_NUM_GMP)
     mpz_t bn;
+
+    friend class CBigNumCtx;
+    friend class CBigNumFixedBase;
 #endif
 public:
     CBigNum();
@@ -249,6 +252,69 @@ inline bool operator<=(const CBigNum& a, const CBigNum& b) { return (mpz_cmp(a.b
 inline bool operator>=(const CBigNum& a, const CBigNum& b) { return (mpz_cmp(a.bn, b.bn) >= 0); }
 inline bool operator<(const CBigNum& a, const CBigNum& b)  { return (mpz_cmp(a.bn, b.bn) < 0); }
 inline bool operator>(const CBigNum& a, const CBigNum& b)  { return (mpz_cmp(a.bn, b.bn) > 0); }
+
+/**
+ * Scratch space for modular arithmetic on public values, as used when verifying proofs.
+ * Results are written to the first argument, which may alias an operand, and products are
+ * formed in preallocated temporaries, so once the limbs of the results have grown to the
+ * size of the modulus the operations no longer allocate.
+ * Exponentiations are not constant time: never use them with secret exponents.
+ * A context must not be shared between threads.
+ */
+class CBigNumCtx
+{
+    friend class CBigNumFixedBase;
+
+    mpz_t t;
+    mpz_t acc;
+    std::vector<unsigned char> vDigits;
+
+public:
+    CBigNumCtx();
+    ~CBigNumCtx();
+    CBigNumCtx(const CBigNumCtx&) = delete;
+    CBigNumCtx& operator=(const CBigNumCtx&) = delete;
+
+    /** r = a * b mod m */
+    void mul_mod(CBigNum& r, const CBigNum& a, const CBigNum& b, const CBigNum& m);
+
+    /** r = b^e mod m, 0 if e is negative and b is not invertible */
+    void pow_mod(CBigNum& r, const CBigNum& b, const CBigNum& e, const CBigNum& m);
+
+    /** r = a^-1 mod m, or 0 if a is not invertible */
+    void inverse(CBigNum& r, const CBigNum& a, const CBigNum& m);
+};
+
+/**
+ * Powers base^(16^i) mod m of a base that is raised to many exponents over the same modulus,
+ * such as the generators of the zerocoin groups. An exponentiation then takes one modular
+ * multiplication per nonzero 4-bit digit of the exponent plus 15, instead of a squaring per
+ * bit (Yao's method). Two bases over the same modulus share the 15 final multiplications.
+ * Exponents longer than the table fall back to a plain exponentiation.
+ * Not constant time: never use with secret exponents.
+ */
+class CBigNumFixedBase
+{
+    CBigNum base;
+    CBigNum modulus;
+    std::vector<CBigNum> vPowers;
+
+    /** r = product of bases[k]^|exps[k]| mod m. Returns false if an exponent is longer than its table. */
+    static bool MultiPowMod(mpz_ptr r, const CBigNumFixedBase* const* bases, const CBigNum* const* exps, size_t n, CBigNumCtx& ctx);
+
+public:
+    /** Precompute the powers for exponents of up to nMaxExpBits bits */
+    CBigNumFixedBase(const CBigNum& baseIn, const CBigNum& modulusIn, unsigned int nMaxExpBits);
+
+    const CBigNum& getBase() const { return base; }
+    const CBigNum& getModulus() const { return modulus; }
+
+    /** r = base^e mod modulus */
+    void pow_mod(CBigNum& r, const CBigNum& e, CBigNumCtx& ctx) const;
+
+    /** r = base^e1 * other.base^e2 mod modulus, other must use the same modulus */
+    void pow_mod2(CBigNum& r, const CBigNum& e1, const CBigNumFixedBase& other, const CBigNum& e2, CBigNumCtx& ctx) const;
+};
 #endif
 
 inline std::ostream& operator<<(std::ostream &strm, const CBigNum &b) { return strm << b.ToString(10); }
@@ -6,6 +6,8 @@
 
 #include "bignum.h"
 
+#include <algorithm>
+
 /** C++ wrapper for BIGNUM (Gmp bignum) */
 CBigNum::CBigNum()
 {
@@ -350,3 +352,145 @@ CBigNum& CBigNum::operator--()
     mpz_sub(bn, bn, CBigNum(1).bn);
     return *this;
 }
+
+CBigNumCtx::CBigNumCtx()
+{
+    mpz_init(t);
+    mpz_init(acc);
+}
+
+CBigNumCtx::~CBigNumCtx()
+{
+    mpz_clear(t);
+    mpz_clear(acc);
+}
+
+void CBigNumCtx::mul_mod(CBigNum& r, const CBigNum& a, const CBigNum& b, const CBigNum& m)
+{
+    mpz_mul(t, a.bn, b.bn);
+    mpz_mod(r.bn, t, m.bn);
+}
+
+void CBigNumCtx::pow_mod(CBigNum& r, const CBigNum& b, const CBigNum& e, const CBigNum& m)
+{
+    // mpz_powm reduces with Montgomery multiplication for odd moduli. It raises a division by
+    // zero for a negative exponent of a base without inverse, so that case is handled here.
+    if (mpz_sgn(e.bn) < 0) {
+        if (!mpz_invert(t, b.bn, m.bn)) {
+            mpz_set_ui(r.bn, 0);
+            return;
+        }
+        mpz_neg(acc, e.bn);
+        mpz_powm(r.bn, t, acc, m.bn);
+        return;
+    }
+    mpz_powm(r.bn, b.bn, e.bn, m.bn);
+}
+
+void CBigNumCtx::inverse(CBigNum& r, const CBigNum& a, const CBigNum& m)
+{
+    if (!mpz_invert(r.bn, a.bn, m.bn))
+        mpz_set_ui(r.bn, 0);
+}
+
+static_assert(GMP_NUMB_BITS % 4 == 0, "4-bit exponent digits must not straddle limbs");
+
+/** The i-th 4-bit digit of the magnitude of e */
+static inline unsigned char GetExpDigit(mpz_srcptr e, size_t i)
+{
+    const size_t nBit = i * 4;
+    return (mpz_getlimbn(e, nBit / GMP_NUMB_BITS) >> (nBit % GMP_NUMB_BITS)) & 0xF;
+}
+
+CBigNumFixedBase::CBigNumFixedBase(const CBigNum& baseIn, const CBigNum& modulusIn, unsigned int nMaxExpBits) :
+    base(baseIn), modulus(modulusIn), vPowers((nMaxExpBits + 3) / 4)
+{
+    if (vPowers.empty())
+        return;
+    mpz_mod(vPowers[0].bn, base.bn, modulus.bn);
+    for (size_t i = 1; i < vPowers.size(); i++)
+        mpz_powm_ui(vPowers[i].bn, vPowers[i - 1].bn, 16, modulus.bn);
+}
+
+bool CBigNumFixedBase::MultiPowMod(mpz_ptr r, const CBigNumFixedBase* const* bases, const CBigNum* const* exps, size_t n, CBigNumCtx& ctx)
+{
+    mpz_srcptr m = bases[0]->modulus.bn;
+
+    size_t nMaxDigits = 0;
+    for (size_t k = 0; k < n; k++) {
+        const size_t nDigits = (mpz_sizeinbase(exps[k]->bn, 2) + 3) / 4;
+        if (nDigits > bases[k]->vPowers.size())
+            return false;
+        nMaxDigits = std::max(nMaxDigits, nDigits);
+    }
+
+    // Read all digits first, r may alias an exponent
+    ctx.vDigits.assign(n * nMaxDigits, 0);
+    for (size_t k = 0; k < n; k++) {
+        for (size_t i = 0; i < nMaxDigits; i++)
+            ctx.vDigits[k * nMaxDigits + i] = GetExpDigit(exps[k]->bn, i);
+    }
+
+    // For d = 15..1, acc is the product of the powers whose digit is at least d, and r collects
+    // acc once for every d, so each power ends up raised to its digit.
+    bool fAccOne = true, fResultOne = true;
+    mpz_set_ui(ctx.acc, 1);
+    for (unsigned char d = 15; d > 0; d--) {
+        for (size_t k = 0; k < n; k++) {
+            const unsigned char* digits = &ctx.vDigits[k * nMaxDigits];
+            for (size_t i = 0; i < nMaxDigits; i++) {
+                if (digits[i] != d)
+                    continue;
+                mpz_mul(ctx.t, ctx.acc, bases[k]->vPowers[i].bn);
+                mpz_mod(ctx.acc, ctx.t, m);
+                fAccOne = false;
+            }
+        }
+        if (fAccOne)
+            continue;
+        if (fResultOne) {
+            mpz_set(r, ctx.acc);
+            fResultOne = false;
+        } else {
+            mpz_mul(ctx.t, r, ctx.acc);
+            mpz_mod(r, ctx.t, m);
+        }
+    }
+    if (fResultOne)
+        mpz_set_ui(r, 1);
+    return true;
+}
+
+void CBigNumFixedBase::pow_mod(CBigNum& r, const CBigNum& e, CBigNumCtx& ctx) const
+{
+    const CBigNumFixedBase* bases[] = {this};
+    const CBigNum* exps[] = {&e};
+    const bool fNegative = mpz_sgn(e.bn) < 0;
+    if (!MultiPowMod(r.bn, bases, exps, 1, ctx)) {
+        ctx.pow_mod(r, base, e, modulus);
+        return;
+    }
+    if (fNegative && !mpz_invert(r.bn, r.bn, modulus.bn))
+        mpz_set_ui(r.bn, 0);
+}
+
+void CBigNumFixedBase::pow_mod2(CBigNum& r, const CBigNum& e1, const CBigNumFixedBase& other, const CBigNum& e2, CBigNumCtx& ctx) const
+{
+    const bool fNegative1 = mpz_sgn(e1.bn) < 0;
+    const bool fNegative2 = mpz_sgn(e2.bn) < 0;
+    if (fNegative1 == fNegative2) {
+        const CBigNumFixedBase* bases[] = {this, &other};
+        const CBigNum* exps[] = {&e1, &e2};
+        if (MultiPowMod(r.bn, bases, exps, 2, ctx)) {
+            if (fNegative1 && !mpz_invert(r.bn, r.bn, modulus.bn))
+                mpz_set_ui(r.bn, 0);
+            return;
+        }
+    }
+
+    // Exponents of opposite sign, or too long for a table
+    CBigNum r2;
+    other.pow_mod(r2, e2, ctx);
+    pow_mod(r, e1, ctx);
+    ctx.mul_mod(r, r, r2, modulus);
+}
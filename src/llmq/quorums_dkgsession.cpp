@@ -360,58 +360,94 @@ void CDKGSession::ReceiveMessage(const CDKGContribution& qc, bool& retBan)
 // The resulting aggregated vvec is then used to recover a public key share
 // The public key share must match the public key belonging to the aggregated secret key contributions
 // See CBLSWorker::VerifyContributionShares for more details.
+// The batch is verified asynchronously by CDKGSessionManager, which interleaves the verifications of all running
+// sessions by their deadline. The results are handled in ProcessContributionVerifications.
 void CDKGSession::VerifyPendingContributions()
 {
     AssertLockHeld(cs_pending);
 
     CDKGLogger logger(*this, __func__);
 
-    cxxtimer::Timer t1(true);
-
     std::vector<size_t> pend = std::move(pendingContributionVerifications);
     if (pend.empty()) {
+        ProcessContributionVerifications(false);
         return;
     }
 
-    std::vector<size_t> memberIndexes;
+    ContributionVerification verification;
     std::vector<BLSVerificationVectorPtr> vvecs;
-    BLSSecretKeyVector skContributions;
 
     for (const auto& idx : pend) {
         auto& m = members[idx];
         if (m->bad || m->weComplain) {
             continue;
         }
-        memberIndexes.emplace_back(idx);
+        verification.memberIndexes.emplace_back(idx);
         vvecs.emplace_back(receivedVvecs[idx]);
-        skContributions.emplace_back(receivedSkContributions[idx]);
+        verification.skContributions.emplace_back(receivedSkContributions[idx]);
         // Write here to definitely store one contribution for each member no matter if
         // our share is valid or not, could be that others are still correct
         dkgManager.WriteEncryptedContributions(params.type, pindexQuorum, m->dmn->proTxHash, *vecEncryptedContributions[idx]);
     }
-
-    auto result = blsWorker.VerifyContributionShares(myId, vvecs, skContributions);
-    if (result.size() != memberIndexes.size()) {
-        logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), memberIndexes.size());
+    if (verification.memberIndexes.empty()) {
+        ProcessContributionVerifications(false);
         return;
     }
 
-    for (size_t i = 0; i < memberIndexes.size(); i++) {
-        if (!result[i]) {
-            auto& m = members[memberIndexes[i]];
-            logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
-            m->weComplain = true;
-            quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
-                status.weComplain = true;
-                return true;
-            });
-        } else {
-            size_t memberIdx = memberIndexes[i];
-            dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, members[memberIdx]->dmn->proTxHash, skContributions[i]);
+    // all contributions must be verified before we start complaining
+    int nDeadline = pindexQuorum->nHeight + (QuorumPhase_Complain - QuorumPhase_Initialized) * params.dkgPhaseBlocks;
+    verification.result = dkgManager.AsyncVerifyContributionShares(nDeadline, myId, vvecs, verification.skContributions);
+    contributionVerificationsInProgress.emplace_back(std::move(verification));
+
+    logger.Batch("scheduled verification of %d pending contributions", pend.size());
+
+    ProcessContributionVerifications(false);
+}
+
+// Handles the results of finished contribution verifications. If fWait is true, waits for all verifications in progress
+void CDKGSession::ProcessContributionVerifications(bool fWait)
+{
+    AssertLockHeld(cs_pending);
+
+    CDKGLogger logger(*this, __func__);
+
+    cxxtimer::Timer t1(true);
+
+    size_t verifiedCount = 0;
+    for (auto it = contributionVerificationsInProgress.begin(); it != contributionVerificationsInProgress.end(); ) {
+        auto& verification = *it;
+        if (!fWait && verification.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
         }
+
+        auto result = verification.result.get();
+        if (result.size() != verification.memberIndexes.size()) {
+            logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), verification.memberIndexes.size());
+            it = contributionVerificationsInProgress.erase(it);
+            continue;
+        }
+
+        for (size_t i = 0; i < verification.memberIndexes.size(); i++) {
+            auto& m = members[verification.memberIndexes[i]];
+            if (!result[i]) {
+                logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
+                m->weComplain = true;
+                quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
+                    status.weComplain = true;
+                    return true;
+                });
+            } else {
+                dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, m->dmn->proTxHash, verification.skContributions[i]);
+            }
+        }
+        verifiedCount += verification.memberIndexes.size();
+        it = contributionVerificationsInProgress.erase(it);
     }
 
-    logger.Batch("verified %d pending contributions. time=%d", pend.size(), t1.count());
+    if (verifiedCount != 0) {
+        logger.Batch("verified %d contributions. time=%d", verifiedCount, t1.count());
+    }
 }
 
 void CDKGSession::VerifyAndComplain(CDKGPendingMessages& pendingMessages)
@@ -423,6 +459,7 @@ void CDKGSession::VerifyAndComplain(CDKGPendingMessages& pendingMessages)
     {
         LOCK(cs_pending);
         VerifyPendingContributions();
+        ProcessContributionVerifications(true);
     }
 
     CDKGLogger logger(*this, __func__);
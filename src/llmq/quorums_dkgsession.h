@@ -279,8 +279,16 @@ private:
     std::map<uint256, CDKGJustification> justifications;
     std::map<uint256, CDKGPrematureCommitment> prematureCommitments;
 
+    struct ContributionVerification {
+        std::vector<size_t> memberIndexes;
+        BLSSecretKeyVector skContributions;
+        std::future<std::vector<bool>> result;
+    };
+
     mutable CCriticalSection cs_pending;
     std::vector<size_t> pendingContributionVerifications;
+    // batches which were handed to CDKGSessionManager for verification but whose results were not processed yet
+    std::list<ContributionVerification> contributionVerificationsInProgress;
 
     // filled by ReceivePrematureCommitment and used by FinalizeCommitments
     std::set<uint256> validCommitments;
@@ -312,6 +320,7 @@ public:
     bool PreVerifyMessage(const CDKGContribution& qc, bool& retBan) const;
     void ReceiveMessage(const CDKGContribution& qc, bool& retBan);
     void VerifyPendingContributions();
+    void ProcessContributionVerifications(bool fWait);
 
     // Phase 2: complaint
     void VerifyAndComplain(CDKGPendingMessages& pendingMessages);
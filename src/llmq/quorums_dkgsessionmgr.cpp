@@ -22,7 +22,8 @@ static const std::string DB_ENC_CONTRIB = "qdkg_E";
 
 CDKGSessionManager::CDKGSessionManager(CDBWrapper& _llmqDb, CBLSWorker& _blsWorker) :
     llmqDb(_llmqDb),
-    blsWorker(_blsWorker)
+    blsWorker(_blsWorker),
+    verificationScheduler(_blsWorker)
 {
     for (const auto& qt : Params().GetConsensus().llmqs) {
         dkgSessionHandlers.emplace(std::piecewise_construct,
@@ -195,6 +196,13 @@ bool CDKGSessionManager::GetPrematureCommitment(const uint256& hash, CDKGPrematu
     return false;
 }
 
+std::future<std::vector<bool>> CDKGSessionManager::AsyncVerifyContributionShares(int nDeadline, const CBLSId& forId,
+                                                                                const std::vector<BLSVerificationVectorPtr>& vvecs,
+                                                                                const BLSSecretKeyVector& skShares)
+{
+    return verificationScheduler.AsyncVerifyContributionShares(nDeadline, forId, vvecs, skShares);
+}
+
 void CDKGSessionManager::WriteVerifiedVvecContribution(Consensus::LLMQType llmqType, const CBlockIndex* pindexQuorum, const uint256& proTxHash, const BLSVerificationVectorPtr& vvec)
 {
     llmqDb.Write(std::make_tuple(DB_VVEC, llmqType, pindexQuorum->GetBlockHash(), proTxHash), *vvec);
@@ -288,6 +296,65 @@ void CDKGSessionManager::CleanupCache()
     }
 }
 
+std::future<std::vector<bool>> CDKGVerificationScheduler::AsyncVerifyContributionShares(int nDeadline, const CBLSId& forId,
+                                                                                        const std::vector<BLSVerificationVectorPtr>& vvecs,
+                                                                                        const BLSSecretKeyVector& skShares)
+{
+    if (vvecs.empty()) {
+        // the worker would never call back for an empty batch
+        std::promise<std::vector<bool>> p;
+        p.set_value({});
+        return p.get_future();
+    }
+
+    // the worker only keeps references to the inputs, so the job owns copies of them until it's done
+    auto job = std::make_shared<Job>();
+    job->forId = forId;
+    job->vvecs = vvecs;
+    job->skShares = skShares;
+    auto future = job->promise.get_future();
+
+    {
+        std::unique_lock<std::mutex> l(cs);
+        jobQueue.emplace(std::make_pair(nDeadline, nNextSequence++), std::move(job));
+    }
+    StartJobs();
+
+    return future;
+}
+
+void CDKGVerificationScheduler::StartJobs()
+{
+    while (true) {
+        JobPtr job;
+        {
+            std::unique_lock<std::mutex> l(cs);
+            if (jobQueue.empty() || nJobsInProgress >= MAX_JOBS_IN_PROGRESS) {
+                return;
+            }
+            job = std::move(jobQueue.begin()->second);
+            jobQueue.erase(jobQueue.begin());
+            nJobsInProgress++;
+        }
+
+        // the done callback might be called right away (e.g. for invalid inputs), so this must happen without holding cs
+        blsWorker.AsyncVerifyContributionShares(job->forId, job->vvecs, job->skShares, true, true, [this, job](const std::vector<bool>& result) {
+            JobDone(job, result);
+        });
+    }
+}
+
+void CDKGVerificationScheduler::JobDone(const JobPtr& job, const std::vector<bool>& result)
+{
+    {
+        std::unique_lock<std::mutex> l(cs);
+        nJobsInProgress--;
+    }
+    StartJobs();
+    // must come last, the scheduler might be gone once the caller got all its results
+    job->promise.set_value(result);
+}
+
 bool IsQuorumDKGEnabled()
 {
     return sporkManager.IsSporkActive(SPORK_17_QUORUM_DKG_ENABLED);
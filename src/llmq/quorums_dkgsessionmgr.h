@@ -11,11 +11,56 @@
 
 #include <ctpl.h>
 
+#include <future>
+#include <mutex>
+
 class UniValue;
 
 namespace llmq
 {
 
+/**
+ * Verifies the secret key contributions of all concurrently running DKG sessions on the shared BLS worker.
+ *
+ * Without this, every phase handler thread pushes its verifications directly into the worker pool, which is processed
+ * in FIFO order. The verification of a large quorum then occupies the whole pool while a smaller session with an
+ * earlier deadline waits behind it. Jobs are instead queued here and started in order of their phase deadline (the
+ * height at which the complain phase of the session begins), with only a few jobs handed to the worker at once.
+ */
+class CDKGVerificationScheduler
+{
+    // Every job is parallelized by the worker itself, the second one only keeps the pool busy while the first finishes
+    static const size_t MAX_JOBS_IN_PROGRESS = 2;
+
+private:
+    struct Job {
+        CBLSId forId;
+        std::vector<BLSVerificationVectorPtr> vvecs;
+        BLSSecretKeyVector skShares;
+        std::promise<std::vector<bool>> promise;
+    };
+    typedef std::shared_ptr<Job> JobPtr;
+
+    CBLSWorker& blsWorker;
+
+    std::mutex cs;
+    // ordered by deadline first, the sequence number keeps jobs with the same deadline in FIFO order
+    std::map<std::pair<int, uint64_t>, JobPtr> jobQueue;
+    uint64_t nNextSequence{0};
+    size_t nJobsInProgress{0};
+
+public:
+    explicit CDKGVerificationScheduler(CBLSWorker& _blsWorker) : blsWorker(_blsWorker) {}
+
+    std::future<std::vector<bool>> AsyncVerifyContributionShares(int nDeadline, const CBLSId& forId,
+                                                                 const std::vector<BLSVerificationVectorPtr>& vvecs,
+                                                                 const BLSSecretKeyVector& skShares);
+
+private:
+    void StartJobs();
+    void JobDone(const JobPtr& job, const std::vector<bool>& result);
+};
+
 class CDKGSessionManager
 {
     static const int64_t MAX_CONTRIBUTION_CACHE_TIME = 60 * 1000;
@@ -23,6 +68,7 @@ class CDKGSessionManager
 private:
     CDBWrapper& llmqDb;
     CBLSWorker& blsWorker;
+    CDKGVerificationScheduler verificationScheduler;
 
     std::map<Consensus::LLMQType, CDKGSessionHandler> dkgSessionHandlers;
 
@@ -61,6 +107,11 @@ public:
     bool GetJustification(const uint256& hash, CDKGJustification& ret) const;
     bool GetPrematureCommitment(const uint256& hash, CDKGPrematureCommitment& ret) const;
 
+    // Contribution verification of all sessions is scheduled by the deadline of the session's contribution phase
+    std::future<std::vector<bool>> AsyncVerifyContributionShares(int nDeadline, const CBLSId& forId,
+                                                                 const std::vector<BLSVerificationVectorPtr>& vvecs,
+                                                                 const BLSSecretKeyVector& skShares);
+
     // Contributions are written while in the DKG
     void WriteVerifiedVvecContribution(Consensus::LLMQType llmqType, const CBlockIndex* pindexQuorum, const uint256& proTxHash, const BLSVerificationVectorPtr& vvec);
     void WriteVerifiedSkContribution(Consensus::LLMQType llmqType, const CBlockIndex* pindexQuorum, const uint256& proTxHash, const CBLSSecretKey& skContribution);
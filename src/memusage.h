@@ -6,6 +6,8 @@
 #define BITCOIN_MEMUSAGE_H
 
 #include <indirectmap.h>
+#include <prevector.h>
+#include <support/allocators/pool.h>
 
 #include <stdlib.h>
 
@@ -165,6 +167,22 @@ static inline size_t DynamicUsage(const std::unordered_map<X, Y, Z>& m)
     return MallocUsage(sizeof(unordered_node<std::pair<const X, Y> >)) * m.size() + MallocUsage(sizeof(void*) * m.bucket_count());
 }
 
+/**
+ * A map on a PoolResource owns all of the resource's chunks, whether the blocks in them hold nodes
+ * or small bucket arrays. Blocks on a free list are not counted, as the map reuses them before the
+ * resource takes another chunk. Bucket arrays too large for the pool come from malloc.
+ * The chunks are kept in a std::list, whose nodes hold two links and the chunk pointer.
+ */
+template<typename X, typename Y, typename Z, typename P, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+static inline size_t DynamicUsage(const std::unordered_map<X, Y, Z, P, PoolAllocator<std::pair<const X, Y>, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES> >& m)
+{
+    const auto* resource = m.get_allocator().resource();
+    size_t usage_chunks = (MallocUsage(sizeof(void*) * 3) + MallocUsage(resource->ChunkSizeBytes())) * resource->NumAllocatedChunks() - resource->NumFreeListBytes();
+    size_t bucket_bytes = sizeof(void*) * m.bucket_count();
+    size_t usage_buckets = bucket_bytes > MAX_BLOCK_SIZE_BYTES ? MallocUsage(bucket_bytes) : 0;
+    return usage_chunks + usage_buckets;
+}
+
 }
 
 #endif // BITCOIN_MEMUSAGE_H
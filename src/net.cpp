@@ -795,6 +795,7 @@ void CNode::copyStats(CNodeStats &stats)
     {
         LOCK(cs_vRecv);
         X(mapRecvBytesPerMsgCmd);
+        X(mapProcessTimePerMsgCmd);
         X(nRecvBytes);
     }
     X(fWhitelisted);
@@ -882,6 +883,30 @@ bool CNode::ReceiveMsgBytes(const char *pch, unsigned int nBytes, bool& complete
     return true;
 }
 
+void CMsgProcessTime::Add(int64_t nUsec)
+{
+    nCount++;
+    nTotalUsec += nUsec;
+    nMaxUsec = std::max(nMaxUsec, nUsec);
+
+    int nBucket = 0;
+    while (nBucket < BUCKETS - 1 && (int64_t{1} << nBucket) <= nUsec) {
+        nBucket++;
+    }
+    vBuckets[nBucket]++;
+}
+
+void CNode::RecordProcessTime(const std::string& strCommand, int64_t nUsec)
+{
+    LOCK(cs_vRecv);
+    // to prevent a memory DOS, only keep separate stats for valid commands
+    if (mapRecvBytesPerMsgCmd.count(strCommand)) {
+        mapProcessTimePerMsgCmd[strCommand].Add(nUsec);
+    } else {
+        mapProcessTimePerMsgCmd[NET_MESSAGE_COMMAND_OTHER].Add(nUsec);
+    }
+}
+
 void CNode::SetSendVersion(int nVersionIn)
 {
     // Send version may only be changed in the version message, and
@@ -2042,9 +2067,9 @@ void CConnman::WakeMessageHandler()
 {
     {
         std::lock_guard<std::mutex> lock(mutexMsgProc);
-        fMsgProcWake = true;
+        vMsgProcWake.assign(vMsgProcWake.size(), true);
     }
-    condMsgProc.notify_one();
+    condMsgProc.notify_all();
 }
 
 void CConnman::WakeSelect()
@@ -2851,7 +2876,7 @@ void CConnman::OpenMasternodeConnection(const CAddress &addrConnect, bool probe)
     OpenNetworkConnection(addrConnect, false, nullptr, nullptr, false, false, false, true, probe);
 }
 
-void CConnman::ThreadMessageHandler()
+void CConnman::ThreadMessageHandler(int nShard)
 {
     int64_t nLastSendMessagesTimeMasternodes = 0;
 
@@ -2872,6 +2897,10 @@ void CConnman::ThreadMessageHandler()
             if (pnode->fDisconnect)
                 continue;
 
+            // every peer is handled by a single thread, so per-peer state needs no extra locking
+            if (pnode->GetId() % nMsgHandlerThreads != nShard)
+                continue;
+
             // Receive messages
             bool fMoreNodeWork = m_msgproc->ProcessMessages(pnode, flagInterruptMsgProc);
             fMoreWork |= (fMoreNodeWork && !pnode->fPauseSend);
@@ -2891,9 +2920,9 @@ void CConnman::ThreadMessageHandler()
 
         std::unique_lock<std::mutex> lock(mutexMsgProc);
         if (!fMoreWork) {
-            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this] { return fMsgProcWake; });
+            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this, nShard] { return vMsgProcWake[nShard]; });
         }
-        fMsgProcWake = false;
+        vMsgProcWake[nShard] = false;
     }
 }
 
@@ -3226,7 +3255,7 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
 
     {
         std::unique_lock<std::mutex> lock(mutexMsgProc);
-        fMsgProcWake = false;
+        vMsgProcWake.assign(nMsgHandlerThreads, false);
     }
 
 #ifdef USE_WAKEUP_PIPE
@@ -3296,7 +3325,10 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     threadOpenMasternodeConnections = std::thread(&TraceThread<std::function<void()> >, "mncon", std::function<void()>(std::bind(&CConnman::ThreadOpenMasternodeConnections, this)));
 
     // Process messages
-    threadMessageHandler = std::thread(&TraceThread<std::function<void()> >, "msghand", std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this)));
+    for (int i = 0; i < nMsgHandlerThreads; i++) {
+        std::string strThreadName = i == 0 ? "msghand" : strprintf("msghand.%d", i);
+        threadMessageHandlers.emplace_back(&TraceThread<std::function<void()> >, strThreadName, std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this, i)));
+    }
 
     // Dump network addresses
     scheduler.scheduleEvery(std::bind(&CConnman::DumpData, this), DUMP_ADDRESSES_INTERVAL * 1000);
@@ -3353,8 +3385,11 @@ void CConnman::Interrupt()
 
 void CConnman::Stop()
 {
-    if (threadMessageHandler.joinable())
-        threadMessageHandler.join();
+    for (auto& thread : threadMessageHandlers) {
+        if (thread.joinable())
+            thread.join();
+    }
+    threadMessageHandlers.clear();
     if (threadOpenMasternodeConnections.joinable())
         threadOpenMasternodeConnections.join();
     if (threadOpenConnections.joinable())
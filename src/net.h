@@ -26,6 +26,7 @@
 #include <threadinterrupt.h>
 #include <consensus/params.h>
 
+#include <array>
 #include <atomic>
 #include <deque>
 #include <stdint.h>
@@ -91,6 +92,10 @@ static const uint64_t MAX_UPLOAD_TIMEFRAME = 60 * 60 * 24;
 static const bool DEFAULT_BLOCKSONLY = false;
 /** -peertimeout default */
 static const int64_t DEFAULT_PEER_CONNECT_TIMEOUT = 60;
+/** -msghandlerthreads default, peers are spread over this many message handler threads */
+static const int DEFAULT_MSGHANDLER_THREADS = 1;
+/** Maximum number of message handler threads */
+static const int MAX_MSGHANDLER_THREADS = 16;
 
 static const bool DEFAULT_FORCEDNSSEED = false;
 static const size_t DEFAULT_MAXRECEIVEBUFFER = 5 * 1000;
@@ -177,6 +182,7 @@ public:
         std::vector<std::string> m_specified_outgoing;
         std::vector<std::string> m_added_nodes;
         SocketEventsMode socketEventsMode = SOCKETEVENTS_SELECT;
+        int nMsgHandlerThreads = DEFAULT_MSGHANDLER_THREADS;
     };
 
     void Init(const Options& connOptions) {
@@ -203,6 +209,7 @@ public:
             vAddedNodes = connOptions.m_added_nodes;
         }
         socketEventsMode = connOptions.socketEventsMode;
+        nMsgHandlerThreads = std::max(1, std::min(connOptions.nMsgHandlerThreads, MAX_MSGHANDLER_THREADS));
     }
 
     CConnman(uint64_t seed0, uint64_t seed1);
@@ -497,7 +504,7 @@ private:
     void AddOneShot(const std::string& strDest);
     void ProcessOneShot();
     void ThreadOpenConnections(std::vector<std::string> connect);
-    void ThreadMessageHandler();
+    void ThreadMessageHandler(int nShard);
     void AcceptConnection(const ListenSocket& hListenSocket);
     void DisconnectNodes();
     void NotifyNumConnectionsChanged();
@@ -619,8 +626,9 @@ private:
     /** SipHasher seeds for deterministic randomness */
     const uint64_t nSeed0, nSeed1;
 
-    /** flag for waking the message processor. */
-    bool fMsgProcWake;
+    /** flags for waking the message processors, one per message handler thread. */
+    std::vector<bool> vMsgProcWake;
+    int nMsgHandlerThreads;
 
     std::condition_variable condMsgProc;
     std::mutex mutexMsgProc;
@@ -654,7 +662,7 @@ private:
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
     std::thread threadOpenMasternodeConnections;
-    std::thread threadMessageHandler;
+    std::vector<std::thread> threadMessageHandlers;
 
     /** flag for deciding to connect to an extra outbound peer,
      *  in excess of nMaxOutbound
@@ -750,6 +758,21 @@ extern CCriticalSection cs_mapLocalHost;
 extern std::map<CNetAddr, LocalServiceInfo> mapLocalHost GUARDED_BY(cs_mapLocalHost);
 typedef std::map<std::string, uint64_t> mapMsgCmdSize; //command, total bytes
 
+/** Time spent in ProcessMessage for one message type */
+struct CMsgProcessTime
+{
+    static const int BUCKETS = 20;
+
+    uint64_t nCount{0};
+    int64_t nTotalUsec{0};
+    int64_t nMaxUsec{0};
+    /** Bucket i counts times in [2^(i-1), 2^i) microseconds, bucket 0 times below 1us and the last one everything above */
+    std::array<uint64_t, BUCKETS> vBuckets{};
+
+    void Add(int64_t nUsec);
+};
+typedef std::map<std::string, CMsgProcessTime> mapMsgCmdProcessTime; //command, processing time
+
 class CNodeStats
 {
 public:
@@ -770,6 +793,7 @@ public:
     mapMsgCmdSize mapSendBytesPerMsgCmd;
     uint64_t nRecvBytes;
     mapMsgCmdSize mapRecvBytesPerMsgCmd;
+    mapMsgCmdProcessTime mapProcessTimePerMsgCmd;
     bool fWhitelisted;
     double dPingTime;
     double dPingWait;
@@ -921,6 +945,7 @@ protected:
 
     mapMsgCmdSize mapSendBytesPerMsgCmd;
     mapMsgCmdSize mapRecvBytesPerMsgCmd GUARDED_BY(cs_vRecv);
+    mapMsgCmdProcessTime mapProcessTimePerMsgCmd GUARDED_BY(cs_vRecv);
 
 public:
     uint256 hashContinue;
@@ -1030,6 +1055,9 @@ public:
 
     bool ReceiveMsgBytes(const char *pch, unsigned int nBytes, bool& complete);
 
+    /** Account the time ProcessMessage took for a message of this peer */
+    void RecordProcessTime(const std::string& strCommand, int64_t nUsec);
+
     void SetRecvVersion(int nVersionIn)
     {
         nRecvVersion = nVersionIn;
@@ -125,14 +125,32 @@ bool ContextualCheckZerocoinSpendNoSerialCheck(const CTransaction& tx, const lib
     return true;
 }
 
-bool ContextualCheckZerocoinMint(const libzerocoin::PublicCoin& coin, const CBlockIndex* pindex)
+bool CZerocoinSpendCheck::operator()()
+{
+    try {
+        if (fPublicSpend) {
+            // Check that the spend opens the commitment of the mint it spends
+            const PublicCoinSpend& publicSpend = static_cast<const PublicCoinSpend&>(*spend);
+            libzerocoin::Commitment commitment(&Params().Zerocoin_Params(false)->coinCommitmentGroup,
+                                               publicSpend.getCoinSerialNumber(), publicSpend.randomness);
+            if (commitment.getCommitmentValue() != publicSpend.pubCoin.getValue())
+                return error("%s: public zerocoin spend in tx %s does not open the spent mint\n", __func__,
+                             ptx->GetHash().GetHex());
+        }
+        return ContextualCheckZerocoinSpendNoSerialCheck(*ptx, spend.get(), pindex, pindex->GetBlockHash());
+    } catch (const std::exception& e) {
+        return error("%s: invalid zerocoin spend in tx %s: %s\n", __func__, ptx->GetHash().GetHex(), e.what());
+    }
+}
+
+bool ContextualCheckZerocoinMint(const libzerocoin::PublicCoin& coin, const CBlockIndex* pindex, bool fCheckAccumulated)
 {
     if (pindex->nHeight >= Params().GetConsensus().nPublicZCSpends) {
         // Zerocoin MINTs have been disabled
         return error("%s: Mints disabled at height %d - unable to add pubcoin %s", __func__,
                 pindex->nHeight, coin.getValue().GetHex().substr(0, 10));
     }
-    if (pindex->nHeight >= Params().GetConsensus().nBlockZerocoinV2 && Params().NetworkIDString() != CBaseChainParams::TESTNET) {
+    if (fCheckAccumulated && pindex->nHeight >= Params().GetConsensus().nBlockZerocoinV2 && Params().NetworkIDString() != CBaseChainParams::TESTNET) {
         //See if this coin has already been added to the blockchain
         uint256 txid;
         int nHeight;
@@ -149,11 +167,13 @@ bool CheckZerocoinSpendTx(CBlockIndex *pindex, CValidationState& state, const CT
         std::vector<uint256>& vSpendsInBlock,
         std::vector<std::pair<libzerocoin::CoinSpend, uint256> >& vSpends,
         std::vector<std::pair<libzerocoin::PublicCoin, uint256> >& vMints,
-        CAmount& nValueIn) {
+        CAmount& nValueIn, bool fZerocoinChecks, std::vector<CZerocoinSpendCheck>* pvSpendChecks) {
+    // the spend checks need the spent mints, which are only read with fZerocoinChecks
+    assert(!pvSpendChecks || fZerocoinChecks);
     int nHeightTx = 0;
     uint256 txid = tx.GetHash();
     vSpendsInBlock.emplace_back(txid);
-    if (IsTransactionInChain(txid, nHeightTx)) {
+    if (fZerocoinChecks && IsTransactionInChain(txid, nHeightTx)) {
         //when verifying blocks on init, the blocks are scanned without being disconnected - prevent that from causing an error
 //                if (!fVerifyingBlocks || (fVerifyingBlocks && pindex->nHeight > nHeightTx))
         if (!IsInitialBlockDownload())
@@ -177,26 +197,27 @@ bool CheckZerocoinSpendTx(CBlockIndex *pindex, CValidationState& state, const CT
         if (isPublicSpend) {
             libzerocoin::ZerocoinParams* params = Params().Zerocoin_Params(false);
             PublicCoinSpend publicSpend(params);
-            if (!ZBYTZModule::ParseZerocoinPublicSpend(txIn, tx, state, publicSpend)){
+            if (!fZerocoinChecks) {
+                // Only the serial is recorded, so skip reading the spent mint from disk and
+                // take the denomination from the input, as UpdateZBYTZSupply does.
+                publicSpend = ZBYTZModule::parseCoinSpend(txIn);
+                publicSpend.setDenom(libzerocoin::IntToZerocoinDenomination(txIn.nSequence));
+            } else if (!ZBYTZModule::ParseZerocoinPublicSpend(txIn, tx, state, publicSpend)){
                 LogPrintf("%s - Unable to parse zerocoin spend", __func__);
                 return false;
             }
             nValueIn += publicSpend.getDenomination() * COIN;
             //queue for db write after the 'justcheck' section has concluded
             vSpends.emplace_back(std::make_pair(publicSpend, tx.GetHash()));
-/*
-            if (!ContextualCheckZerocoinSpend(tx, &publicSpend, pindex, hashBlock))
-                return state.DoS(100, error("%s: failed to add block %s with invalid public zc spend", __func__, tx.GetHash().GetHex()), REJECT_INVALID);
-*/
+            if (pvSpendChecks)
+                pvSpendChecks->emplace_back(std::make_shared<PublicCoinSpend>(publicSpend), tx, pindex, true);
         } else {
             libzerocoin::CoinSpend spend = TxInToZerocoinSpend(txIn);
             nValueIn += spend.getDenomination() * COIN;
             //queue for db write after the 'justcheck' section has concluded
             vSpends.emplace_back(std::make_pair(spend, tx.GetHash()));
-/*
-            if (!ContextualCheckZerocoinSpend(tx, &spend, pindex, hashBlock))
-                return state.DoS(100, error("%s: failed to add block %s with invalid zerocoinspend", __func__, tx.GetHash().GetHex()), REJECT_INVALID);
-*/
+            if (pvSpendChecks)
+                pvSpendChecks->emplace_back(std::make_shared<libzerocoin::CoinSpend>(spend), tx, pindex, false);
         }
         // Set flag if input is a group token management address
     }
@@ -220,7 +241,7 @@ bool CheckZerocoinSpendTx(CBlockIndex *pindex, CValidationState& state, const CT
             if (!TxOutToPublicCoin(out, coin, state))
                 return state.DoS(100, error("%s: failed final check of zerocoinmint for tx %s", __func__, tx.GetHash().GetHex()));
 
-            if (!ContextualCheckZerocoinMint(coin, pindex))
+            if (!ContextualCheckZerocoinMint(coin, pindex, fZerocoinChecks))
                 return state.DoS(100, error("%s: zerocoin mint failed contextual check", __func__));
 
             vMints.emplace_back(std::make_pair(coin, tx.GetHash()));
@@ -9,6 +9,8 @@
 #include "libzerocoin/CoinSpend.h"
 #include "primitives/transaction.h"
 
+#include <memory>
+
 bool IsBlockHashInChain(const uint256& hashBlock);
 bool IsTransactionInChain(const uint256& txId, int& nHeightTx, CTransactionRef& tx);
 bool IsTransactionInChain(const uint256& txId, int& nHeightTx);
@@ -17,8 +19,45 @@ bool CheckPublicCoinSpendEnforced(int blockHeight, bool isPublicSpend);
 
 bool ContextualCheckZerocoinSpend(const CTransaction& tx, const libzerocoin::CoinSpend* spend, CBlockIndex* pindex, const uint256& hashBlock);
 bool ContextualCheckZerocoinSpendNoSerialCheck(const CTransaction& tx, const libzerocoin::CoinSpend* spend, CBlockIndex* pindex, const uint256& hashBlock);
-bool ContextualCheckZerocoinMint(const libzerocoin::PublicCoin& coin, const CBlockIndex* pindex);
+/** fCheckAccumulated looks the mint up in the mint database and the chain; it is skipped for assumed-valid blocks. */
+bool ContextualCheckZerocoinMint(const libzerocoin::PublicCoin& coin, const CBlockIndex* pindex, bool fCheckAccumulated = true);
+
+/**
+ * Closure representing the signature and serial checks of one zerocoin spend, so that the spends of a block can
+ * be verified on the check queue threads. For public spends it also checks that the commitment opens to the spent
+ * mint. The spend is held with its dynamic type, as the signature hash of a public spend differs from a private one.
+ */
+class CZerocoinSpendCheck
+{
+private:
+    std::shared_ptr<const libzerocoin::CoinSpend> spend;
+    const CTransaction* ptx;
+    CBlockIndex* pindex;
+    bool fPublicSpend;
+
+public:
+    CZerocoinSpendCheck() : ptx(nullptr), pindex(nullptr), fPublicSpend(false) {}
+    CZerocoinSpendCheck(std::shared_ptr<const libzerocoin::CoinSpend> spendIn, const CTransaction& txIn, CBlockIndex* pindexIn, bool fPublicSpendIn) :
+        spend(std::move(spendIn)), ptx(&txIn), pindex(pindexIn), fPublicSpend(fPublicSpendIn) {}
+
+    bool operator()();
+
+    void swap(CZerocoinSpendCheck& check)
+    {
+        spend.swap(check.spend);
+        std::swap(ptx, check.ptx);
+        std::swap(pindex, check.pindex);
+        std::swap(fPublicSpend, check.fPublicSpend);
+    }
+};
 
-bool CheckZerocoinSpendTx(CBlockIndex *pindex, CValidationState& state, const CTransaction& tx, std::vector<uint256>& vSpendsInBlock, std::vector<std::pair<libzerocoin::CoinSpend, uint256> >& vSpends, std::vector<std::pair<libzerocoin::PublicCoin, uint256> >& vMints, CAmount& nValueIn);
+/**
+ * Check the zerocoin spends and mints of a transaction and queue their serials and pubcoins for the zerocoin database.
+ * Without fZerocoinChecks, as for assumed-valid blocks, the spends and mints are only parsed: the lookups of the
+ * transaction, of the spent mint outputs and of earlier mints in the chain are skipped.
+ * With pvSpendChecks, which requires fZerocoinChecks, the signature and serial checks of the spends are appended
+ * to it instead of being skipped.
+ */
+bool CheckZerocoinSpendTx(CBlockIndex *pindex, CValidationState& state, const CTransaction& tx, std::vector<uint256>& vSpendsInBlock, std::vector<std::pair<libzerocoin::CoinSpend, uint256> >& vSpends, std::vector<std::pair<libzerocoin::PublicCoin, uint256> >& vMints, CAmount& nValueIn, bool fZerocoinChecks = true, std::vector<CZerocoinSpendCheck>* pvSpendChecks = nullptr);
 
 #endif //POS_CHECKS_H
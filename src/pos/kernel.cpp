@@ -29,11 +29,116 @@ static const int64_t OLD_MODIFIER_INTERVAL = 2087;
 static std::map<int, unsigned int> mapStakeModifierCheckpoints =
     boost::assign::map_list_of(0, 234907403);
 
+CStakeModifierCache stakeModifierCache;
+
+bool CStakeModifierCache::IsSynced(const CChain& chain) const
+{
+    AssertLockHeld(cs);
+    return pindexTip && chain[pindexTip->nHeight] == pindexTip;
+}
+
+void CStakeModifierCache::Truncate(const CBlockIndex* pindexFork)
+{
+    AssertLockHeld(cs);
+    const int nHeight = pindexFork ? pindexFork->nHeight : -1;
+    vLastGenerated.resize(nHeight + 1);
+    vKernelModifier.resize(nHeight + 1);
+    // forget the kernel modifiers that were found in the disconnected blocks
+    for (int& nModifierHeight : vKernelModifier) {
+        if (nModifierHeight > nHeight)
+            nModifierHeight = -1;
+    }
+    pindexTip = pindexFork;
+}
+
+void CStakeModifierCache::Sync(const CChain& chain)
+{
+    LOCK(cs);
+    if (chain.Height() >= Params().GetConsensus().nBlockStakeModifierV2) {
+        if (pindexTip) {
+            LogPrint(BCLog::STAKING, "%s: chain is past the stake modifier v2 switch, dropping %u entries\n", __func__, vLastGenerated.size());
+            std::vector<int>().swap(vLastGenerated);
+            std::vector<int>().swap(vKernelModifier);
+            pindexTip = nullptr;
+        }
+        return;
+    }
+
+    if (pindexTip && !IsSynced(chain))
+        Truncate(chain.FindFork(pindexTip));
+
+    for (int nHeight = vLastGenerated.size(); nHeight <= chain.Height(); nHeight++) {
+        const CBlockIndex* pindex = chain[nHeight];
+        const int nLastGenerated = nHeight > 0 ? vLastGenerated[nHeight - 1] : -1;
+        vLastGenerated.push_back(pindex->GeneratedStakeModifier() ? nHeight : nLastGenerated);
+        vKernelModifier.push_back(-1);
+        pindexTip = pindex;
+    }
+}
+
+void CStakeModifierCache::Clear()
+{
+    LOCK(cs);
+    std::vector<int>().swap(vLastGenerated);
+    std::vector<int>().swap(vKernelModifier);
+    pindexTip = nullptr;
+}
+
+bool CStakeModifierCache::GetKernelStakeModifier(const CChain& chain, const CBlockIndex* pindexFrom, const CBlockIndex*& pindexModifier)
+{
+    LOCK(cs);
+    if (!IsSynced(chain) || pindexFrom->nHeight > pindexTip->nHeight || chain[pindexFrom->nHeight] != pindexFrom)
+        return false;
+
+    int& nModifierHeight = vKernelModifier[pindexFrom->nHeight];
+    if (nModifierHeight < 0) {
+        // same search as the chain walk in GetKernelStakeModifier(), over the cached heights only
+        const int64_t nTimeLimit = pindexFrom->GetBlockTime() + OLD_MODIFIER_INTERVAL;
+        for (int nHeight = pindexFrom->nHeight + 1; nHeight <= pindexTip->nHeight; nHeight++) {
+            if (vLastGenerated[nHeight] == nHeight && chain[nHeight]->GetBlockTime() >= nTimeLimit) {
+                nModifierHeight = nHeight;
+                break;
+            }
+        }
+        if (nModifierHeight < 0)
+            return false;
+    }
+
+    pindexModifier = chain[nModifierHeight];
+    return true;
+}
+
+bool CStakeModifierCache::GetLastStakeModifier(const CChain& chain, const CBlockIndex* pindex, const CBlockIndex*& pindexModifier) const
+{
+    LOCK(cs);
+    if (!IsSynced(chain) || pindex->nHeight > pindexTip->nHeight || chain[pindex->nHeight] != pindex)
+        return false;
+
+    const int nLastGenerated = vLastGenerated[pindex->nHeight];
+    if (nLastGenerated < 0)
+        return false;
+
+    pindexModifier = chain[nLastGenerated];
+    return true;
+}
+
+size_t CStakeModifierCache::Size() const
+{
+    LOCK(cs);
+    return vLastGenerated.size();
+}
+
 // Get the last stake modifier and its generation time from a given block
 static bool GetLastStakeModifier(const CBlockIndex* pindex, uint64_t& nStakeModifier, int64_t& nModifierTime)
 {
     if (!pindex)
         return error("%s : null pindex", __func__);
+    const CBlockIndex* pindexModifier = nullptr;
+    if (stakeModifierCache.GetLastStakeModifier(chainActive, pindex, pindexModifier)) {
+        nStakeModifier = pindexModifier->nStakeModifier;
+        nModifierTime = pindexModifier->GetBlockTime();
+        return true;
+    }
     while (pindex && pindex->pprev && !pindex->GeneratedStakeModifier())
         pindex = pindex->pprev;
     if (!pindex->GeneratedStakeModifier())
@@ -245,6 +350,13 @@ bool GetKernelStakeModifier(const uint256& hashBlockFrom, uint64_t& nStakeModifi
         nStakeModifier = pindexFrom->nStakeModifier;
         return true;
     }
+    const CBlockIndex* pindexModifier = nullptr;
+    if (stakeModifierCache.GetKernelStakeModifier(chainActive, pindexFrom, pindexModifier)) {
+        nStakeModifier = pindexModifier->nStakeModifier;
+        nStakeModifierHeight = pindexModifier->nHeight;
+        nStakeModifierTime = pindexModifier->GetBlockTime();
+        return true;
+    }
     const CBlockIndex* pindex = pindexFrom;
     CBlockIndex* pindexNext = chainActive[pindex->nHeight + 1];
 
@@ -265,34 +377,41 @@ bool GetKernelStakeModifier(const uint256& hashBlockFrom, uint64_t& nStakeModifi
     return true;
 }
 
-bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, const unsigned int nBits, CStakeInput* stake, const unsigned int nTimeTx, uint256& hashProofOfStake, const bool fVerify)
+static bool CheckStakeTarget(const unsigned int nBits, const CAmount nValue, const uint256& hashProofOfStake)
 {
-    // Calculate the proof of stake hash
-    if (!GetHashProofOfStake(pindexPrev, stake, nTimeTx, fVerify, hashProofOfStake)) {
-        return error("%s : Failed to calculate the proof of stake hash", __func__);
-    }
-
     // Base target
     arith_uint256 bnTarget;
     bnTarget.SetCompact(nBits);
 
     // Weighted target
-    bnTarget *= (arith_uint256(stake->GetValue()) / 100);
+    bnTarget *= (arith_uint256(nValue) / 100);
 
     // Check if proof-of-stake hash meets target protocol
-    const arith_uint256 proof = UintToArith256(hashProofOfStake);
-    const bool res = (UintToArith256(hashProofOfStake) < bnTarget);
+    return UintToArith256(hashProofOfStake) < bnTarget;
+}
+
+bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, const unsigned int nBits, CStakeInput* stake, const unsigned int nTimeTx, uint256& hashProofOfStake, const bool fVerify)
+{
+    // Calculate the proof of stake hash
+    if (!GetHashProofOfStake(pindexPrev, stake, nTimeTx, fVerify, hashProofOfStake)) {
+        return error("%s : Failed to calculate the proof of stake hash", __func__);
+    }
 
-    return res;
+    return CheckStakeTarget(nBits, stake->GetValue(), hashProofOfStake);
 }
 
-bool GetHashProofOfStake(const CBlockIndex* pindexPrev, CStakeInput* stake, const unsigned int nTimeTx, const bool fVerify, uint256& hashProofOfStakeRet) {
+bool CheckStakeKernelHash(const CStakeKernelHasher& hasher, const unsigned int nBits, const unsigned int nTimeTx, uint256& hashProofOfStake)
+{
+    hashProofOfStake = hasher.GetHash(nTimeTx);
+    return CheckStakeTarget(nBits, hasher.GetValue(), hashProofOfStake);
+}
+
+bool CStakeKernelHasher::Init(const CBlockIndex* pindexPrev, CStakeInput* stake)
+{
     // Grab the stake data
     CBlockIndex* pindexfrom = stake->GetIndexFrom();
     if (!pindexfrom) return error("%s : Failed to find the block index for stake origin", __func__);
-    const CDataStream& ssUniqueID = stake->GetUniqueness();
     const unsigned int nTimeBlockFrom = pindexfrom->nTime;
-    CDataStream modifier_ss(SER_GETHASH, 0);
 
     // Hash the modifier
     if ((pindexPrev->nHeight + 1) < Params().GetConsensus().nBlockStakeModifierV2) {
@@ -300,17 +419,31 @@ bool GetHashProofOfStake(const CBlockIndex* pindexPrev, CStakeInput* stake, cons
         uint64_t nStakeModifier = 0;
         if (!stake->GetModifier(nStakeModifier))
             return error("%s : Failed to get kernel stake modifier", __func__);
-        modifier_ss << nStakeModifier;
+        ss << nStakeModifier;
     } else {
         // Modifier v2
-        const arith_uint256 prevModifier = UintToArith256(pindexPrev->nStakeModifierV2);
-        modifier_ss << pindexPrev->nStakeModifierV2;
+        ss << pindexPrev->nStakeModifierV2;
     }
 
-    CDataStream ss(modifier_ss);
+    ss << nTimeBlockFrom << stake->GetUniqueness();
+    nValue = stake->GetValue();
+    return true;
+}
+
+uint256 CStakeKernelHasher::GetHash(const unsigned int nTimeTx) const
+{
+    CHashWriter ssTime(ss);
+    ssTime << nTimeTx;
+    return ssTime.GetHash();
+}
+
+bool GetHashProofOfStake(const CBlockIndex* pindexPrev, CStakeInput* stake, const unsigned int nTimeTx, const bool fVerify, uint256& hashProofOfStakeRet) {
+    CStakeKernelHasher hasher;
+    if (!hasher.Init(pindexPrev, stake))
+        return false;
+
     // Calculate hash
-    ss << nTimeBlockFrom << ssUniqueID << nTimeTx;
-    hashProofOfStakeRet = Hash(ss.begin(), ss.end());
+    hashProofOfStakeRet = hasher.GetHash(nTimeTx);
     return true;
 }
 
@@ -443,7 +576,10 @@ unsigned int GetStakeModifierChecksum(const CBlockIndex* pindex)
     CDataStream ss(SER_GETHASH, 0);
     if (pindex->pprev)
         ss << pindex->pprev->nStakeModifierChecksum;
-    uint256 hashProofOfStake = mapProofOfStake[pindex->GetBlockHash()];
+    // unknown blocks hash a null proof and keep it, like the std::map operator[] this used to be
+    uint256 hashProofOfStake;
+    if (!mapProofOfStake.get(pindex->GetBlockHash(), hashProofOfStake))
+        mapProofOfStake.insert(pindex->GetBlockHash(), hashProofOfStake);
     ss << pindex->nFlags << hashProofOfStake << pindex->nStakeModifier;
     uint256 hashChecksum = Hash(ss.begin(), ss.end());
     arith_uint256 arithHashChecksum = UintToArith256(hashChecksum);
@@ -471,6 +607,9 @@ int64_t GetTimeSlot(const int64_t nTime)
 bool SetPOSParameters(const CBlock& block, CValidationState& state, CBlockIndex* pindexNew) {
     AssertLockHeld(cs_main);
 
+    // pindexNew is not part of chainActive yet, the cache follows its parent
+    stakeModifierCache.Sync(chainActive);
+
     if (pindexNew->nHeight < Params().GetConsensus().nBlockStakeModifierV2) {
         uint64_t nStakeModifier = 0;
         bool fGeneratedStakeModifier = false;
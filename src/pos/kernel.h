@@ -9,6 +9,7 @@
 #ifndef BITCOIN_KERNEL_H
 #define BITCOIN_KERNEL_H
 
+#include "hash.h"
 #include "validation.h"
 #include "stakeinput.h"
 
@@ -25,6 +26,52 @@ bool GetKernelStakeModifier(const uint256& hashBlockFrom, uint64_t& nStakeModifi
 bool ComputeNextStakeModifier(const CBlockIndex* pindexPrev, uint64_t& nStakeModifier, bool& fGeneratedStakeModifier);
 bool ComputeStakeModifierV2(CBlockIndex* pindex, const uint256& kernel);
 
+// Height indexed view of the legacy (pre v2) stake modifiers of the active chain.
+// Memoizes the block providing the kernel modifier of each origin height and the
+// last modifier generating block at each height, so that neither needs to walk the
+// chain again. Entries are only kept below nBlockStakeModifierV2 and the cache is
+// dropped once the active chain goes past that height.
+class CStakeModifierCache
+{
+private:
+    mutable CCriticalSection cs;
+    // last block added, every entry is an ancestor of it
+    const CBlockIndex* pindexTip{nullptr};
+    // per height: the last block at or below that height which generated a modifier, -1 if none
+    std::vector<int> vLastGenerated;
+    // per origin height: the block holding the kernel stake modifier, -1 while unknown
+    std::vector<int> vKernelModifier;
+
+    bool IsSynced(const CChain& chain) const;
+    void Truncate(const CBlockIndex* pindexFork);
+
+public:
+    // Catch up with (or rewind to) the given chain
+    void Sync(const CChain& chain);
+    void Clear();
+
+    bool GetKernelStakeModifier(const CChain& chain, const CBlockIndex* pindexFrom, const CBlockIndex*& pindexModifier);
+    bool GetLastStakeModifier(const CChain& chain, const CBlockIndex* pindex, const CBlockIndex*& pindexModifier) const;
+    size_t Size() const;
+};
+
+extern CStakeModifierCache stakeModifierCache;
+
+// Stake kernel hasher with the part of the kernel that is fixed for a given (tip, input)
+// pair, i.e. the stake modifier, the origin block time and the input uniqueness,
+// serialized once so that each attempt only hashes the transaction time on top of it
+class CStakeKernelHasher
+{
+private:
+    CHashWriter ss{SER_GETHASH, 0};
+    CAmount nValue{0};
+
+public:
+    bool Init(const CBlockIndex* pindexPrev, CStakeInput* stake);
+    uint256 GetHash(const unsigned int nTimeTx) const;
+    CAmount GetValue() const { return nValue; }
+};
+
 // Initialize the stake input object
 bool initStakeInput(const CBlock& block, std::unique_ptr<CStakeInput>& stake, int nPreviousBlockHeight);
 
@@ -32,6 +79,7 @@ bool initStakeInput(const CBlock& block, std::unique_ptr<CStakeInput>& stake, in
 // Sets hashProofOfStake on success return
 bool CheckProofOfStake(const CBlock& block, uint256& hashProofOfStake, const CBlockIndex* pindex);
 bool CheckStakeKernelHash(const CBlockIndex* pindexPrev, const unsigned int nBits, CStakeInput* stake, const unsigned int nTimeTx, uint256& hashProofOfStake, const bool fVerify = false);
+bool CheckStakeKernelHash(const CStakeKernelHasher& hasher, const unsigned int nBits, const unsigned int nTimeTx, uint256& hashProofOfStake);
 // Returns the proof of stake hash
 bool GetHashProofOfStake(const CBlockIndex* pindexPrev, CStakeInput* stake, const unsigned int nTimeTx, const bool fVerify, uint256& hashProofOfStakeRet);
 // Get stake modifier checksum
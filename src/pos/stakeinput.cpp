@@ -199,10 +199,12 @@ bool CZStake::MarkSpent(CWallet *pwallet, const uint256& txid)
 */
 
 //!Bytz Stake
-bool CStake::SetInput(CTransactionRef txPrev, unsigned int n)
+bool CStake::SetInput(CTransactionRef txPrev, unsigned int n, CBlockIndex* pindexFromIn)
 {
     this->txFrom = txPrev;
     this->nPosition = n;
+    // the caller may already know the block containing txPrev, saves the transaction lookup in GetIndexFrom()
+    this->pindexFrom = pindexFromIn;
     return true;
 }
 
@@ -91,7 +91,7 @@ private:
 public:
     CStake(){}
 
-    bool SetInput(CTransactionRef txPrev, unsigned int n);
+    bool SetInput(CTransactionRef txPrev, unsigned int n, CBlockIndex* pindexFromIn = nullptr);
 
     CBlockIndex* GetIndexFrom() override;
     bool GetTxFrom(CTransactionRef& tx) override;
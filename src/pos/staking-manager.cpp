@@ -15,40 +15,188 @@
 #include "pos/stakeinput.h"
 #include "pow.h"
 #include "script/sign.h"
+#include "tokens/groups.h"
 #include "validation.h"
 #include "wallet/wallet.h"
 
+#include <atomic>
+#include <future>
+
 #include <boost/thread.hpp>
 
 std::shared_ptr<CStakingManager> stakingManager;
 
+struct CStakeSnapshot
+{
+    std::vector<std::shared_ptr<CStakeInput> > vInputs;
+    // kernel hash prefixes of vInputs against the snapshot tip
+    std::vector<CStakeKernelHasher> vHashers;
+};
+
+// Full reload of the stake candidates from the wallet, in seconds
+static const int64_t STAKE_CANDIDATES_RELOAD_INTERVAL = 60 * 60;
+
 CStakingManager::CStakingManager(std::shared_ptr<CWallet> pwalletIn) :
         nMintableLastCheck(0), fMintableCoins(false), fLastLoopOrphan(false), nExtraNonce(0), // Currently unused
         fEnableStaking(false), fEnableBYTZStaking(false), nReserveBalance(0), pwallet(pwalletIn),
         nHashInterval(22), nLastCoinStakeSearchInterval(0), nLastCoinStakeSearchTime(GetAdjustedTime()) {}
 
-bool CStakingManager::MintableCoins()
+CStakingManager::~CStakingManager()
 {
-    if (pwallet == nullptr) return false;
+    Stop();
+}
 
-    LOCK2(cs_main, pwallet->cs_wallet);
+void CStakingManager::Start(int nThreads)
+{
+    nStakingThreads = std::max(1, std::min(nThreads, MAX_STAKING_THREADS));
+    if (nStakingThreads > 1) {
+        workerPool.resize(nStakingThreads);
+        RenameThreadPool(workerPool, "bytz-stake");
+    }
+}
 
-    int blockHeight = chainActive.Height();
+void CStakingManager::Stop()
+{
+    workerPool.clear_queue();
+    workerPool.stop(true);
+}
 
-    std::vector<COutput> vCoins;
-    CCoinControl coin_control;
-    coin_control.nCoinType = CoinType::STAKABLE_COINS;
-    int nMinDepth = blockHeight >= Params().GetConsensus().nBlockStakeModifierV2 ? Params().GetConsensus().nStakeMinDepth : 1;
-    pwallet->AvailableCoins(vCoins, true, &coin_control, 1, MAX_MONEY, MAX_MONEY, 0, nMinDepth);
-    CAmount nAmountSelected = 0;
+bool CStakingManager::IsStakeCandidate(const CTxOut& txout) const
+{
+    // Same filter as CoinType::STAKABLE_COINS in CWallet::AvailableCoins
+    if (txout.nValue <= 0 || txout.IsZerocoinMint())
+        return false;
+    if (IsOutputGrouped(txout))
+        return false;
+    if (txout.nValue == 10000000 * COIN)
+        return false;
+    if (!IsValidStakeInput(txout))
+        return false;
+    return (pwallet->IsMine(txout) & ISMINE_SPENDABLE) != ISMINE_NO;
+}
+
+void CStakingManager::AddStakeCandidate(const CTransactionRef& tx, unsigned int n, CBlockIndex* pindexFrom)
+{
+    AssertLockHeld(cs);
+
+    const Consensus::Params& params = Params().GetConsensus();
+    int nMaturityHeight = pindexFrom->nHeight + (tx->IsGenerated() ? params.nCoinbaseMaturity + 1 : 1);
+    if (pindexFrom->nHeight >= params.nBlockStakeModifierV2)
+        nMaturityHeight = std::max(nMaturityHeight, pindexFrom->nHeight + params.nStakeMinDepth);
 
-    for (const COutput &out : vCoins) {
-        if (out.tx->tx->vin[0].IsZerocoinSpend() && !out.tx->IsInMainChain())
+    COutPoint outpoint(tx->GetHash(), n);
+    if (!mapStakeCandidates.emplace(outpoint, CStakeCandidate{tx, n, pindexFrom, nMaturityHeight}).second)
+        return;
+    setCandidatesByMaturity.emplace(nMaturityHeight, outpoint);
+}
+
+void CStakingManager::RemoveStakeCandidate(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs);
+
+    auto it = mapStakeCandidates.find(outpoint);
+    if (it == mapStakeCandidates.end())
+        return;
+    setCandidatesByMaturity.erase(std::make_pair(it->second.nMaturityHeight, outpoint));
+    mapStakeCandidates.erase(it);
+}
+
+void CStakingManager::RestoreStakeCandidates(const CTransaction& tx)
+{
+    AssertLockHeld(cs);
+
+    for (const CTxIn& txin : tx.vin) {
+        auto it = mapCandidatesSpentInMempool.find(txin.prevout);
+        if (it == mapCandidatesSpentInMempool.end())
             continue;
+        AddStakeCandidate(it->second.tx, it->second.n, it->second.pindexFrom);
+        mapCandidatesSpentInMempool.erase(it);
+    }
+}
+
+void CStakingManager::LoadStakeCandidates()
+{
+    LOCK2(cs_main, pwallet->cs_wallet);
+
+    std::vector<std::pair<COutPoint, CStakeCandidate> > vCandidates;
+    for (const auto& entry : pwallet->mapWallet) {
+        const CWalletTx* pcoin = &entry.second;
+        if (pcoin->GetDepthInMainChain() < 1)
+            continue;
+        CBlockIndex* pindexFrom = LookupBlockIndex(pcoin->hashBlock);
+        if (!pindexFrom)
+            continue;
+        for (unsigned int i = 0; i < pcoin->tx->vout.size(); i++) {
+            if (pwallet->IsSpent(pcoin->GetHash(), i) || !IsStakeCandidate(pcoin->tx->vout[i]))
+                continue;
+            vCandidates.emplace_back(COutPoint(pcoin->GetHash(), i), CStakeCandidate{pcoin->tx, i, pindexFrom, 0});
+        }
+    }
+
+    LOCK(cs);
+    mapStakeCandidates.clear();
+    setCandidatesByMaturity.clear();
+    mapCandidatesSpentInMempool.clear();
+    for (const auto& p : vCandidates) {
+        AddStakeCandidate(p.second.tx, p.second.n, p.second.pindexFrom);
+    }
+    hashCandidatesBlock = chainActive.Tip()->GetBlockHash();
+    nCandidatesHeight = chainActive.Height();
+    nCandidatesLoadTime = GetTime();
+    fCandidatesLoaded = true;
+
+    LogPrint(BCLog::STAKING, "%s: loaded %d stake candidates at height %d\n", __func__, mapStakeCandidates.size(), nCandidatesHeight);
+}
+
+bool CStakingManager::GetStakeCandidates(int blockHeight, bool fRequireSynced, std::vector<CStakeCandidate>& vCandidatesRet)
+{
+    bool fReload;
+    {
+        LOCK(cs);
+        // Outputs that reach the wallet outside of block connection (imports, rescans) are picked up by the periodic reload
+        fReload = !fCandidatesLoaded || GetTime() - nCandidatesLoadTime > STAKE_CANDIDATES_RELOAD_INTERVAL;
+    }
+    if (fReload)
+        LoadStakeCandidates();
 
-        CBlockIndex* utxoBlock = mapBlockIndex.at(out.tx->hashBlock);
+    {
+        LOCK(cs);
+        if (fRequireSynced && nCandidatesHeight != blockHeight - 1) {
+            LogPrint(BCLog::STAKING, "%s: stake candidates are at height %d, waiting for %d\n", __func__, nCandidatesHeight, blockHeight - 1);
+            return false;
+        }
+        for (auto it = setCandidatesByMaturity.begin(); it != setCandidatesByMaturity.end() && it->first <= blockHeight; ++it) {
+            vCandidatesRet.emplace_back(mapStakeCandidates.at(it->second));
+        }
+    }
+
+    // Locked coins and wallet spends that never reached the mempool are only known to the wallet
+    LOCK(pwallet->cs_wallet);
+    vCandidatesRet.erase(std::remove_if(vCandidatesRet.begin(), vCandidatesRet.end(), [&](const CStakeCandidate& candidate) {
+        const uint256& hash = candidate.tx->GetHash();
+        return pwallet->IsLockedCoin(hash, candidate.n) || pwallet->IsSpent(hash, candidate.n);
+    }), vCandidatesRet.end());
+    return true;
+}
+
+bool CStakingManager::MintableCoins()
+{
+    if (pwallet == nullptr) return false;
+
+    // the height of the block a stake would be found for, as in SelectStakeCoins
+    int blockHeight;
+    {
+        LOCK(cs_main);
+        blockHeight = chainActive.Height() + 1;
+    }
+
+    std::vector<CStakeCandidate> vCandidates;
+    if (!GetStakeCandidates(blockHeight, false, vCandidates))
+        return false;
+
+    for (const CStakeCandidate& candidate : vCandidates) {
         //check for maturity (min age/depth)
-        if (HasStakeMinAgeOrDepth(blockHeight, GetAdjustedTime(), utxoBlock->nHeight, utxoBlock->GetBlockTime()))
+        if (HasStakeMinAgeOrDepth(blockHeight, GetAdjustedTime(), candidate.pindexFrom->nHeight, candidate.pindexFrom->GetBlockTime()))
             return true;
     }
     return false;
@@ -58,33 +206,28 @@ bool CStakingManager::SelectStakeCoins(std::list<std::unique_ptr<CStakeInput> >&
 {
     if (pwallet == nullptr) return false;
 
-    LOCK2(cs_main, pwallet->cs_wallet);
-    //Add BYTZ
-    std::vector<COutput> vCoins;
-    CCoinControl coin_control;
-    coin_control.nCoinType = CoinType::STAKABLE_COINS;
-    int nMinDepth = blockHeight >= Params().GetConsensus().nBlockStakeModifierV2 ? Params().GetConsensus().nStakeMinDepth : 1;
-    pwallet->AvailableCoins(vCoins, true, &coin_control, 1, MAX_MONEY, MAX_MONEY, 0, nMinDepth);
+    std::vector<CStakeCandidate> vCandidates;
+    if (!GetStakeCandidates(blockHeight, true, vCandidates))
+        return false;
+
     CAmount nAmountSelected = 0;
 
-    for (const COutput &out : vCoins) {
-        //make sure not to outrun target amount
-        if (nAmountSelected + out.tx->tx->vout[out.i].nValue > nTargetAmount)
-            continue;
+    for (const CStakeCandidate& candidate : vCandidates) {
+        const CAmount nValue = candidate.tx->vout[candidate.n].nValue;
 
-        if (out.tx->tx->vin[0].IsZerocoinSpend() && !out.tx->IsInMainChain())
+        //make sure not to outrun target amount
+        if (nAmountSelected + nValue > nTargetAmount)
             continue;
 
-        CBlockIndex* utxoBlock = mapBlockIndex.at(out.tx->hashBlock);
         //check for maturity (min age/depth)
-        if (!HasStakeMinAgeOrDepth(blockHeight, GetAdjustedTime(), utxoBlock->nHeight, utxoBlock->GetBlockTime()))
+        if (!HasStakeMinAgeOrDepth(blockHeight, GetAdjustedTime(), candidate.pindexFrom->nHeight, candidate.pindexFrom->GetBlockTime()))
             continue;
 
         //add to our stake set
-        nAmountSelected += out.tx->tx->vout[out.i].nValue;
+        nAmountSelected += nValue;
 
         std::unique_ptr<CStake> input(new CStake());
-        input->SetInput(out.tx->tx, out.i);
+        input->SetInput(candidate.tx, candidate.n, candidate.pindexFrom);
         listInputs.emplace_back(std::move(input));
     }
     return true;
@@ -130,6 +273,11 @@ bool CStakingManager::Stake(const CBlockIndex* pindexPrev, CStakeInput* stakeInp
             return false;
         }
 
+        // the kernel prefix is the same for every tried time
+        CStakeKernelHasher hasher;
+        if (!hasher.Init(pindexPrev, stakeInput))
+            return error("%s : Failed to calculate the proof of stake hash", __func__);
+
         while (nTryTime > minTime)
         {
             //new block came in, move on
@@ -139,7 +287,7 @@ bool CStakingManager::Stake(const CBlockIndex* pindexPrev, CStakeInput* stakeInp
             --nTryTime;
 
             // if stake hash does not meet the target then continue to next iteration
-            if (!CheckStakeKernelHash(pindexPrev, nBits, stakeInput, nTryTime, hashProofOfStake))
+            if (!CheckStakeKernelHash(hasher, nBits, nTryTime, hashProofOfStake))
                 continue;
 
             // if we made it this far, then we have successfully found a valid kernel hash
@@ -154,38 +302,132 @@ bool CStakingManager::Stake(const CBlockIndex* pindexPrev, CStakeInput* stakeInp
     return fSuccess;
 }
 
-bool CStakingManager::CreateCoinStake(const CBlockIndex* pindexPrev, std::shared_ptr<CMutableTransaction>& coinstakeTx, std::shared_ptr<CStakeInput>& coinstakeInput, int64_t& nTxNewTime) {
-    if (pwallet == nullptr || pindexPrev == nullptr)
+bool CStakingManager::SnapshotStakeInputs(const CBlockIndex* pindexPrev, CAmount nTargetAmount)
+{
+    {
+        LOCK(cs);
+        if (hashSnapshotBlock == pindexPrev->GetBlockHash())
+            return true;
+    }
+
+    std::list<std::unique_ptr<CStakeInput> > listInputs;
+    if (!SelectStakeCoins(listInputs, nTargetAmount, pindexPrev->nHeight + 1))
         return false;
 
-    coinstakeTx->vin.clear();
-    coinstakeTx->vout.clear();
+    auto snapshot = std::make_shared<CStakeSnapshot>();
+    snapshot->vInputs.reserve(listInputs.size());
+    snapshot->vHashers.reserve(listInputs.size());
+    {
+        // Resolve the origin block of every input here, the search workers must not touch chainActive
+        LOCK(cs_main);
+        for (std::unique_ptr<CStakeInput>& stakeInput : listInputs) {
+            CStakeKernelHasher hasher;
+            if (!hasher.Init(pindexPrev, stakeInput.get()))
+                continue;
+            snapshot->vInputs.emplace_back(std::move(stakeInput));
+            snapshot->vHashers.emplace_back(hasher);
+        }
+    }
 
-    // Mark coin stake transaction
-    CScript scriptEmpty;
-    scriptEmpty.clear();
-    coinstakeTx->vout.push_back(CTxOut(0, scriptEmpty));
+    LOCK(cs);
+    stakeSnapshot = snapshot;
+    hashSnapshotBlock = pindexPrev->GetBlockHash();
+    LogPrint(BCLog::STAKING, "%s: %d stakable inputs at height %d\n", __func__, snapshot->vInputs.size(), pindexPrev->nHeight);
+    return true;
+}
 
-    // Choose coins to use
-    CAmount nBalance = pwallet->GetBalance();
+bool CStakingManager::SearchStakeKernel(const CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTimeTx, std::shared_ptr<CStakeInput>& stakeInputRet, uint256& hashProofOfStakeRet)
+{
+    std::shared_ptr<const CStakeSnapshot> snapshot;
+    {
+        LOCK(cs);
+        snapshot = stakeSnapshot;
+    }
+    if (!snapshot)
+        return false;
 
-    if (nBalance > 0 && nBalance <= nReserveBalance)
+    // Each range stops as soon as a lower-indexed winner is known, so the first winning input in
+    // snapshot order is returned regardless of the number of threads
+    const size_t nInputs = snapshot->vInputs.size();
+    std::atomic<size_t> nFirstWinner(nInputs);
+    auto searchRange = [&](size_t nStart, size_t nEnd) -> std::pair<size_t, uint256> {
+        uint256 hashProofOfStake;
+        for (size_t i = nStart; i < nEnd && i < nFirstWinner; i++) {
+            if (!CheckStakeKernelHash(snapshot->vHashers[i], nBits, nTimeTx, hashProofOfStake))
+                continue;
+            size_t nCurrent = nFirstWinner;
+            while (i < nCurrent && !nFirstWinner.compare_exchange_weak(nCurrent, i)) {}
+            return std::make_pair(i, hashProofOfStake);
+        }
+        return std::make_pair(nInputs, uint256());
+    };
+
+    std::vector<std::pair<size_t, uint256> > vResults;
+    if (nStakingThreads <= 1 || nInputs < (size_t)nStakingThreads) {
+        vResults.emplace_back(searchRange(0, nInputs));
+    } else {
+        const size_t nBatchSize = (nInputs + nStakingThreads - 1) / nStakingThreads;
+        std::vector<std::future<std::pair<size_t, uint256> > > futures;
+        for (size_t nStart = 0; nStart < nInputs; nStart += nBatchSize) {
+            const size_t nEnd = std::min(nStart + nBatchSize, nInputs);
+            futures.emplace_back(workerPool.push([&searchRange, nStart, nEnd](int threadId) {
+                return searchRange(nStart, nEnd);
+            }));
+        }
+        for (auto& f : futures) {
+            vResults.emplace_back(f.get());
+        }
+    }
+
+    size_t nWinner = nInputs;
+    for (const auto& result : vResults) {
+        if (result.first < nWinner) {
+            nWinner = result.first;
+            hashProofOfStakeRet = result.second;
+        }
+    }
+    if (nWinner == nInputs)
+        return false;
+
+    stakeInputRet = snapshot->vInputs[nWinner];
+    return true;
+}
+
+bool CStakingManager::FillCoinStake(std::shared_ptr<CMutableTransaction>& coinstakeTx, const std::shared_ptr<CStakeInput>& stakeInput)
+{
+    // Stake output value is set to stake input value.
+    // Adding stake rewards and potentially splitting outputs is performed in BlockAssembler::CreateNewBlock()
+    if (!stakeInput->CreateTxOuts(pwallet, coinstakeTx->vout, stakeInput->GetValue())) {
+        LogPrint(BCLog::STAKING, "%s : failed to get scriptPubKey\n", __func__);
+        return false;
+    }
+
+    // Limit size
+    unsigned int nBytes = ::GetSerializeSize(*coinstakeTx, SER_NETWORK, CTransaction::CURRENT_VERSION);
+    if (nBytes >= MAX_STANDARD_TX_SIZE)
+        return error("CreateCoinStake : exceeded coinstake size limit");
+
+    uint256 hashTxOut = coinstakeTx->GetHash();
+    CTxIn in;
+    if (!stakeInput->CreateTxIn(pwallet, in, hashTxOut)) {
+        LogPrint(BCLog::STAKING, "%s : failed to create TxIn\n", __func__);
+        coinstakeTx->vin.clear();
+        coinstakeTx->vout.clear();
         return false;
+    }
+    coinstakeTx->vin.emplace_back(in);
+    return true;
+}
 
+bool CStakingManager::CreateCoinStakeLegacy(const CBlockIndex* pindexPrev, std::shared_ptr<CMutableTransaction>& coinstakeTx, std::shared_ptr<CStakeInput>& coinstakeInput, int64_t& nTxNewTime, CAmount nTargetAmount)
+{
     // Get the list of stakable inputs
     std::list<std::unique_ptr<CStakeInput> > listInputs;
-    if (!SelectStakeCoins(listInputs, nBalance - nReserveBalance, pindexPrev->nHeight + 1)) {
+    if (!SelectStakeCoins(listInputs, nTargetAmount, pindexPrev->nHeight + 1)) {
         LogPrint(BCLog::STAKING, "CreateCoinStake(): selectStakeCoins failed\n");
         return false;
     }
 
-    if (GetAdjustedTime() - pindexPrev->GetBlockTime() < 60) {
-        if (Params().NetworkIDString() == CBaseChainParams::REGTEST) {
-            MilliSleep(100);
-        }
-    }
-
-    CScript scriptPubKeyKernel;
     bool fKernelFound = false;
     int nAttempts = 0;
 
@@ -205,39 +447,110 @@ bool CStakingManager::CreateCoinStake(const CBlockIndex* pindexPrev, std::shared
             // Found a kernel
             LogPrint(BCLog::STAKING, "CreateCoinStake : kernel found\n");
 
-            // Stake output value is set to stake input value.
-            // Adding stake rewards and potentially splitting outputs is performed in BlockAssembler::CreateNewBlock()
-            if (!stakeInput->CreateTxOuts(pwallet, coinstakeTx->vout, stakeInput->GetValue())) {
-                LogPrint(BCLog::STAKING, "%s : failed to get scriptPubKey\n", __func__);
+            std::shared_ptr<CStakeInput> input = std::move(stakeInput);
+            if (!FillCoinStake(coinstakeTx, input))
                 return false;
-            }
-
-            // Limit size
-            unsigned int nBytes = ::GetSerializeSize(*coinstakeTx, SER_NETWORK, CTransaction::CURRENT_VERSION);
-            if (nBytes >= MAX_STANDARD_TX_SIZE)
-                return error("CreateCoinStake : exceeded coinstake size limit");
-
-            {
-                uint256 hashTxOut = coinstakeTx->GetHash();
-                CTxIn in;
-                if (!stakeInput->CreateTxIn(pwallet, in, hashTxOut)) {
-                    LogPrint(BCLog::STAKING, "%s : failed to create TxIn\n", __func__);
-                    coinstakeTx->vin.clear();
-                    coinstakeTx->vout.clear();
-                    continue;
-                }
-                coinstakeTx->vin.emplace_back(in);
-            }
-            coinstakeInput = std::move(stakeInput);
+            coinstakeInput = input;
             fKernelFound = true;
             break;
         }
     }
     LogPrint(BCLog::STAKING, "%s: attempted staking %d times\n", __func__, nAttempts);
 
-    if (!fKernelFound)
+    return fKernelFound;
+}
+
+bool CStakingManager::CreateCoinStake(const CBlockIndex* pindexPrev, std::shared_ptr<CMutableTransaction>& coinstakeTx, std::shared_ptr<CStakeInput>& coinstakeInput, int64_t& nTxNewTime) {
+    if (pwallet == nullptr || pindexPrev == nullptr)
         return false;
 
+    coinstakeTx->vin.clear();
+    coinstakeTx->vout.clear();
+
+    // Mark coin stake transaction
+    CScript scriptEmpty;
+    scriptEmpty.clear();
+    coinstakeTx->vout.push_back(CTxOut(0, scriptEmpty));
+
+    // Choose coins to use
+    CAmount nBalance = pwallet->GetBalance();
+
+    if (nBalance > 0 && nBalance <= nReserveBalance)
+        return false;
+
+    const Consensus::Params& params = Params().GetConsensus();
+    const int nHeight = pindexPrev->nHeight + 1;
+
+    if (GetAdjustedTime() - pindexPrev->GetBlockTime() < 60) {
+        if (Params().NetworkIDString() == CBaseChainParams::REGTEST) {
+            MilliSleep(100);
+        }
+    }
+
+    // Before time protocol V2 every input searches its own time window, keep the serial search for it
+    if (!params.IsTimeProtocolV2(nHeight))
+        return CreateCoinStakeLegacy(pindexPrev, coinstakeTx, coinstakeInput, nTxNewTime, nBalance - nReserveBalance);
+
+    if (!SnapshotStakeInputs(pindexPrev, nBalance - nReserveBalance)) {
+        LogPrint(BCLog::STAKING, "CreateCoinStake(): selectStakeCoins failed\n");
+        return false;
+    }
+
+    // Make sure the wallet is unlocked and shutdown hasn't been requested
+    if (pwallet->IsLocked(true) || ShutdownRequested())
+        return false;
+
+    // With time protocol V2 all inputs are hashed against the same time slot
+    const int64_t nTimeTx = GetTimeSlot(GetAdjustedTime());
+    // double check that we are not on the same slot as prev block
+    if (nTimeTx <= pindexPrev->nTime && Params().NetworkIDString() != CBaseChainParams::REGTEST)
+        return false;
+
+    CBlockHeader dummyBlockHeader;
+    unsigned int stakeNBits = GetNextWorkRequired(pindexPrev, &dummyBlockHeader, params);
+
+    std::shared_ptr<CStakeInput> stakeInput;
+    uint256 hashProofOfStake;
+    CStakeSearchStats stats;
+    stats.nSlot = nTimeTx;
+    int64_t nTimeStart = GetTimeMicros();
+    stats.fFound = SearchStakeKernel(pindexPrev, stakeNBits, nTimeTx, stakeInput, hashProofOfStake);
+    stats.nDurationMicros = GetTimeMicros() - nTimeStart;
+    {
+        LOCK(cs);
+        stats.nInputs = stakeSnapshot ? stakeSnapshot->vInputs.size() : 0;
+        lastSearchStats = stats;
+    }
+    LogPrint(BCLog::STAKING, "%s: searched %d inputs for slot %d in %.2fms using %d threads, found=%d\n", __func__,
+        stats.nInputs, nTimeTx, stats.nDurationMicros * 0.001, nStakingThreads, stats.fFound);
+
+    mapHashedBlocks.clear();
+    mapHashedBlocks[pindexPrev->nHeight] = GetTime(); //store a time stamp of when we last hashed on this block
+
+    if (!stats.fFound)
+        return false;
+
+    // Found a kernel
+    LogPrint(BCLog::STAKING, "CreateCoinStake : kernel found\n");
+
+    if (!FillCoinStake(coinstakeTx, stakeInput))
+        return false;
+
+    {
+        // The snapshot was taken without holding cs_wallet during the search, make sure the input is still ours to spend
+        LOCK(pwallet->cs_wallet);
+        const COutPoint& prevout = coinstakeTx->vin[0].prevout;
+        if (pwallet->IsSpent(prevout.hash, prevout.n) || pwallet->IsLockedCoin(prevout.hash, prevout.n)) {
+            LogPrint(BCLog::STAKING, "%s: kernel input %s is no longer available\n", __func__, prevout.ToStringShort());
+            LOCK(cs);
+            hashSnapshotBlock.SetNull();
+            return false;
+        }
+    }
+
+    nTxNewTime = nTimeTx;
+    coinstakeInput = stakeInput;
+
     // Successfully generated coinstake
     return true;
 }
@@ -251,6 +564,18 @@ bool CStakingManager::IsStaking() {
     return false;
 }
 
+CStakeSearchStats CStakingManager::GetLastSearchStats()
+{
+    LOCK(cs);
+    return lastSearchStats;
+}
+
+bool CStakingManager::HasStakeCandidate(const COutPoint& outpoint)
+{
+    LOCK(cs);
+    return mapStakeCandidates.count(outpoint) != 0;
+}
+
 void CStakingManager::UpdatedBlockTip(const CBlockIndex* pindex)
 {
     LOCK(cs);
@@ -260,6 +585,97 @@ void CStakingManager::UpdatedBlockTip(const CBlockIndex* pindex)
     LogPrint(BCLog::STAKING, "CStakingManager::UpdatedBlockTip -- height: %d\n", pindex->nHeight);
 }
 
+void CStakingManager::TransactionAddedToMempool(const CTransactionRef& tx)
+{
+    if (pwallet == nullptr || tx->IsCoinBase())
+        return;
+
+    LOCK(cs);
+    for (const CTxIn& txin : tx->vin) {
+        auto it = mapStakeCandidates.find(txin.prevout);
+        if (it == mapStakeCandidates.end())
+            continue;
+        mapCandidatesSpentInMempool.emplace(it->first, it->second);
+        RemoveStakeCandidate(txin.prevout);
+    }
+}
+
+void CStakingManager::TransactionRemovedFromMempool(const CTransactionRef& tx)
+{
+    if (pwallet == nullptr)
+        return;
+
+    // Only called for transactions leaving the mempool without being confirmed (expiry, size limit, reorg, replacement)
+    LOCK(cs);
+    RestoreStakeCandidates(*tx);
+}
+
+void CStakingManager::BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted)
+{
+    if (pwallet == nullptr)
+        return;
+
+    {
+        LOCK(cs);
+        // Blocks up to the last reload are already reflected in the candidate set
+        if (!fCandidatesLoaded || pindex->nHeight <= nCandidatesHeight)
+            return;
+        if (!pindex->pprev || pindex->pprev->GetBlockHash() != hashCandidatesBlock) {
+            // A block was missed, rebuild from the wallet on the next attempt
+            fCandidatesLoaded = false;
+            return;
+        }
+    }
+
+    CBlockIndex* pindexFrom;
+    {
+        LOCK(cs_main);
+        pindexFrom = LookupBlockIndex(pindex->GetBlockHash());
+    }
+    if (!pindexFrom)
+        return;
+
+    std::vector<std::pair<CTransactionRef, unsigned int> > vAdded;
+    for (const CTransactionRef& tx : block->vtx) {
+        for (unsigned int i = 0; i < tx->vout.size(); i++) {
+            if (IsStakeCandidate(tx->vout[i]))
+                vAdded.emplace_back(tx, i);
+        }
+    }
+
+    LOCK(cs);
+    if (!fCandidatesLoaded || pindex->pprev->GetBlockHash() != hashCandidatesBlock)
+        return;
+    // Add the new outputs first, so that those already spent within the block are removed again below
+    for (const auto& p : vAdded) {
+        AddStakeCandidate(p.first, p.second, pindexFrom);
+    }
+    for (const CTransactionRef& tx : block->vtx) {
+        if (tx->IsCoinBase())
+            continue;
+        for (const CTxIn& txin : tx->vin) {
+            RemoveStakeCandidate(txin.prevout);
+            mapCandidatesSpentInMempool.erase(txin.prevout);
+        }
+    }
+    // Inputs of conflicted transactions which the block did not spend are unspent again
+    for (const CTransactionRef& tx : vtxConflicted) {
+        RestoreStakeCandidates(*tx);
+    }
+    hashCandidatesBlock = pindex->GetBlockHash();
+    nCandidatesHeight = pindex->nHeight;
+}
+
+void CStakingManager::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindexDisconnected)
+{
+    if (pwallet == nullptr)
+        return;
+
+    // Outputs spent by the disconnected block are not known here, rebuild from the wallet on the next attempt
+    LOCK(cs);
+    fCandidatesLoaded = false;
+}
+
 void CStakingManager::DoMaintenance(CConnman& connman)
 {
     if (!fEnableStaking) return; // Should never happen
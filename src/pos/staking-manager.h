@@ -7,21 +7,49 @@
 #define STAKING_CLIENT_H
 
 #include "amount.h"
+#include "primitives/transaction.h"
 #include "script/script.h"
 #include "sync.h"
+#include "uint256.h"
 
+#include <ctpl.h>
 #include <univalue.h>
 
+class CBlock;
 class CBlockIndex;
 class CConnman;
 class CMutableTransaction;
 class CStakeInput;
+struct CStakeSnapshot;
 class CStakingManager;
 class CWallet;
-class uint256;
 
 extern std::shared_ptr<CStakingManager> stakingManager;
 
+/** Default for -stakingthreads */
+static const int DEFAULT_STAKING_THREADS = 1;
+/** Maximum number of kernel search threads */
+static const int MAX_STAKING_THREADS = 16;
+
+/** A wallet output that is, or will become, usable as a stake kernel */
+struct CStakeCandidate
+{
+    CTransactionRef tx;
+    unsigned int n;
+    CBlockIndex* pindexFrom;
+    // first block height at which the output passes the depth/maturity checks
+    int nMaturityHeight;
+};
+
+/** Timing of the last kernel search, reported by getstakingstatus */
+struct CStakeSearchStats
+{
+    int64_t nSlot{0};
+    int64_t nDurationMicros{0};
+    size_t nInputs{0};
+    bool fFound{false};
+};
+
 class CStakingManager
 {
 public:
@@ -41,8 +69,44 @@ private:
     unsigned int nExtraNonce;
     const int64_t nHashInterval;
 
+    // Kernel search workers, only used when more than one staking thread is configured
+    ctpl::thread_pool workerPool;
+    int nStakingThreads{DEFAULT_STAKING_THREADS};
+
+    // Stakable inputs, snapshotted once per tip so that the kernel search runs without cs_main/cs_wallet
+    uint256 hashSnapshotBlock;
+    std::shared_ptr<const CStakeSnapshot> stakeSnapshot;
+
+    CStakeSearchStats lastSearchStats;
+
+    // Stake candidates, loaded from the wallet once and then maintained from validation notifications
+    bool fCandidatesLoaded{false};
+    int64_t nCandidatesLoadTime{0};
+    uint256 hashCandidatesBlock;
+    int nCandidatesHeight{-1};
+    std::map<COutPoint, CStakeCandidate> mapStakeCandidates;
+    std::set<std::pair<int, COutPoint> > setCandidatesByMaturity;
+    // Candidates spent by mempool transactions, restored if the spending transaction leaves the mempool unconfirmed
+    std::map<COutPoint, CStakeCandidate> mapCandidatesSpentInMempool;
+
+    bool IsStakeCandidate(const CTxOut& txout) const;
+    void LoadStakeCandidates();
+    void AddStakeCandidate(const CTransactionRef& tx, unsigned int n, CBlockIndex* pindexFrom);
+    void RemoveStakeCandidate(const COutPoint& outpoint);
+    void RestoreStakeCandidates(const CTransaction& tx);
+    bool GetStakeCandidates(int blockHeight, bool fRequireSynced, std::vector<CStakeCandidate>& vCandidatesRet);
+
+    bool SnapshotStakeInputs(const CBlockIndex* pindexPrev, CAmount nTargetAmount);
+    bool SearchStakeKernel(const CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTimeTx, std::shared_ptr<CStakeInput>& stakeInputRet, uint256& hashProofOfStakeRet);
+    bool CreateCoinStakeLegacy(const CBlockIndex* pindexPrev, std::shared_ptr<CMutableTransaction>& coinstakeTx, std::shared_ptr<CStakeInput>& coinstakeInput, int64_t& nTxNewTime, CAmount nTargetAmount);
+    bool FillCoinStake(std::shared_ptr<CMutableTransaction>& coinstakeTx, const std::shared_ptr<CStakeInput>& stakeInput);
+
 public:
     CStakingManager(std::shared_ptr<CWallet> pwalletIn = nullptr);
+    ~CStakingManager();
+
+    void Start(int nThreads);
+    void Stop();
 
     bool fEnableStaking;
     bool fEnableBYTZStaking;
@@ -53,8 +117,15 @@ public:
     bool CreateCoinStake(const CBlockIndex* pindexPrev, std::shared_ptr<CMutableTransaction>& coinstakeTx, std::shared_ptr<CStakeInput>& coinstakeInput, int64_t& nTxNewTime);
     bool Stake(const CBlockIndex* pindexPrev, CStakeInput* stakeInput, unsigned int nBits, int64_t& nTimeTx, uint256& hashProofOfStake);
     bool IsStaking();
+    int GetStakingThreads() const { return nStakingThreads; }
+    CStakeSearchStats GetLastSearchStats();
+    bool HasStakeCandidate(const COutPoint& outpoint);
 
     void UpdatedBlockTip(const CBlockIndex* pindex);
+    void TransactionAddedToMempool(const CTransactionRef& tx);
+    void TransactionRemovedFromMempool(const CTransactionRef& tx);
+    void BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& vtxConflicted);
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindexDisconnected);
 
     void DoMaintenance(CConnman& connman);
 };
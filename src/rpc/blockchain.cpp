@@ -10,6 +10,7 @@
 
 #include <amount.h>
 #include <base58.h>
+#include <blockfilter.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -19,6 +20,8 @@
 #include <consensus/tokengroups.h>
 #include <consensus/validation.h>
 #include <dstencode.h>
+#include <index/blockfilterindex.h>
+#include <index/txindex.h>
 #include <validation.h>
 // #include <rpc/index/txindex.h>
 #include <policy/feerate.h>
@@ -1202,6 +1205,53 @@ UniValue gettxoutsetinfo(const JSONRPCRequest& request)
     return ret;
 }
 
+UniValue getcoinscacheinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getcoinscacheinfo\n"
+            "\nReturns the state of the in-memory UTXO cache and of its flushes to disk.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"entries\": n,            (numeric) The number of coins in the cache\n"
+            "  \"usage\": n,              (numeric) The memory used by the cache in bytes\n"
+            "  \"limit\": n,              (numeric) The memory the cache may use in bytes, set by -dbcache\n"
+            "  \"pressure\": x.xxx,       (numeric) usage as a fraction of limit\n"
+            "  \"hits\": n,               (numeric) The number of lookups answered from the cache\n"
+            "  \"misses\": n,             (numeric) The number of lookups that read the coin database\n"
+            "  \"flushes\": n,            (numeric) The number of flushes since startup\n"
+            "  \"last_flush_time\": ttt,  (numeric) The time of the last flush in seconds since epoch (Jan 1 1970 GMT), 0 if none\n"
+            "  \"last_flush_written\": n, (numeric) The number of modified coins written by the last flush\n"
+            "  \"last_flush_evicted\": n, (numeric) The number of coins evicted from the cache by the last flush\n"
+            "  \"total_written\": n,      (numeric) The number of modified coins written since startup\n"
+            "  \"total_evicted\": n       (numeric) The number of coins evicted since startup\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getcoinscacheinfo", "")
+            + HelpExampleRpc("getcoinscacheinfo", "")
+        );
+
+    CCoinsFlushStats flushStats = GetCoinsFlushStats();
+
+    LOCK(cs_main);
+
+    UniValue ret(UniValue::VOBJ);
+    size_t nUsage = pcoinsTip->DynamicMemoryUsage();
+    ret.pushKV("entries", (int64_t)pcoinsTip->GetCacheSize());
+    ret.pushKV("usage", (int64_t)nUsage);
+    ret.pushKV("limit", (int64_t)nCoinCacheUsage);
+    ret.pushKV("pressure", nCoinCacheUsage > 0 ? (double)nUsage / nCoinCacheUsage : 0.0);
+    ret.pushKV("hits", (int64_t)pcoinsTip->GetCacheHits());
+    ret.pushKV("misses", (int64_t)pcoinsTip->GetCacheMisses());
+    ret.pushKV("flushes", (int64_t)flushStats.nFlushes);
+    ret.pushKV("last_flush_time", flushStats.nLastFlushTime);
+    ret.pushKV("last_flush_written", (int64_t)flushStats.nLastFlushWritten);
+    ret.pushKV("last_flush_evicted", (int64_t)flushStats.nLastFlushEvicted);
+    ret.pushKV("total_written", (int64_t)flushStats.nTotalWritten);
+    ret.pushKV("total_evicted", (int64_t)flushStats.nTotalEvicted);
+    return ret;
+}
+
 UniValue gettxout(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() < 2 || request.params.size() > 3)
@@ -2033,7 +2083,7 @@ static UniValue getblockstats(const JSONRPCRequest& request)
 
         if (loop_inputs) {
 
-            if (!fTxIndex) {
+            if (!g_txindex) {
                 throw JSONRPCError(RPC_INVALID_PARAMETER, "One or more of the selected stats requires -txindex enabled");
             }
             CAmount tx_total_in = 0;
@@ -2671,6 +2721,82 @@ UniValue scantokens(const JSONRPCRequest& request)
     return result;
 }
 
+static UniValue getblockfilter(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 2) {
+        throw std::runtime_error(
+            "getblockfilter \"blockhash\" ( \"filtertype\" )\n"
+            "\nRetrieve a BIP 157 content filter for a particular block.\n"
+            "\nArguments:\n"
+            "1. \"blockhash\"   (string, required) The hash of the block\n"
+            "2. \"filtertype\"  (string, optional, default: \"basic\") The type name of the filter\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"filter\" : (string) the hex-encoded filter data\n"
+            "  \"header\" : (string) the hex-encoded filter header\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getblockfilter", "\"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09\" \"basic\"")
+            + HelpExampleRpc("getblockfilter", "\"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09\", \"basic\"")
+        );
+    }
+
+    uint256 block_hash = ParseHashV(request.params[0], "blockhash");
+    std::string filtertype_name = "basic";
+    if (!request.params[1].isNull()) {
+        filtertype_name = request.params[1].get_str();
+    }
+
+    BlockFilterType filtertype;
+    if (!BlockFilterTypeByName(filtertype_name, filtertype)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown filtertype");
+    }
+
+    BlockFilterIndex* index = GetBlockFilterIndex(filtertype);
+    if (!index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Index is not enabled for filtertype " + filtertype_name);
+    }
+
+    const CBlockIndex* block_index;
+    bool block_was_connected;
+    {
+        LOCK(cs_main);
+        block_index = LookupBlockIndex(block_hash);
+        if (!block_index) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
+        }
+        block_was_connected = block_index->IsValid(BLOCK_VALID_SCRIPTS);
+    }
+
+    bool index_ready = index->BlockUntilSyncedToCurrentChain();
+
+    BlockFilter filter;
+    uint256 filter_header;
+    if (!index->LookupFilter(block_index, filter) ||
+        !index->LookupFilterHeader(block_index, filter_header)) {
+        int err_code;
+        std::string errmsg = "Filter not found.";
+
+        if (!block_was_connected) {
+            err_code = RPC_INVALID_ADDRESS_OR_KEY;
+            errmsg += " Block was not connected to active chain.";
+        } else if (!index_ready) {
+            err_code = RPC_MISC_ERROR;
+            errmsg += " Block filters are still in the process of being indexed.";
+        } else {
+            err_code = RPC_INTERNAL_ERROR;
+            errmsg += " This error is unexpected and indicates index corruption.";
+        }
+
+        throw JSONRPCError(err_code, errmsg);
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("filter", HexStr(filter.GetEncodedFilter()));
+    ret.pushKV("header", filter_header.GetHex());
+    return ret;
+}
+
 static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
@@ -2681,6 +2807,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getbestchainlock",       &getbestchainlock,       {} },
     { "blockchain",         "getblockcount",          &getblockcount,          {} },
     { "blockchain",         "getblock",               &getblock,               {"blockhash","verbosity|verbose"} },
+    { "blockchain",         "getblockfilter",         &getblockfilter,         {"blockhash", "filtertype"} },
     { "blockchain",         "getblockhashes",         &getblockhashes,         {"high","low"} },
     { "blockchain",         "getblockhash",           &getblockhash,           {"height"} },
     { "blockchain",         "getblockheader",         &getblockheader,         {"blockhash","verbose"} },
@@ -2696,6 +2823,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getspecialtxes",         &getspecialtxes,         {"blockhash", "type", "count", "skip", "verbosity"} },
     { "blockchain",         "gettxout",               &gettxout,               {"txid","n","include_mempool"} },
     { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        {} },
+    { "blockchain",         "getcoinscacheinfo",      &getcoinscacheinfo,      {} },
     { "blockchain",         "pruneblockchain",        &pruneblockchain,        {"height"} },
     { "blockchain",         "savemempool",            &savemempool,            {} },
     { "blockchain",         "verifychain",            &verifychain,            {"checklevel","nblocks"} },
@@ -190,6 +190,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "createrawtokentransaction", 2, "token_outputs" },
     { "createrawtokentransaction", 3, "locktime" },
     { "encodetokenmetadata", 0, "spec" },
+    { "listtokenholders", 1, "count" },
+    { "listtokenholders", 2, "skip" },
     { "signtokenmetadata", 2, "verbose" },
     { "listunspenttokens", 0, "groupid" },
     { "listunspenttokens", 1, "minconf" },
@@ -339,11 +339,16 @@ UniValue masternode_winners(const JSONRPCRequest& request)
     int nChainTipHeight = pindexTip->nHeight;
     int nStartHeight = std::max(nChainTipHeight - nCount, 1);
 
-    for (int h = nStartHeight; h <= nChainTipHeight; h++) {
-        auto payee = deterministicMNManager->GetListForBlock(pindexTip->GetAncestor(h - 1)).GetMNPayee();
-        std::string strPayments = GetRequiredPaymentsString(h, payee);
-        if (strFilter != "" && strPayments.find(strFilter) == std::string::npos) continue;
-        obj.pushKV(strprintf("%d", h), strPayments);
+    if (nStartHeight <= nChainTipHeight) {
+        int h = nStartHeight;
+        deterministicMNManager->ForEachListInRange(pindexTip->GetAncestor(nStartHeight - 1), pindexTip->pprev, [&](const CDeterministicMNList& mnList) {
+            std::string strPayments = GetRequiredPaymentsString(h, mnList.GetMNPayee());
+            if (strFilter == "" || strPayments.find(strFilter) != std::string::npos) {
+                obj.pushKV(strprintf("%d", h), strPayments);
+            }
+            h++;
+            return true;
+        });
     }
 
     auto projection = deterministicMNManager->GetListForBlock(pindexTip).GetProjectedMNPayees(20);
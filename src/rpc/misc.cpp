@@ -972,6 +972,16 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCProofOfStakeCacheInfo()
+{
+    LOCK(cs_main);
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", uint64_t(mapProofOfStake.size()));
+    obj.pushKV("max_entries", uint64_t(mapProofOfStake.max_size()));
+    obj.pushKV("usage", uint64_t(mapProofOfStake.DynamicUsage()));
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -1013,6 +1023,11 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"proofofstake\": {         (json object) Information about the proof-of-stake hash cache\n"
+            "    \"entries\": xxxxx,       (numeric) Number of cached proof-of-stake hashes\n"
+            "    \"max_entries\": xxxxx,   (numeric) Number of entries kept after the cache is trimmed\n"
+            "    \"usage\": xxxxx,         (numeric) Estimated memory usage in bytes\n"
             "  }\n"
             "}\n"
             "\nResult (mode \"mallocinfo\"):\n"
@@ -1026,6 +1041,7 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        obj.pushKV("proofofstake", RPCProofOfStakeCacheInfo());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
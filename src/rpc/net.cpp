@@ -8,6 +8,7 @@
 #include <chainparams.h>
 #include <clientversion.h>
 #include <core_io.h>
+#include <evo/simplifiedmns.h>
 #include <validation.h>
 #include <net.h>
 #include <net_processing.h>
@@ -117,6 +118,15 @@ UniValue getpeerinfo(const JSONRPCRequest& request)
             "    \"bytesrecv_per_msg\": {\n"
             "       \"addr\": n,              (numeric) The total bytes received aggregated by message type\n"
             "       ...\n"
+            "    },\n"
+            "    \"processtime_per_msg\": {\n"
+            "       \"addr\": {              (json object) Processing time of the received messages of this type\n"
+            "         \"count\": n,          (numeric) The number of messages processed\n"
+            "         \"total_us\": n,       (numeric) The total processing time in microseconds\n"
+            "         \"max_us\": n,         (numeric) The longest processing time in microseconds\n"
+            "         \"histogram\": [n,...] (numeric) Message counts by processing time, entry i counts times below 2^i microseconds not counted by an earlier entry\n"
+            "       },\n"
+            "       ...\n"
             "    }\n"
             "  }\n"
             "  ,...\n"
@@ -199,6 +209,21 @@ UniValue getpeerinfo(const JSONRPCRequest& request)
         }
         obj.pushKV("bytesrecv_per_msg", recvPerMsgCmd);
 
+        UniValue processTimePerMsgCmd(UniValue::VOBJ);
+        for (const mapMsgCmdProcessTime::value_type &i : stats.mapProcessTimePerMsgCmd) {
+            UniValue timeObj(UniValue::VOBJ);
+            timeObj.pushKV("count", i.second.nCount);
+            timeObj.pushKV("total_us", i.second.nTotalUsec);
+            timeObj.pushKV("max_us", i.second.nMaxUsec);
+            UniValue histogram(UniValue::VARR);
+            for (uint64_t nBucketCount : i.second.vBuckets) {
+                histogram.push_back(nBucketCount);
+            }
+            timeObj.pushKV("histogram", histogram);
+            processTimePerMsgCmd.pushKV(i.first, timeObj);
+        }
+        obj.pushKV("processtime_per_msg", processTimePerMsgCmd);
+
         ret.push_back(obj);
     }
 
@@ -467,6 +492,11 @@ UniValue getnetworkinfo(const JSONRPCRequest& request)
             "  }\n"
             "  ,...\n"
             "  ]\n"
+            "  \"mnlistdiffcache\": {                 (json object) cache of mnlistdiff responses\n"
+            "    \"size\": xxx,                         (numeric) number of cached responses\n"
+            "    \"hits\": xxx,                         (numeric) requests served from the cache\n"
+            "    \"misses\": xxx                        (numeric) requests which built the response\n"
+            "  }\n"
             "  \"warnings\": \"...\"                    (string) any network and blockchain warnings\n"
             "}\n"
             "\nExamples:\n"
@@ -522,6 +552,11 @@ UniValue getnetworkinfo(const JSONRPCRequest& request)
         }
     }
     obj.pushKV("localaddresses", localAddresses);
+    UniValue mnListDiffCacheObj(UniValue::VOBJ);
+    mnListDiffCacheObj.pushKV("size", (uint64_t)mnListDiffCache.Size());
+    mnListDiffCacheObj.pushKV("hits", mnListDiffCache.GetHits());
+    mnListDiffCacheObj.pushKV("misses", mnListDiffCache.GetMisses());
+    obj.pushKV("mnlistdiffcache", mnListDiffCacheObj);
     obj.pushKV("warnings",       GetWarnings("statusbar"));
     return obj;
 }
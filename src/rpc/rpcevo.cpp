@@ -29,6 +29,8 @@
 
 #include <bls/bls.h>
 
+#include <llmq/quorums_commitment.h>
+
 #include <masternode/masternode-meta.h>
 
 #ifdef ENABLE_WALLET
@@ -1358,11 +1360,13 @@ UniValue protx_diff(const JSONRPCRequest& request)
     uint256 baseBlockHash = ParseBlock(request.params[1], "baseBlock");
     uint256 blockHash = ParseBlock(request.params[2], "block");
 
-    CSimplifiedMNListDiff mnListDiff;
+    std::vector<unsigned char> payload;
     std::string strError;
-    if (!BuildSimplifiedMNListDiff(baseBlockHash, blockHash, mnListDiff, strError)) {
+    if (!mnListDiffCache.GetPayload(baseBlockHash, blockHash, PROTOCOL_VERSION, payload, strError)) {
         throw std::runtime_error(strError);
     }
+    CSimplifiedMNListDiff mnListDiff;
+    CDataStream(payload, SER_NETWORK, PROTOCOL_VERSION) >> mnListDiff;
 
     UniValue ret;
     mnListDiff.ToJson(ret);
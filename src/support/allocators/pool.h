@@ -0,0 +1,230 @@
+// Copyright (c) 2022 The Bitcoin Core developers
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_POOL_H
+#define BITCOIN_SUPPORT_ALLOCATORS_POOL_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A memory resource for the nodes of node based containers such as std::unordered_map.
+ *
+ * Memory is taken from the system in large chunks and carved into blocks that are a multiple of
+ * ELEM_ALIGN_BYTES. Freed blocks are kept in one singly linked free list per block size and are
+ * reused by the next allocation of the same size, so a container that keeps inserting and
+ * erasing does not go through malloc for every node. Chunks are only returned to the system
+ * when the resource is destroyed.
+ *
+ * Allocations larger than MAX_BLOCK_SIZE_BYTES, or with a stricter alignment than the pool
+ * provides, are forwarded to ::operator new. For std::unordered_map this only concerns the
+ * bucket array once it grows large.
+ *
+ * The resource is not thread safe and must outlive every container that uses it.
+ */
+template <std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+class PoolResource final
+{
+    static_assert(ALIGN_BYTES > 0, "ALIGN_BYTES must be nonzero");
+    static_assert((ALIGN_BYTES & (ALIGN_BYTES - 1)) == 0, "ALIGN_BYTES must be a power of two");
+
+    /** Free blocks are linked through their own memory. */
+    struct ListNode {
+        ListNode* m_next;
+
+        explicit ListNode(ListNode* next) : m_next(next) {}
+    };
+    static_assert(std::is_trivially_destructible<ListNode>::value, "ListNode is reused as raw memory");
+
+    /** Every block size is a multiple of this, and so is every block address inside a chunk. */
+    static constexpr std::size_t ELEM_ALIGN_BYTES = std::max(alignof(ListNode), ALIGN_BYTES);
+    static_assert((ELEM_ALIGN_BYTES & (ELEM_ALIGN_BYTES - 1)) == 0, "ELEM_ALIGN_BYTES must be a power of two");
+    static_assert(sizeof(ListNode) <= ELEM_ALIGN_BYTES, "a block of ELEM_ALIGN_BYTES must be able to hold a ListNode");
+    static_assert((MAX_BLOCK_SIZE_BYTES & (ELEM_ALIGN_BYTES - 1)) == 0, "MAX_BLOCK_SIZE_BYTES must be a multiple of the alignment");
+    static_assert(ELEM_ALIGN_BYTES <= alignof(std::max_align_t), "chunks from ::operator new are only aligned to max_align_t");
+
+    /** Size of each chunk taken from the system, a multiple of ELEM_ALIGN_BYTES. */
+    const std::size_t m_chunk_size_bytes;
+
+    /** All chunks taken from the system, freed in the destructor. */
+    std::list<char*> m_allocated_chunks;
+
+    /** Free list per block size, indexed by the number of ELEM_ALIGN_BYTES in a block. */
+    std::array<ListNode*, MAX_BLOCK_SIZE_BYTES / ELEM_ALIGN_BYTES + 1> m_free_lists;
+
+    /** Bytes held by the blocks on the free lists. */
+    std::size_t m_free_list_bytes = 0;
+
+    /** Untouched memory at the end of the newest chunk. */
+    char* m_available_memory_it = nullptr;
+    char* m_available_memory_end = nullptr;
+
+    static constexpr std::size_t NumElemAlignBytes(std::size_t bytes)
+    {
+        return (bytes + ELEM_ALIGN_BYTES - 1) / ELEM_ALIGN_BYTES + (bytes == 0);
+    }
+
+    static constexpr bool IsFreeListUsable(std::size_t bytes, std::size_t alignment)
+    {
+        return alignment <= ELEM_ALIGN_BYTES && bytes <= MAX_BLOCK_SIZE_BYTES;
+    }
+
+    static void PlacementAddToList(void* p, ListNode*& node)
+    {
+        node = new (p) ListNode(node);
+    }
+
+    void AllocateChunk()
+    {
+        // Whatever is left of the current chunk becomes a free block of its size. It is always a
+        // multiple of ELEM_ALIGN_BYTES and smaller than the largest block.
+        const std::size_t remaining_available_bytes = m_available_memory_end - m_available_memory_it;
+        if (remaining_available_bytes != 0) {
+            PlacementAddToList(m_available_memory_it, m_free_lists[remaining_available_bytes / ELEM_ALIGN_BYTES]);
+            m_free_list_bytes += remaining_available_bytes;
+        }
+
+        m_available_memory_it = static_cast<char*>(::operator new(m_chunk_size_bytes));
+        m_available_memory_end = m_available_memory_it + m_chunk_size_bytes;
+        m_allocated_chunks.emplace_back(m_available_memory_it);
+    }
+
+    friend class PoolResourceTester;
+
+public:
+    /** Construct a resource that takes chunks of at least chunk_size_bytes from the system. */
+    explicit PoolResource(std::size_t chunk_size_bytes)
+        : m_chunk_size_bytes(NumElemAlignBytes(chunk_size_bytes) * ELEM_ALIGN_BYTES)
+    {
+        assert(m_chunk_size_bytes >= MAX_BLOCK_SIZE_BYTES);
+        m_free_lists.fill(nullptr);
+        AllocateChunk();
+    }
+
+    /** Construct a resource with 256 KiB chunks. */
+    PoolResource() : PoolResource(262144) {}
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    ~PoolResource()
+    {
+        for (char* chunk : m_allocated_chunks) {
+            ::operator delete(chunk);
+        }
+    }
+
+    void* Allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (IsFreeListUsable(bytes, alignment)) {
+            const std::size_t num_alignments = NumElemAlignBytes(bytes);
+            if (m_free_lists[num_alignments] != nullptr) {
+                // Unlink the head of the free list; ListNode is trivially destructible, so its
+                // memory can be handed out as is.
+                m_free_list_bytes -= num_alignments * ELEM_ALIGN_BYTES;
+                return std::exchange(m_free_lists[num_alignments], m_free_lists[num_alignments]->m_next);
+            }
+
+            // The free list is empty, carve a new block out of the current chunk.
+            const std::ptrdiff_t round_bytes = static_cast<std::ptrdiff_t>(num_alignments * ELEM_ALIGN_BYTES);
+            if (round_bytes > m_available_memory_end - m_available_memory_it) {
+                AllocateChunk();
+            }
+            return std::exchange(m_available_memory_it, m_available_memory_it + round_bytes);
+        }
+
+        assert(alignment <= alignof(std::max_align_t));
+        return ::operator new(bytes);
+    }
+
+    void Deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (IsFreeListUsable(bytes, alignment)) {
+            PlacementAddToList(p, m_free_lists[NumElemAlignBytes(bytes)]);
+            m_free_list_bytes += NumElemAlignBytes(bytes) * ELEM_ALIGN_BYTES;
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    /** Number of chunks taken from the system. */
+    std::size_t NumAllocatedChunks() const { return m_allocated_chunks.size(); }
+
+    /** Bytes of freed blocks waiting to be reused, which are taken before another chunk is. */
+    std::size_t NumFreeListBytes() const { return m_free_list_bytes; }
+
+    /** Size of each chunk taken from the system. */
+    std::size_t ChunkSizeBytes() const { return m_chunk_size_bytes; }
+
+    /** Largest request served from the pool; anything bigger goes to ::operator new. */
+    static constexpr std::size_t MaxBlockSizeBytes() { return MAX_BLOCK_SIZE_BYTES; }
+};
+
+/**
+ * Allocator for node based containers that takes its memory from a PoolResource. Copies, and
+ * rebound copies used by the container for its nodes and buckets, share the same resource.
+ */
+template <class T, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES = alignof(T)>
+class PoolAllocator
+{
+    PoolResource<MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>* m_resource;
+
+    template <typename U, std::size_t M, std::size_t A>
+    friend class PoolAllocator;
+
+public:
+    typedef T value_type;
+    typedef PoolResource<MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES> ResourceType;
+
+    /** Implicit, so that containers can be constructed directly from a resource pointer. */
+    PoolAllocator(ResourceType* resource) noexcept : m_resource(resource) {}
+
+    PoolAllocator(const PoolAllocator& other) noexcept = default;
+    PoolAllocator& operator=(const PoolAllocator& other) noexcept = default;
+
+    template <class U>
+    PoolAllocator(const PoolAllocator<U, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& other) noexcept : m_resource(other.resource())
+    {
+    }
+
+    template <typename U>
+    struct rebind {
+        typedef PoolAllocator<U, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES> other;
+    };
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(m_resource->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        m_resource->Deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    ResourceType* resource() const noexcept { return m_resource; }
+};
+
+template <class T1, class T2, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+bool operator==(const PoolAllocator<T1, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& a,
+                const PoolAllocator<T2, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& b) noexcept
+{
+    return a.resource() == b.resource();
+}
+
+template <class T1, class T2, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+bool operator!=(const PoolAllocator<T1, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& a,
+                const PoolAllocator<T2, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& b) noexcept
+{
+    return !(a == b);
+}
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_POOL_H
@@ -4,10 +4,13 @@
 
 #include <util.h>
 
+#include <memusage.h>
+#include <support/allocators/pool.h>
 #include <support/allocators/secure.h>
 #include <test/test_bytz.h>
 
 #include <memory>
+#include <unordered_map>
 
 #include <boost/test/unit_test.hpp>
 
@@ -233,4 +236,65 @@ BOOST_AUTO_TEST_CASE(lockedpool_tests_live)
     BOOST_CHECK(pool.stats().used == initial.used);
 }
 
+BOOST_AUTO_TEST_CASE(pool_resource_reuse)
+{
+    PoolResource<64, 8> resource(1024);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+
+    // Blocks are carved from the chunk and a freed block is handed out again for the same size.
+    void* a = resource.Allocate(8, 8);
+    void* b = resource.Allocate(8, 8);
+    BOOST_CHECK(a != b);
+    BOOST_CHECK_EQUAL(static_cast<char*>(b) - static_cast<char*>(a), 8);
+    resource.Deallocate(a, 8, 8);
+    BOOST_CHECK(resource.Allocate(8, 8) == a);
+
+    // Sizes are rounded up to the alignment, so 9 and 16 bytes share a free list.
+    void* c = resource.Allocate(9, 8);
+    resource.Deallocate(c, 9, 8);
+    BOOST_CHECK(resource.Allocate(16, 8) == c);
+
+    // A request larger than a block bypasses the pool.
+    void* big = resource.Allocate(128, 8);
+    resource.Deallocate(big, 128, 8);
+
+    // Filling the chunk takes a new one from the system.
+    for (int i = 0; i < 1024 / 64; i++) {
+        resource.Allocate(64, 8);
+    }
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(pool_allocator_unordered_map)
+{
+    typedef std::unordered_map<int, int64_t, std::hash<int>, std::equal_to<int>,
+                               PoolAllocator<std::pair<const int, int64_t>, 64> > Map;
+    Map::allocator_type::ResourceType resource(4096);
+    size_t usage_empty;
+    {
+        Map map(0, Map::hasher(), Map::key_equal(), &resource);
+        usage_empty = memusage::DynamicUsage(map);
+        for (int i = 0; i < 10000; i++) {
+            map[i] = i;
+        }
+        BOOST_CHECK(resource.NumAllocatedChunks() > 1);
+        BOOST_CHECK(memusage::DynamicUsage(map) > usage_empty);
+
+        // Erased nodes go back to the pool, so refilling the map takes no new chunks.
+        const size_t chunks = resource.NumAllocatedChunks();
+        const size_t usage_full = memusage::DynamicUsage(map);
+        for (int i = 0; i < 10000; i++) {
+            map.erase(i);
+        }
+        BOOST_CHECK(resource.NumFreeListBytes() >= 10000 * sizeof(memusage::unordered_node<Map::value_type>));
+        BOOST_CHECK(memusage::DynamicUsage(map) < usage_full);
+        for (int i = 0; i < 10000; i++) {
+            map[i + 10000] = i;
+        }
+        BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), chunks);
+        BOOST_CHECK_EQUAL(map.size(), 10000U);
+    }
+    BOOST_CHECK(resource.NumAllocatedChunks() > 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
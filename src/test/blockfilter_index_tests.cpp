@@ -0,0 +1,147 @@
+// Copyright (c) 2017-2018 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockfilter.h>
+#include <chainparams.h>
+#include <index/blockfilterindex.h>
+#include <test/test_bytz.h>
+#include <undo.h>
+#include <utiltime.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(blockfilter_index_tests)
+
+static bool ComputeFilter(BlockFilterType filter_type, const CBlockIndex* block_index,
+                          BlockFilter& filter)
+{
+    CBlock block;
+    if (!ReadBlockFromDisk(block, block_index, Params().GetConsensus())) {
+        return false;
+    }
+
+    CBlockUndo block_undo;
+    if (block_index->nHeight > 0 && !UndoReadFromDisk(block_undo, block_index)) {
+        return false;
+    }
+
+    filter = BlockFilter(filter_type, block, block_undo);
+    return true;
+}
+
+static bool CheckFilterLookups(BlockFilterIndex& filter_index, const CBlockIndex* block_index,
+                               uint256& last_header)
+{
+    BlockFilter expected_filter;
+    if (!ComputeFilter(filter_index.GetFilterType(), block_index, expected_filter)) {
+        BOOST_ERROR("ComputeFilter failed on block " << block_index->nHeight);
+        return false;
+    }
+
+    BlockFilter filter;
+    uint256 filter_header;
+    std::vector<BlockFilter> filters;
+    std::vector<uint256> filter_hashes;
+
+    BOOST_CHECK(filter_index.LookupFilter(block_index, filter));
+    BOOST_CHECK(filter_index.LookupFilterHeader(block_index, filter_header));
+    BOOST_CHECK(filter_index.LookupFilterRange(block_index->nHeight, block_index, filters));
+    BOOST_CHECK(filter_index.LookupFilterHashRange(block_index->nHeight, block_index,
+                                                   filter_hashes));
+
+    BOOST_CHECK_EQUAL(filters.size(), 1);
+    BOOST_CHECK_EQUAL(filter_hashes.size(), 1);
+
+    BOOST_CHECK(filter.GetHash() == expected_filter.GetHash());
+    BOOST_CHECK(filter_header == expected_filter.ComputeHeader(last_header));
+    BOOST_CHECK(filters[0].GetHash() == expected_filter.GetHash());
+    BOOST_CHECK(filter_hashes[0] == expected_filter.GetHash());
+
+    last_header = filter_header;
+    return true;
+}
+
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, TestChain100Setup)
+{
+    BlockFilterIndex filter_index(BlockFilterType::BASIC_FILTER, 1 << 20, true);
+
+    uint256 last_header;
+
+    // Filter should not be found in the index before it is started.
+    {
+        LOCK(cs_main);
+
+        BlockFilter filter;
+        uint256 filter_header;
+        std::vector<BlockFilter> filters;
+        std::vector<uint256> filter_hashes;
+
+        for (const CBlockIndex* block_index = chainActive.Genesis();
+             block_index != nullptr;
+             block_index = chainActive.Next(block_index)) {
+            BOOST_CHECK(!filter_index.LookupFilter(block_index, filter));
+            BOOST_CHECK(!filter_index.LookupFilterHeader(block_index, filter_header));
+            BOOST_CHECK(!filter_index.LookupFilterRange(block_index->nHeight, block_index, filters));
+            BOOST_CHECK(!filter_index.LookupFilterHashRange(block_index->nHeight, block_index,
+                                                            filter_hashes));
+        }
+    }
+
+    // BlockUntilSyncedToCurrentChain should return false before index is started.
+    BOOST_CHECK(!filter_index.BlockUntilSyncedToCurrentChain());
+
+    filter_index.Start();
+
+    // Allow filter index to catch up with the block index.
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!filter_index.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        MilliSleep(100);
+    }
+
+    // Check that filter index has all blocks that were in the chain before it started.
+    {
+        LOCK(cs_main);
+        for (const CBlockIndex* block_index = chainActive.Genesis();
+             block_index != nullptr;
+             block_index = chainActive.Next(block_index)) {
+            CheckFilterLookups(filter_index, block_index, last_header);
+        }
+    }
+
+    // Blocks connected after the initial sync are indexed from the validation notifications.
+    for (int i = 0; i < 10; i++) {
+        CreateAndProcessBlock({}, coinbaseKey);
+    }
+    BOOST_CHECK(filter_index.BlockUntilSyncedToCurrentChain());
+
+    {
+        LOCK(cs_main);
+        const CBlockIndex* tip = chainActive.Tip();
+        for (const CBlockIndex* block_index = chainActive[tip->nHeight - 9];
+             block_index != nullptr;
+             block_index = chainActive.Next(block_index)) {
+            CheckFilterLookups(filter_index, block_index, last_header);
+        }
+
+        // Range lookups over the whole chain return one entry per block, in height order.
+        std::vector<BlockFilter> filters;
+        std::vector<uint256> filter_hashes;
+        BOOST_CHECK(filter_index.LookupFilterRange(0, tip, filters));
+        BOOST_CHECK(filter_index.LookupFilterHashRange(0, tip, filter_hashes));
+        BOOST_CHECK_EQUAL(filters.size(), tip->nHeight + 1);
+        BOOST_CHECK_EQUAL(filter_hashes.size(), tip->nHeight + 1);
+        BOOST_CHECK(filters.back().GetBlockHash() == tip->GetBlockHash());
+        BOOST_CHECK(filter_hashes.back() == filters.back().GetHash());
+
+        // The start height must not be past the stop block.
+        BOOST_CHECK(!filter_index.LookupFilterRange(tip->nHeight + 1, tip, filters));
+    }
+
+    filter_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
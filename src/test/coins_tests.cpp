@@ -53,7 +53,7 @@ public:
 
     uint256 GetBestBlock() const override { return hashBestBlock_; }
 
-    bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock) override
+    bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, bool erase) override
     {
         for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end(); ) {
             if (it->second.flags & CCoinsCacheEntry::DIRTY) {
@@ -64,7 +64,7 @@ public:
                     map_.erase(it->first);
                 }
             }
-            mapCoins.erase(it++);
+            it = erase ? mapCoins.erase(it) : std::next(it);
         }
         if (!hashBlock.IsNull())
             hashBestBlock_ = hashBlock;
@@ -211,7 +211,14 @@ BOOST_AUTO_TEST_CASE(coins_cache_simulation_test)
             // Every 100 iterations, flush an intermediate cache
             if (stack.size() > 1 && InsecureRandBool() == 0) {
                 unsigned int flushIndex = InsecureRandRange(stack.size() - 1);
-                stack[flushIndex]->Flush();
+                if (InsecureRandBool()) {
+                    stack[flushIndex]->Flush();
+                } else {
+                    // Write the modified entries only and evict some of the clean ones
+                    size_t nWritten;
+                    stack[flushIndex]->Sync(nWritten);
+                    stack[flushIndex]->Trim(stack[flushIndex]->DynamicMemoryUsage() / 2);
+                }
             }
         }
         if (InsecureRandRange(100) == 0) {
@@ -587,9 +594,10 @@ void GetCoinsMapEntry(const CCoinsMap& map, CAmount& value, char& flags)
 
 void WriteCoinsViewEntry(CCoinsView& view, CAmount value, char flags)
 {
-    CCoinsMap map;
+    CCoinsMapMemoryResource resource;
+    CCoinsMap map(0, CCoinsMap::hasher(), CCoinsMap::key_equal(), &resource);
     InsertCoinsMapEntry(map, value, flags);
-    view.BatchWrite(map, {});
+    view.BatchWrite(map, {}, true);
 }
 
 class SingleEntryCacheTest
@@ -856,4 +864,77 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_sync_trim)
+{
+    CCoinsViewTest base;
+    CCoinsViewCacheTest cache(&base);
+    const int nCoins = 20000;
+
+    std::vector<COutPoint> outpoints;
+    for (int i = 0; i < nCoins; i++) {
+        outpoints.emplace_back(InsecureRand256(), 0);
+        CTxOut out(CENT, CScript() << OP_TRUE);
+        cache.AddCoin(outpoints.back(), Coin(std::move(out), i + 1, false, false), false);
+    }
+
+    // Sync writes everything to the base and keeps the coins as clean entries.
+    size_t nWritten = 0;
+    BOOST_CHECK(cache.Sync(nWritten));
+    BOOST_CHECK_EQUAL(nWritten, (size_t)nCoins);
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), (unsigned int)nCoins);
+    for (const auto& entry : cache.map()) {
+        BOOST_CHECK_EQUAL(entry.second.flags, 0);
+    }
+    Coin coin;
+    BOOST_CHECK(base.GetCoin(outpoints[0], coin));
+    cache.SelfTest();
+
+    // A spent coin is written once more and then dropped.
+    BOOST_CHECK(cache.SpendCoin(outpoints[1]));
+    BOOST_CHECK(cache.Sync(nWritten));
+    BOOST_CHECK_EQUAL(nWritten, 1U);
+    BOOST_CHECK(!cache.HaveCoinInCache(outpoints[1]));
+    BOOST_CHECK(!base.GetCoin(outpoints[1], coin) || coin.IsSpent());
+
+    // Trim evicts the oldest clean coins and never a modified one.
+    CTxOut out(CENT, CScript() << OP_TRUE);
+    COutPoint dirty(InsecureRand256(), 0);
+    cache.AddCoin(dirty, Coin(std::move(out), 0, false, false), false);
+    const size_t nTarget = cache.DynamicMemoryUsage() / 2;
+    size_t nEvicted = cache.Trim(nTarget);
+    BOOST_CHECK(nEvicted > 0);
+    BOOST_CHECK(cache.DynamicMemoryUsage() <= nTarget);
+    BOOST_CHECK(cache.HaveCoinInCache(dirty));
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), (unsigned int)(nCoins - 1 + 1 - nEvicted));
+    BOOST_CHECK(!cache.HaveCoinInCache(outpoints[0]));
+    BOOST_CHECK(cache.HaveCoinInCache(outpoints[nCoins - 1]));
+    cache.SelfTest();
+
+    // Evicted coins are still available from the base.
+    BOOST_CHECK(cache.HaveCoin(outpoints[0]));
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_prefetch)
+{
+    CCoinsViewTest base;
+    CCoinsViewCacheTest cache(&base);
+
+    COutPoint outpoint(InsecureRand256(), 0);
+    CTxOut out(CENT, CScript() << OP_TRUE);
+    cache.AddPrefetchedCoin(outpoint, Coin(std::move(out), 1, false, false));
+
+    // The coin is cached unmodified, as if it had been read on first access.
+    BOOST_CHECK(cache.HaveCoinInCache(outpoint));
+    BOOST_CHECK_EQUAL(cache.map().at(outpoint).flags, 0);
+    BOOST_CHECK_EQUAL(cache.AccessCoin(outpoint).nHeight, 1U);
+    BOOST_CHECK_EQUAL(cache.GetCacheHits(), 1U);
+    BOOST_CHECK_EQUAL(cache.GetCacheMisses(), 0U);
+
+    // A cached coin is not replaced.
+    CTxOut other(2 * CENT, CScript() << OP_TRUE);
+    cache.AddPrefetchedCoin(outpoint, Coin(std::move(other), 2, false, false));
+    BOOST_CHECK_EQUAL(cache.AccessCoin(outpoint).out.nValue, CENT);
+    cache.SelfTest();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -228,6 +228,66 @@ static bool CheckTransactionSignature(const CMutableTransaction& tx)
     return true;
 }
 
+// the payment order as it was found before the list kept it: by sorting all valid MNs
+static int CompareByLastPaid_GetHeight(const CDeterministicMN& dmn)
+{
+    int height = dmn.pdmnState->nLastPaidHeight;
+    if (dmn.pdmnState->nPoSeRevivedHeight != -1 && dmn.pdmnState->nPoSeRevivedHeight > height) {
+        height = dmn.pdmnState->nPoSeRevivedHeight;
+    } else if (height == 0) {
+        height = dmn.pdmnState->nRegisteredHeight;
+    }
+    return height;
+}
+
+static std::vector<CDeterministicMNCPtr> SortByLastPaid(const CDeterministicMNList& mnList)
+{
+    std::vector<CDeterministicMNCPtr> result;
+    mnList.ForEachMN(true, [&](const CDeterministicMNCPtr& dmn) {
+        result.emplace_back(dmn);
+    });
+    std::sort(result.begin(), result.end(), [](const CDeterministicMNCPtr& a, const CDeterministicMNCPtr& b) {
+        int ah = CompareByLastPaid_GetHeight(*a);
+        int bh = CompareByLastPaid_GetHeight(*b);
+        return ah == bh ? a->proTxHash < b->proTxHash : ah < bh;
+    });
+    return result;
+}
+
+static void CheckPaymentOrder(const CDeterministicMNList& mnList)
+{
+    auto sorted = SortByLastPaid(mnList);
+    BOOST_CHECK_EQUAL(mnList.GetValidMNsCount(), sorted.size());
+    auto payee = mnList.GetMNPayee();
+    if (sorted.empty()) {
+        BOOST_CHECK(payee == nullptr);
+    } else {
+        BOOST_CHECK(payee != nullptr && payee->proTxHash == sorted.front()->proTxHash);
+    }
+    for (int nCount : {1, 10, (int)sorted.size() + 1}) {
+        auto projected = mnList.GetProjectedMNPayees(nCount);
+        BOOST_CHECK_EQUAL(projected.size(), std::min((size_t)nCount, sorted.size()));
+        for (size_t i = 0; i < projected.size(); i++) {
+            BOOST_CHECK(projected[i]->proTxHash == sorted[i]->proTxHash);
+        }
+    }
+}
+
+static CDeterministicMNCPtr CreateRandomDmn(uint64_t internalId, int nHeight)
+{
+    auto dmn = std::make_shared<CDeterministicMN>(internalId);
+    dmn->proTxHash = InsecureRand256();
+    dmn->collateralOutpoint = COutPoint(InsecureRand256(), 0);
+    dmn->nOperatorReward = 0;
+    auto state = std::make_shared<CDeterministicMNState>();
+    state->nRegisteredHeight = nHeight;
+    const uint256 ownerSeed = InsecureRand256();
+    state->keyIDOwner = CKeyID(Hash160(ownerSeed.begin(), ownerSeed.end()));
+    state->UpdateConfirmedHash(dmn->proTxHash, InsecureRand256());
+    dmn->pdmnState = state;
+    return dmn;
+}
+
 BOOST_AUTO_TEST_SUITE(evo_dip3_activation_tests)
 
 BOOST_FIXTURE_TEST_CASE(dip3_activation, TestChainDIP3BeforeActivationSetup)
@@ -650,4 +710,84 @@ BOOST_FIXTURE_TEST_CASE(dip3_verify_db, TestChainDIP3Setup)
     BOOST_ASSERT(CVerifyDB().VerifyDB(Params(), pcoinsTip.get(), 4, 2));
 }
 
+BOOST_FIXTURE_TEST_CASE(dip3_payment_order, BasicTestingSetup)
+{
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    std::vector<uint256> vProTxHashes;
+    uint64_t nNextId = 0;
+
+    // heights are drawn from a small range, so the proTxHash tie-break is exercised too
+    for (int i = 0; i < 2000; i++) {
+        const int nHeight = InsecureRandRange(50);
+        const int nAction = vProTxHashes.empty() ? 0 : InsecureRandRange(5);
+        if (nAction == 0) {
+            auto dmn = CreateRandomDmn(nNextId++, nHeight);
+            mnList.AddMN(dmn);
+            vProTxHashes.emplace_back(dmn->proTxHash);
+            continue;
+        }
+
+        const size_t nIndex = InsecureRandRange(vProTxHashes.size());
+        auto dmn = mnList.GetMN(vProTxHashes[nIndex]);
+        auto newState = std::make_shared<CDeterministicMNState>(*dmn->pdmnState);
+        if (nAction == 1) {
+            newState->nLastPaidHeight = nHeight;
+        } else if (nAction == 2) {
+            newState->BanIfNotBanned(nHeight);
+        } else if (nAction == 3) {
+            newState->Revive(nHeight);
+        } else {
+            mnList.RemoveMN(dmn->proTxHash);
+            vProTxHashes.erase(vProTxHashes.begin() + nIndex);
+            CheckPaymentOrder(mnList);
+            continue;
+        }
+        mnList.UpdateMN(dmn, newState);
+        CheckPaymentOrder(mnList);
+    }
+    BOOST_CHECK(mnList.GetValidMNsCount() > 0);
+    BOOST_CHECK(mnList.GetValidMNsCount() < mnList.GetAllMNsCount());
+
+    // a deserialized list rebuilds the same order
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << mnList;
+    CDeterministicMNList mnList2;
+    ss >> mnList2;
+    BOOST_CHECK_EQUAL(mnList2.GetAllMNsCount(), mnList.GetAllMNsCount());
+    CheckPaymentOrder(mnList2);
+    auto projected = mnList.GetProjectedMNPayees(mnList.GetValidMNsCount());
+    auto projected2 = mnList2.GetProjectedMNPayees(mnList2.GetValidMNsCount());
+    BOOST_CHECK_EQUAL(projected.size(), projected2.size());
+    for (size_t i = 0; i < projected.size() && i < projected2.size(); i++) {
+        BOOST_CHECK(projected[i]->proTxHash == projected2[i]->proTxHash);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(dip3_calculate_scores_workers, BasicTestingSetup)
+{
+    // large enough to be split over several workers
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    for (uint64_t i = 0; i < 5000; i++) {
+        mnList.AddMN(CreateRandomDmn(i, 1));
+    }
+
+    const uint256 modifier = InsecureRand256();
+    auto scores = mnList.CalculateScores(modifier, 1);
+    BOOST_CHECK_EQUAL(scores.size(), 5000U);
+    for (size_t nMaxWorkers : {2, 3, 4}) {
+        auto scoresParallel = mnList.CalculateScores(modifier, nMaxWorkers);
+        BOOST_CHECK(scoresParallel == scores);
+    }
+
+    // every score is the hash of the precalculated part and the modifier
+    for (const auto& score : scores) {
+        uint256 h;
+        CSHA256()
+            .Write(score.second->pdmnState->confirmedHashWithProRegTxHash.begin(), 32)
+            .Write(modifier.begin(), modifier.size())
+            .Finalize(h.begin());
+        BOOST_CHECK(score.first == UintToArith256(h));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 
 #include <test/test_bytz.h>
 
+#include <arith_uint256.h>
 #include <bls/bls.h>
 #include <evo/simplifiedmns.h>
 #include <netbase.h>
@@ -67,4 +68,74 @@ BOOST_AUTO_TEST_CASE(simplifiedmns_merkleroots)
 
     BOOST_CHECK(expectedMerkleRoot == calculatedMerkleRoot);
 }
+
+BOOST_AUTO_TEST_CASE(simplifiedmns_merkletree_updates)
+{
+    auto makeEntry = [](size_t i, size_t nVersion) {
+        CSimplifiedMNListEntry smle;
+        smle.proRegTxHash = ArithToUint256(arith_uint256(i * 7919 % 1000));
+        smle.confirmedHash = ArithToUint256(arith_uint256(nVersion));
+        smle.keyIDVoting.SetHex(strprintf("%040x", i));
+        smle.isValid = true;
+        return smle;
+    };
+
+    std::map<uint256, CSimplifiedMNListEntry> entries;
+    CSimplifiedMNListMerkleTree tree;
+    auto checkRoot = [&]() {
+        std::vector<CSimplifiedMNListEntry> vecEntries;
+        for (const auto& p : entries) {
+            vecEntries.emplace_back(p.second);
+        }
+        bool mutated = true;
+        BOOST_CHECK(tree.CalcMerkleRoot(&mutated) == CSimplifiedMNList(vecEntries).CalcMerkleRoot(nullptr));
+        BOOST_CHECK(!mutated);
+        BOOST_CHECK_EQUAL(tree.size(), entries.size());
+    };
+
+    checkRoot();
+
+    // grow one entry at a time to cover all odd/even level sizes
+    for (size_t i = 0; i < 40; i++) {
+        auto smle = makeEntry(i, 0);
+        entries[smle.proRegTxHash] = smle;
+        tree.AddOrUpdate(smle);
+        checkRoot();
+    }
+
+    // a mix of changes per update, like a block's diff
+    for (size_t round = 1; round < 20; round++) {
+        for (size_t i = round; i < 40; i += 7) {
+            auto smle = makeEntry(i, round);
+            entries[smle.proRegTxHash] = smle;
+            tree.AddOrUpdate(smle);
+        }
+        auto removed = makeEntry(round * 3 % 40, 0);
+        entries.erase(removed.proRegTxHash);
+        tree.Remove(removed.proRegTxHash);
+        auto added = makeEntry(40 + round, round);
+        entries[added.proRegTxHash] = added;
+        tree.AddOrUpdate(added);
+        checkRoot();
+    }
+
+    // a fork doesn't affect the tree it was copied from
+    std::vector<CSimplifiedMNListEntry> vecEntries;
+    for (const auto& p : entries) {
+        vecEntries.emplace_back(p.second);
+    }
+    uint256 rootBefore = tree.CalcMerkleRoot();
+    CSimplifiedMNListMerkleTree fork(tree);
+    fork.Remove(vecEntries.front().proRegTxHash);
+    BOOST_CHECK(fork.CalcMerkleRoot() != rootBefore);
+    BOOST_CHECK(tree.CalcMerkleRoot() == rootBefore);
+    BOOST_CHECK(CSimplifiedMNListMerkleTree(CSimplifiedMNList(vecEntries)).CalcMerkleRoot() == rootBefore);
+
+    // shrink down to nothing
+    while (!entries.empty()) {
+        tree.Remove(entries.begin()->first);
+        entries.erase(entries.begin());
+        checkRoot();
+    }
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/test_bytz.h>
+
+#include <governance/governance-db.h>
+#include <governance/governance-object.h>
+#include <governance/governance-vote.h>
+#include <governance/governance-votedb.h>
+
+#include <boost/test/unit_test.hpp>
+
+static CGovernanceVote CreateVote(const COutPoint& mnOutpoint, const uint256& nParentHash, vote_outcome_enum_t eOutcome, int64_t nTime)
+{
+    CGovernanceVote vote(mnOutpoint, nParentHash, VOTE_SIGNAL_FUNDING, eOutcome);
+    vote.SetTime(nTime);
+    return vote;
+}
+
+static vote_rec_t CreateVoteRecord(const CGovernanceVote& vote)
+{
+    vote_rec_t voteRecord;
+    voteRecord.mapInstances[VOTE_SIGNAL_FUNDING] = vote_instance_t(vote.GetOutcome(), vote.GetTimestamp(), vote.GetTimestamp());
+    return voteRecord;
+}
+
+BOOST_FIXTURE_TEST_SUITE(governance_db_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(governancedb_roundtrip)
+{
+    CGovernanceDb db(1 << 20, true);
+
+    CGovernanceObject obj1(uint256(), 1, 1000, InsecureRand256(), "7b226e616d65223a2274657374227d");
+    CGovernanceObject obj2(uint256(), 1, 2000, InsecureRand256(), "7b226e616d65223a2274657374227d");
+    const uint256 nHash1 = obj1.GetHash();
+    const uint256 nHash2 = obj2.GetHash();
+
+    std::map<uint256, CGovernanceObject> mapObjects;
+    mapObjects.emplace(nHash1, obj1);
+    mapObjects.emplace(nHash2, obj2);
+    BOOST_CHECK(mapObjects.at(nHash1).IsSetDirtyRecord());
+    BOOST_CHECK(db.WriteObjects(mapObjects));
+    BOOST_CHECK(!mapObjects.at(nHash1).IsSetDirtyRecord());
+    BOOST_CHECK(!mapObjects.at(nHash2).IsSetDirtyRecord());
+
+    // votes are written one by one together with the record of their masternode
+    const COutPoint mn1(InsecureRand256(), 0);
+    const COutPoint mn2(InsecureRand256(), 1);
+    CGovernanceVote vote1 = CreateVote(mn1, nHash1, VOTE_OUTCOME_YES, 1100);
+    CGovernanceVote vote2 = CreateVote(mn2, nHash1, VOTE_OUTCOME_NO, 1200);
+    BOOST_CHECK(db.WriteVote(vote1, CreateVoteRecord(vote1), {}));
+    BOOST_CHECK(db.WriteVote(vote2, CreateVoteRecord(vote2), {}));
+
+    CGovernanceVote voteRead;
+    BOOST_CHECK(db.ReadVote(nHash1, vote1.GetHash(), voteRead));
+    BOOST_CHECK(voteRead == vote1);
+    BOOST_CHECK(!db.HasVote(nHash2, vote1.GetHash()));
+    std::vector<uint256> vecHashes;
+    db.ReadVoteHashes(nHash1, vecHashes);
+    BOOST_CHECK_EQUAL(vecHashes.size(), 2U);
+
+    // objects are read with their vote records, the votes stay on disk
+    std::map<uint256, CGovernanceObject> mapRead;
+    BOOST_CHECK(db.ReadObjects(mapRead));
+    BOOST_CHECK_EQUAL(mapRead.size(), 2U);
+    BOOST_CHECK(mapRead.at(nHash1).GetHash() == nHash1);
+    BOOST_CHECK(!mapRead.at(nHash1).AreVotesLoaded());
+    BOOST_CHECK(!mapRead.at(nHash1).IsSetDirtyRecord());
+    vote_rec_t voteRecord;
+    BOOST_CHECK(mapRead.at(nHash1).GetCurrentMNVotes(mn2, voteRecord));
+    BOOST_CHECK(voteRecord.mapInstances.at(VOTE_SIGNAL_FUNDING).eOutcome == VOTE_OUTCOME_NO);
+    BOOST_CHECK(!mapRead.at(nHash2).GetCurrentMNVotes(mn1, voteRecord));
+
+    // a newer vote of the same masternode replaces the older one
+    CGovernanceVote vote1b = CreateVote(mn1, nHash1, VOTE_OUTCOME_NO, 1300);
+    BOOST_CHECK(db.WriteVote(vote1b, CreateVoteRecord(vote1b), {vote1.GetHash()}));
+    BOOST_CHECK(!db.HasVote(nHash1, vote1.GetHash()));
+    BOOST_CHECK(db.HasVote(nHash1, vote1b.GetHash()));
+
+    // removing all votes of a masternode drops its record
+    BOOST_CHECK(db.RemoveVotes(nHash1, mn2, nullptr, {vote2.GetHash()}));
+    BOOST_CHECK(!db.HasVote(nHash1, vote2.GetHash()));
+    mapRead.clear();
+    BOOST_CHECK(db.ReadObjects(mapRead));
+    BOOST_CHECK(!mapRead.at(nHash1).GetCurrentMNVotes(mn2, voteRecord));
+    BOOST_CHECK(mapRead.at(nHash1).GetCurrentMNVotes(mn1, voteRecord));
+
+    // only changed records are written again
+    mapObjects.at(nHash2).PrepareDeletion(5000);
+    BOOST_CHECK(!mapObjects.at(nHash1).IsSetDirtyRecord());
+    BOOST_CHECK(mapObjects.at(nHash2).IsSetDirtyRecord());
+    BOOST_CHECK(db.WriteObjects(mapObjects));
+    BOOST_CHECK(!mapObjects.at(nHash2).IsSetDirtyRecord());
+    mapObjects.at(nHash2).PrepareDeletion(6000);
+    BOOST_CHECK(!mapObjects.at(nHash2).IsSetDirtyRecord());
+    mapObjects.at(nHash2).SetExpired();
+    BOOST_CHECK(mapObjects.at(nHash2).IsSetDirtyRecord());
+    BOOST_CHECK(db.WriteObjects(mapObjects));
+    mapRead.clear();
+    BOOST_CHECK(db.ReadObjects(mapRead));
+    BOOST_CHECK_EQUAL(mapRead.at(nHash2).GetDeletionTime(), 5000);
+    BOOST_CHECK(mapRead.at(nHash2).IsSetExpired());
+
+    // erasing an object erases its votes and records too
+    BOOST_CHECK(db.EraseObject(nHash1));
+    BOOST_CHECK(!db.HasVote(nHash1, vote1b.GetHash()));
+    vecHashes.clear();
+    db.ReadVoteHashes(nHash1, vecHashes);
+    BOOST_CHECK(vecHashes.empty());
+    mapRead.clear();
+    BOOST_CHECK(db.ReadObjects(mapRead));
+    BOOST_CHECK_EQUAL(mapRead.size(), 1U);
+    BOOST_CHECK(mapRead.count(nHash2));
+}
+
+BOOST_AUTO_TEST_CASE(governancedb_import)
+{
+    governanceDb.reset(new CGovernanceDb(1 << 20, true));
+
+    CGovernanceObject obj(uint256(), 1, 1000, InsecureRand256(), "7b226e616d65223a2274657374227d");
+    const uint256 nHash = obj.GetHash();
+    const COutPoint mn1(InsecureRand256(), 0);
+    const COutPoint mn2(InsecureRand256(), 1);
+    CGovernanceVote vote1 = CreateVote(mn1, nHash, VOTE_OUTCOME_YES, 1100);
+    CGovernanceVote vote2 = CreateVote(mn2, nHash, VOTE_OUTCOME_NO, 1200);
+
+    CGovernanceObject::vote_m_t mapVoteRecords;
+    mapVoteRecords[mn1] = CreateVoteRecord(vote1);
+    mapVoteRecords[mn2] = CreateVoteRecord(vote2);
+    CGovernanceObjectVoteFile voteFile;
+    voteFile.AddVote(vote1);
+    voteFile.AddVote(vote2);
+
+    // an object as stored in governance.dat, its record followed by the vote records and votes
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    obj.SerializationOp(ss, CSerActionSerialize(), false);
+    ss << mapVoteRecords << voteFile;
+
+    std::map<uint256, CGovernanceObject> mapObjects;
+    ss >> mapObjects[nHash];
+    BOOST_CHECK_EQUAL(mapObjects.at(nHash).GetVoteFile().GetVoteCount(), 2);
+
+    // same steps as CGovernanceManager::ImportToDb
+    BOOST_CHECK(governanceDb->WriteObjectVotes(mapObjects.at(nHash)));
+    BOOST_CHECK(governanceDb->WriteObjects(mapObjects));
+
+    std::map<uint256, CGovernanceObject> mapRead;
+    BOOST_CHECK(governanceDb->ReadObjects(mapRead));
+    BOOST_CHECK_EQUAL(mapRead.size(), 1U);
+    CGovernanceObject& objRead = mapRead.at(nHash);
+    BOOST_CHECK(objRead.GetHash() == nHash);
+    vote_rec_t voteRecord;
+    BOOST_CHECK(objRead.GetCurrentMNVotes(mn1, voteRecord));
+    BOOST_CHECK(objRead.GetCurrentMNVotes(mn2, voteRecord));
+
+    // the votes are read on first use
+    BOOST_CHECK(!objRead.AreVotesLoaded());
+    BOOST_CHECK_EQUAL(objRead.GetVoteFile().GetVoteCount(), 0);
+    objRead.LoadVotes();
+    BOOST_CHECK(objRead.AreVotesLoaded());
+    BOOST_CHECK_EQUAL(objRead.GetVoteFile().GetVoteCount(), 2);
+    BOOST_CHECK(objRead.GetVoteFile().HasVote(vote1.GetHash()));
+    BOOST_CHECK(objRead.GetVoteFile().HasVote(vote2.GetHash()));
+
+    governanceDb.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,92 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/test_bytz.h>
+
+#include <tokens/tokengroupmanager.h>
+
+#include <boost/test/unit_test.hpp>
+
+static CTokenGroupCreation CreateTokenGroup(unsigned char id, const std::string& strTicker, const std::string& strName, bool fInvalid = false)
+{
+    CTokenGroupInfo tokenGroupInfo{CTokenGroupID(id)};
+    tokenGroupInfo.invalid = fInvalid;
+    CTokenGroupDescriptionRegular tgDesc(strTicker, strName, 8, "", uint256());
+    return CTokenGroupCreation(MakeTransactionRef(), uint256(), tokenGroupInfo, std::make_shared<CTokenGroupDescriptionVariant>(tgDesc), CTokenGroupStatus());
+}
+
+BOOST_FIXTURE_TEST_SUITE(tokengroupmanager_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(tokengroupsnapshot_indexes)
+{
+    CTokenGroupSnapshot snapshot;
+    BOOST_CHECK(snapshot.Add(CreateTokenGroup(3, "AAA", "Token A")));
+    BOOST_CHECK(snapshot.Add(CreateTokenGroup(1, "BBB", "Token B")));
+    BOOST_CHECK(!snapshot.Add(CreateTokenGroup(1, "CCC", "Token C")));
+    BOOST_CHECK_EQUAL(snapshot.size(), 2U);
+
+    // ticker and name lookups are case insensitive
+    CTokenGroupID tgID;
+    BOOST_CHECK(snapshot.GetValidTokenGroupIdByTicker("aaa", tgID));
+    BOOST_CHECK(tgID == CTokenGroupID(3));
+    BOOST_CHECK(snapshot.GetValidTokenGroupIdByName("TOKEN b", tgID));
+    BOOST_CHECK(tgID == CTokenGroupID(1));
+    BOOST_CHECK(!snapshot.GetValidTokenGroupIdByTicker("CCC", tgID));
+    BOOST_CHECK(snapshot.GetTokenGroupIdByTicker("aaa", tgID));
+    BOOST_CHECK(tgID == CTokenGroupID(3));
+    BOOST_CHECK(!snapshot.GetTokenGroupIdByTicker("CCC", tgID));
+    BOOST_CHECK(snapshot.Find(CTokenGroupID(3)) != nullptr);
+    BOOST_CHECK(snapshot.Find(CTokenGroupID(2)) == nullptr);
+
+    // invalid groups are only found by the lookup over all groups
+    BOOST_CHECK(snapshot.Add(CreateTokenGroup(4, "DDD", "Token D", true)));
+    BOOST_CHECK(!snapshot.GetValidTokenGroupIdByTicker("DDD", tgID));
+    BOOST_CHECK(snapshot.GetTokenGroupIdByTicker("DDD", tgID));
+    BOOST_CHECK(tgID == CTokenGroupID(4));
+    BOOST_CHECK(snapshot.GetTokenGroupIdByName("token d", tgID));
+    BOOST_CHECK(tgID == CTokenGroupID(4));
+
+    // the first valid group keeps a ticker or name, the lookup over all groups returns the lowest ID
+    BOOST_CHECK(snapshot.Add(CreateTokenGroup(2, "aaa", "Token A")));
+    BOOST_CHECK(snapshot.GetValidTokenGroupIdByTicker("AAA", tgID));
+    BOOST_CHECK(tgID == CTokenGroupID(3));
+    BOOST_CHECK(snapshot.GetTokenGroupIdByTicker("AAA", tgID));
+    BOOST_CHECK(tgID == CTokenGroupID(2));
+
+    // removing the owner frees the ticker and name, nothing takes them over
+    CTokenGroupSnapshot oldSnapshot = snapshot;
+    BOOST_CHECK(snapshot.Remove(CTokenGroupID(3)));
+    BOOST_CHECK(!snapshot.Remove(CTokenGroupID(3)));
+    BOOST_CHECK(!snapshot.GetValidTokenGroupIdByTicker("AAA", tgID));
+    BOOST_CHECK(!snapshot.GetValidTokenGroupIdByName("Token A", tgID));
+    BOOST_CHECK(snapshot.GetTokenGroupIdByName("Token A", tgID));
+    BOOST_CHECK(tgID == CTokenGroupID(2));
+
+    // copies of the snapshot are not affected by later changes
+    BOOST_CHECK_EQUAL(oldSnapshot.size(), 4U);
+    BOOST_CHECK(oldSnapshot.GetValidTokenGroupIdByTicker("AAA", tgID));
+    BOOST_CHECK(tgID == CTokenGroupID(3));
+
+    BOOST_CHECK(snapshot.Remove(CTokenGroupID(2)));
+    BOOST_CHECK(!snapshot.GetTokenGroupIdByTicker("AAA", tgID));
+    BOOST_CHECK(!snapshot.GetTokenGroupIdByName("Token A", tgID));
+}
+
+BOOST_AUTO_TEST_CASE(tokengroupsnapshot_sorted)
+{
+    CTokenGroupSnapshot snapshot;
+    for (unsigned char id : {9, 4, 200, 1, 77, 32}) {
+        BOOST_CHECK(snapshot.Add(CreateTokenGroup(id, strprintf("T%d", id), strprintf("Token %d", id))));
+    }
+
+    auto vTokenGroups = snapshot.GetSortedByID();
+    BOOST_CHECK_EQUAL(vTokenGroups.size(), snapshot.size());
+    for (size_t i = 1; i < vTokenGroups.size(); i++) {
+        BOOST_CHECK(vTokenGroups[i - 1]->tokenGroupInfo.associatedGroup < vTokenGroups[i]->tokenGroupInfo.associatedGroup);
+    }
+    BOOST_CHECK(vTokenGroups.front()->tokenGroupInfo.associatedGroup == CTokenGroupID(1));
+    BOOST_CHECK(vTokenGroups.back()->tokenGroupInfo.associatedGroup == CTokenGroupID(200));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,139 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <index/tokenindex.h>
+#include <script/standard.h>
+#include <script/tokengroup.h>
+#include <test/test_bytz.h>
+#include <undo.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(tokenindex_tests)
+
+/** A block of token transactions with the undo data the token index reads their inputs from. */
+struct TokenTestBlock
+{
+    CBlock block;
+    CBlockUndo block_undo;
+
+    TokenTestBlock()
+    {
+        CMutableTransaction coinbase;
+        coinbase.vin.resize(1);
+        coinbase.vin[0].prevout.SetNull();
+        coinbase.vout.emplace_back(50 * COIN, CScript() << OP_TRUE);
+        block.vtx.emplace_back(MakeTransactionRef(coinbase));
+    }
+
+    void AddTx(const std::vector<CTxOut>& prevouts, const std::vector<CTxOut>& outputs)
+    {
+        CMutableTransaction tx;
+        CTxUndo tx_undo;
+        for (const CTxOut& prevout : prevouts) {
+            tx.vin.emplace_back(COutPoint(InsecureRand256(), 0));
+            tx_undo.vprevout.emplace_back(prevout, Params().GetConsensus().ATPStartHeight, false, false);
+        }
+        tx.vout = outputs;
+        block.vtx.emplace_back(MakeTransactionRef(tx));
+        block_undo.vtxundo.emplace_back(tx_undo);
+    }
+};
+
+static CTxOut TokenOutput(const CKey& key, const CTokenGroupID& tgID, CAmount nAmount)
+{
+    return CTxOut(0, GetScriptForDestination(key.GetPubKey().GetID(), tgID, nAmount));
+}
+
+static void ConnectTokenBlocks(TokenIndex& tokenindex, const std::vector<const TokenTestBlock*>& blocks, int nSign)
+{
+    std::map<CTokenGroupID, CTokenGroupSupply> supply_deltas;
+    std::map<CTokenBalanceKey, CAmount> balance_deltas;
+    for (const TokenTestBlock* pblock : blocks) {
+        TokenIndex::AccumulateBlockDeltas(pblock->block, pblock->block_undo, nSign, supply_deltas, balance_deltas);
+    }
+    BOOST_CHECK(tokenindex.CommitDeltas(supply_deltas, balance_deltas));
+}
+
+static void CheckTokenSupply(const TokenIndex& tokenindex, const CTokenGroupID& tgID, CAmount nSupply, CAmount nMinted, CAmount nMelted, int64_t nHolders)
+{
+    CTokenGroupSupply supply;
+    BOOST_CHECK(tokenindex.GetTokenSupply(tgID, supply));
+    BOOST_CHECK_EQUAL(supply.nSupply, nSupply);
+    BOOST_CHECK_EQUAL(supply.nMinted, nMinted);
+    BOOST_CHECK_EQUAL(supply.nMelted, nMelted);
+    BOOST_CHECK_EQUAL(supply.nHolders, nHolders);
+
+    std::vector<std::pair<CTokenBalanceKey, CAmount> > holders;
+    BOOST_CHECK(tokenindex.GetTokenHolders(tgID, holders));
+    BOOST_CHECK_EQUAL(holders.size(), (size_t)nHolders);
+}
+
+BOOST_FIXTURE_TEST_CASE(tokenindex_supply_and_holders, BasicTestingSetup)
+{
+    TokenIndex tokenindex(1 << 20, true);
+
+    CKey keyA, keyB;
+    keyA.MakeNewKey(true);
+    keyB.MakeNewKey(true);
+    const uint160 hashA = keyA.GetPubKey().GetID();
+    const uint160 hashB = keyB.GetPubKey().GetID();
+    const CTokenGroupID tgID(7);
+    const CTokenGroupID tgOther(8);
+    const CAmount nAuthority = (CAmount)(GroupAuthorityFlags::CTRL | GroupAuthorityFlags::MINT | GroupAuthorityFlags::MELT);
+    const CTxOut plainOut(COIN, GetScriptForDestination(keyA.GetPubKey().GetID()));
+
+    // Mint 100 to A and 50 to B, the authority output carries no amount
+    TokenTestBlock block1;
+    block1.AddTx({plainOut, TokenOutput(keyA, tgID, nAuthority)},
+                 {TokenOutput(keyA, tgID, nAuthority), TokenOutput(keyA, tgID, 100), TokenOutput(keyB, tgID, 50)});
+
+    // Melt 10 of A's tokens while sending 60 to B, and transfer B's 50 to A
+    TokenTestBlock block2;
+    block2.AddTx({TokenOutput(keyA, tgID, 100), TokenOutput(keyA, tgID, nAuthority)},
+                 {TokenOutput(keyB, tgID, 60), TokenOutput(keyA, tgID, 30), TokenOutput(keyA, tgID, nAuthority)});
+    block2.AddTx({TokenOutput(keyB, tgID, 50)}, {TokenOutput(keyA, tgID, 50)});
+
+    // A sends everything to B and stops being a holder, another group is minted in the same block
+    TokenTestBlock block3;
+    block3.AddTx({TokenOutput(keyA, tgID, 30), TokenOutput(keyA, tgID, 50)}, {TokenOutput(keyB, tgID, 80)});
+    block3.AddTx({plainOut}, {TokenOutput(keyA, tgOther, 5)});
+
+    CTokenGroupSupply supply;
+    BOOST_CHECK(!tokenindex.GetTokenSupply(tgID, supply));
+
+    ConnectTokenBlocks(tokenindex, {&block1}, 1);
+    CheckTokenSupply(tokenindex, tgID, 150, 150, 0, 2);
+    BOOST_CHECK_EQUAL(tokenindex.GetTokenBalance(tgID, 1, hashA), 100);
+    BOOST_CHECK_EQUAL(tokenindex.GetTokenBalance(tgID, 1, hashB), 50);
+
+    ConnectTokenBlocks(tokenindex, {&block2}, 1);
+    CheckTokenSupply(tokenindex, tgID, 140, 150, 10, 2);
+    BOOST_CHECK_EQUAL(tokenindex.GetTokenBalance(tgID, 1, hashA), 80);
+    BOOST_CHECK_EQUAL(tokenindex.GetTokenBalance(tgID, 1, hashB), 60);
+
+    ConnectTokenBlocks(tokenindex, {&block3}, 1);
+    CheckTokenSupply(tokenindex, tgID, 140, 150, 10, 1);
+    CheckTokenSupply(tokenindex, tgOther, 5, 5, 0, 1);
+    BOOST_CHECK_EQUAL(tokenindex.GetTokenBalance(tgID, 1, hashA), 0);
+    BOOST_CHECK_EQUAL(tokenindex.GetTokenBalance(tgID, 1, hashB), 140);
+    std::vector<std::pair<CTokenGroupID, CTokenGroupSupply> > supplies;
+    BOOST_CHECK(tokenindex.GetAllTokenSupplies(supplies));
+    BOOST_CHECK_EQUAL(supplies.size(), 2U);
+
+    // Rewinding several blocks at once nets their deltas before they are committed, like Rewind
+    ConnectTokenBlocks(tokenindex, {&block3, &block2}, -1);
+    CheckTokenSupply(tokenindex, tgID, 150, 150, 0, 2);
+    CheckTokenSupply(tokenindex, tgOther, 0, 0, 0, 0);
+    BOOST_CHECK_EQUAL(tokenindex.GetTokenBalance(tgID, 1, hashA), 100);
+    BOOST_CHECK_EQUAL(tokenindex.GetTokenBalance(tgID, 1, hashB), 50);
+
+    ConnectTokenBlocks(tokenindex, {&block1}, -1);
+    CheckTokenSupply(tokenindex, tgID, 0, 0, 0, 0);
+    BOOST_CHECK_EQUAL(tokenindex.GetTokenBalance(tgID, 1, hashA), 0);
+    BOOST_CHECK_EQUAL(tokenindex.GetTokenBalance(tgID, 1, hashB), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,201 @@
+// Copyright (c) 2017-2018 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <consensus/validation.h>
+#include <hash.h>
+#include <index/addressindex.h>
+#include <index/spentindex.h>
+#include <index/txindex.h>
+#include <script/standard.h>
+#include <test/test_bytz.h>
+#include <utiltime.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(txindex_tests)
+
+template <typename T>
+static void WaitForIndexSync(T& index)
+{
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!index.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        MilliSleep(100);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
+{
+    TxIndex txindex(1 << 20, true);
+
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+
+    // Transaction should not be found in the index before it is started.
+    for (const auto& txn : coinbaseTxns) {
+        BOOST_CHECK(!txindex.FindTx(txn.GetHash(), block_hash, tx_disk));
+    }
+
+    // BlockUntilSyncedToCurrentChain should return false before txindex is started.
+    BOOST_CHECK(!txindex.BlockUntilSyncedToCurrentChain());
+
+    txindex.Start();
+
+    // Allow tx index to catch up with the block index.
+    WaitForIndexSync(txindex);
+
+    // Check that txindex has all txs that were in the chain before it started.
+    for (const auto& txn : coinbaseTxns) {
+        if (!txindex.FindTx(txn.GetHash(), block_hash, tx_disk)) {
+            BOOST_ERROR("FindTx failed");
+        } else if (tx_disk->GetHash() != txn.GetHash()) {
+            BOOST_ERROR("Read incorrect tx");
+        }
+        BOOST_CHECK(txindex.HasTx(txn.GetHash()));
+    }
+
+    // Check that new transactions in new blocks make it into the index.
+    for (int i = 0; i < 10; i++) {
+        const CBlock& block = CreateAndProcessBlock({}, coinbaseKey);
+        const CTransaction& txn = *block.vtx[0];
+
+        BOOST_CHECK(txindex.BlockUntilSyncedToCurrentChain());
+        if (!txindex.FindTx(txn.GetHash(), block_hash, tx_disk)) {
+            BOOST_ERROR("FindTx failed");
+        } else if (tx_disk->GetHash() != txn.GetHash()) {
+            BOOST_ERROR("Read incorrect tx");
+        }
+        BOOST_CHECK(block_hash == block.GetHash());
+    }
+
+    txindex.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(txindex_legacy_migration, TestChain100Setup)
+{
+    // index entries as earlier versions wrote them to the block tree database
+    std::vector<uint256> txids;
+    {
+        LOCK(cs_main);
+        for (const CBlockIndex* pindex = chainActive.Genesis(); pindex; pindex = chainActive.Next(pindex)) {
+            CBlock block;
+            BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, Params().GetConsensus()));
+            CDiskTxPos pos(pindex->GetBlockPos(), GetSizeOfCompactSize(block.vtx.size()));
+            for (const auto& tx : block.vtx) {
+                BOOST_CHECK(pblocktree->Write(std::make_pair('t', tx->GetHash()), pos));
+                txids.push_back(tx->GetHash());
+                pos.nTxOffset += ::GetSerializeSize(*tx, SER_DISK, CLIENT_VERSION);
+            }
+        }
+    }
+    BOOST_CHECK(pblocktree->WriteFlag("txindex", true));
+
+    TxIndex txindex(1 << 20, true);
+    txindex.Start();
+
+    // the moved entries are in sync with the tip, nothing is left to build
+    BOOST_CHECK(txindex.IsSynced());
+    BOOST_CHECK(txindex.BlockUntilSyncedToCurrentChain());
+    bool fLegacyIndex = true;
+    BOOST_CHECK(pblocktree->ReadFlag("txindex", fLegacyIndex));
+    BOOST_CHECK(!fLegacyIndex);
+
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+    for (const uint256& txid : txids) {
+        BOOST_CHECK(txindex.FindTx(txid, block_hash, tx_disk));
+        BOOST_CHECK(!pblocktree->Exists(std::make_pair('t', txid)));
+    }
+
+    txindex.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(spentindex_addressindex_sync, TestChain100Setup)
+{
+    SpentIndex spentindex(1 << 20, true);
+    AddressIndex addressindex(1 << 20, true);
+    spentindex.Start();
+    addressindex.Start();
+    WaitForIndexSync(spentindex);
+    WaitForIndexSync(addressindex);
+
+    // Spend the first coinbase output back to the coinbase key.
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    CMutableTransaction spend;
+    spend.nVersion = 1;
+    spend.vin.resize(1);
+    spend.vin[0].prevout = COutPoint(coinbaseTxns[0].GetHash(), 0);
+    spend.vout.resize(1);
+    spend.vout[0].nValue = 11 * CENT;
+    spend.vout[0].scriptPubKey = scriptPubKey;
+
+    std::vector<unsigned char> vchSig;
+    uint256 hash = SignatureHash(scriptPubKey, spend, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+    BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    spend.vin[0].scriptSig << vchSig;
+
+    const CBlock block = CreateAndProcessBlock({spend}, coinbaseKey);
+    BOOST_CHECK(block.vtx.size() == 2);
+    BOOST_CHECK(spentindex.BlockUntilSyncedToCurrentChain());
+    BOOST_CHECK(addressindex.BlockUntilSyncedToCurrentChain());
+
+    // The spent index maps the outpoint to the spending input.
+    CSpentIndexValue value;
+    BOOST_CHECK(spentindex.ReadSpentIndex(CSpentIndexKey(coinbaseTxns[0].GetHash(), 0), value));
+    BOOST_CHECK(value.txid == spend.GetHash());
+    BOOST_CHECK_EQUAL(value.inputIndex, 0U);
+    BOOST_CHECK_EQUAL(value.satoshis, coinbaseTxns[0].vout[0].nValue);
+    BOOST_CHECK_EQUAL(value.addressType, 1);
+
+    // The address index records the spend and the spent output is no longer unspent.
+    uint160 addressHash = Hash160(coinbaseKey.GetPubKey().begin(), coinbaseKey.GetPubKey().end());
+    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    BOOST_CHECK(addressindex.ReadAddressIndex(addressHash, 1, addressIndex));
+    bool found_spend = false;
+    for (const auto& entry : addressIndex) {
+        if (entry.first.txhash == spend.GetHash() && entry.first.spending) {
+            BOOST_CHECK_EQUAL(entry.second, -coinbaseTxns[0].vout[0].nValue);
+            found_spend = true;
+        }
+    }
+    BOOST_CHECK(found_spend);
+
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > unspent;
+    BOOST_CHECK(addressindex.ReadAddressUnspentIndex(addressHash, 1, unspent));
+    bool found_spent_output = false, found_new_output = false;
+    for (const auto& entry : unspent) {
+        found_spent_output |= entry.first.txhash == coinbaseTxns[0].GetHash() && entry.first.index == 0;
+        found_new_output |= entry.first.txhash == spend.GetHash() && entry.first.index == 0;
+    }
+    BOOST_CHECK(!found_spent_output);
+    BOOST_CHECK(found_new_output);
+
+    // Disconnecting the block rewinds both indexes.
+    {
+        LOCK(cs_main);
+        CValidationState state;
+        BOOST_CHECK(InvalidateBlock(state, Params(), LookupBlockIndex(block.GetHash())));
+    }
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(!spentindex.ReadSpentIndex(CSpentIndexKey(coinbaseTxns[0].GetHash(), 0), value));
+
+    unspent.clear();
+    BOOST_CHECK(addressindex.ReadAddressUnspentIndex(addressHash, 1, unspent));
+    found_spent_output = found_new_output = false;
+    for (const auto& entry : unspent) {
+        found_spent_output |= entry.first.txhash == coinbaseTxns[0].GetHash() && entry.first.index == 0;
+        found_new_output |= entry.first.txhash == spend.GetHash() && entry.first.index == 0;
+    }
+    BOOST_CHECK(found_spent_output);
+    BOOST_CHECK(!found_new_output);
+
+    spentindex.Stop();
+    addressindex.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
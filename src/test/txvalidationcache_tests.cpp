@@ -12,6 +12,7 @@
 #include <script/standard.h>
 #include <script/sign.h>
 #include <test/test_bytz.h>
+#include <tokens/groups.h>
 #include <utiltime.h>
 #include <core_io.h>
 #include <keystore.h>
@@ -19,7 +20,7 @@
 
 #include <boost/test/unit_test.hpp>
 
-bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks);
+bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks, CTokenGroupBlockData *pTokenGroupBlockData = nullptr);
 
 BOOST_AUTO_TEST_SUITE(tx_validationcache_tests)
 
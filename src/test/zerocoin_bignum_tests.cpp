@@ -0,0 +1,99 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/test_bytz.h>
+
+#include <chainparams.h>
+#include <libzerocoin/Params.h>
+
+#include <boost/test/unit_test.hpp>
+
+// A non-negative random number of about nBytes bytes
+static CBigNum RandomBigNum(size_t nBytes)
+{
+    std::vector<unsigned char> vch = insecure_rand_ctx.randbytes(nBytes);
+    vch.back() &= 0x7f; // clear the sign bit
+    return CBigNum(vch);
+}
+
+// Exponents covering zero, small, full size, negative and too long for the tables
+static std::vector<CBigNum> TestExponents(const CBigNum& modulus)
+{
+    const size_t nBytes = modulus.bitSize() / 8;
+    std::vector<CBigNum> vExps{CBigNum(0), CBigNum(1), CBigNum(15), CBigNum(16), CBigNum(-1), modulus - 1};
+    for (int i = 0; i < 8; i++) {
+        vExps.emplace_back(RandomBigNum(1 + InsecureRandRange(2 * nBytes)));
+        vExps.emplace_back(CBigNum(0) - RandomBigNum(1 + InsecureRandRange(2 * nBytes)));
+    }
+    // longer than the 2 * bitSize(modulus) bits the tables are built for
+    vExps.emplace_back(RandomBigNum(3 * nBytes));
+    vExps.emplace_back(CBigNum(0) - RandomBigNum(3 * nBytes));
+    return vExps;
+}
+
+static void CheckGroupPowMod(const libzerocoin::IntegerGroupParams& group, const CBigNum& m)
+{
+    CBigNumCtx ctx;
+    const std::vector<CBigNum> vExps = TestExponents(m);
+    for (const CBigNum& e1 : vExps) {
+        CBigNum r;
+        group.gPowMod(r, e1, m, ctx);
+        BOOST_CHECK(r == group.g.pow_mod(e1, m));
+        group.hPowMod(r, e1, m, ctx);
+        BOOST_CHECK(r == group.h.pow_mod(e1, m));
+
+        const CBigNum& e2 = vExps[InsecureRandRange(vExps.size())];
+        group.ghPowMod(r, e1, e2, m, ctx);
+        BOOST_CHECK(r == group.g.pow_mod(e1, m).mul_mod(group.h.pow_mod(e2, m), m));
+
+        // the result may alias an exponent
+        CBigNum e = e1;
+        group.gPowMod(e, e, m, ctx);
+        BOOST_CHECK(e == group.g.pow_mod(e1, m));
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(zerocoin_bignum_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(zerocoin_fixedbase_powmod)
+{
+    const libzerocoin::ZerocoinParams* params = Params().Zerocoin_Params(false);
+
+    for (const libzerocoin::IntegerGroupParams* pgroup : {&params->coinCommitmentGroup, &params->serialNumberSoKCommitmentGroup}) {
+        // a fresh copy of the values, so the tables are built here for the modulus of the first call
+        libzerocoin::IntegerGroupParams group;
+        group.g = pgroup->g;
+        group.h = pgroup->h;
+        group.modulus = pgroup->modulus;
+        group.groupOrder = pgroup->groupOrder;
+
+        CheckGroupPowMod(group, group.modulus);
+        // any other modulus falls back to plain exponentiation
+        CheckGroupPowMod(group, group.groupOrder);
+        CheckGroupPowMod(group, group.modulus);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(zerocoin_fixedbase_table)
+{
+    const libzerocoin::IntegerGroupParams& group = Params().Zerocoin_Params(false)->coinCommitmentGroup;
+    const CBigNum& m = group.modulus;
+    const CBigNumFixedBase g(group.g, m, 64);
+    const CBigNumFixedBase h(group.h, m, 64);
+
+    CBigNumCtx ctx;
+    const std::vector<CBigNum> vExps = TestExponents(m);
+    for (const CBigNum& e1 : vExps) {
+        CBigNum r;
+        g.pow_mod(r, e1, ctx);
+        BOOST_CHECK(r == group.g.pow_mod(e1, m));
+
+        for (const CBigNum& e2 : {CBigNum(0), CBigNum(7), CBigNum(-7), RandomBigNum(8), RandomBigNum(32)}) {
+            g.pow_mod2(r, e1, h, e2, ctx);
+            BOOST_CHECK(r == group.g.pow_mod(e1, m).mul_mod(group.h.pow_mod(e2, m), m));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -80,6 +80,44 @@ bool IsAnyOutputGrouped(const CTransaction &tx)
     return false;
 }
 
+CTokenGroupTxData::CTokenGroupTxData(const CTransaction &tx) : fAnyGrouped(false)
+{
+    vOutputs.reserve(tx.vout.size());
+    for (const CTxOut &txout : tx.vout)
+    {
+        vOutputs.emplace_back(txout.scriptPubKey);
+        const CTokenGroupInfo &grp = vOutputs.back();
+        fAnyGrouped |= grp.invalid || grp.associatedGroup != NoGroup;
+    }
+}
+
+const CTokenGroupTxData &CTokenGroupBlockData::Add(const CTransaction &tx)
+{
+    auto it = mapTxData.find(tx.GetHash());
+    if (it == mapTxData.end()) {
+        it = mapTxData.emplace(tx.GetHash(), CTokenGroupTxData(tx)).first;
+    }
+    return it->second;
+}
+
+const CTokenGroupTxData &CTokenGroupBlockData::GetOrParse(CTokenGroupBlockData *pBlockData, const CTransaction &tx, CTokenGroupTxData &local)
+{
+    if (pBlockData) {
+        return pBlockData->Add(tx);
+    }
+    local = CTokenGroupTxData(tx);
+    return local;
+}
+
+CTokenGroupInfo CTokenGroupBlockData::GetOutput(const COutPoint &prevout, const CScript &scriptPubKey) const
+{
+    auto it = mapTxData.find(prevout.hash);
+    if (it != mapTxData.end() && prevout.n < it->second.vOutputs.size()) {
+        return it->second.vOutputs[prevout.n];
+    }
+    return CTokenGroupInfo(scriptPubKey);
+}
+
 bool IsAnyOutputGroupedAuthority(const CTransaction &tx) {
     for (const CTxOut &txout : tx.vout)
     {
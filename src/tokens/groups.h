@@ -10,8 +10,11 @@
 #include "amount.h"
 #include "pubkey.h"
 #include "primitives/transaction.h"
+#include "saltedhasher.h"
 #include "script/script.h"
 
+#include <unordered_map>
+
 enum class TokenGroupIdFlags : uint8_t
 {
     NONE = 0,
@@ -293,6 +296,35 @@ bool IsAnyOutputGroupedAuthority(const CTransaction &tx);
 bool IsAnyOutputGroupedCreation(const CTransaction &tx, const TokenGroupIdFlags tokenGroupIdFlags = TokenGroupIdFlags::NONE);
 bool GetGroupedCreationOutput(const CTransaction &tx, CTxOut &creationOutput, const TokenGroupIdFlags = TokenGroupIdFlags::NONE);
 
+// The token group data of every output of a transaction, parsed from the output scripts once
+// so that the token group checks, the fee check and the token statistics can share it.
+class CTokenGroupTxData
+{
+public:
+    std::vector<CTokenGroupInfo> vOutputs; // one entry per output
+    bool fAnyGrouped; // same as IsAnyOutputGrouped(): invalid outputs count as grouped
+
+    CTokenGroupTxData() : fAnyGrouped(false) {}
+    explicit CTokenGroupTxData(const CTransaction &tx);
+};
+
+// The parsed token group data of the transactions of a block that is being connected.
+// Inputs that spend an output created earlier in the same block are resolved from here
+// instead of parsing the script of the coin again.
+class CTokenGroupBlockData
+{
+private:
+    std::unordered_map<uint256, CTokenGroupTxData, StaticSaltedHasher> mapTxData;
+
+public:
+    // Parse the outputs of a transaction, or return them if they have been parsed before
+    const CTokenGroupTxData &Add(const CTransaction &tx);
+    // Return the token group data of the coin spent by prevout
+    CTokenGroupInfo GetOutput(const COutPoint &prevout, const CScript &scriptPubKey) const;
+    // Return the parsed outputs of tx from pBlockData when it is set, otherwise parse them into local
+    static const CTokenGroupTxData &GetOrParse(CTokenGroupBlockData *pBlockData, const CTransaction &tx, CTokenGroupTxData &local);
+};
+
 // Serialize a CAmount into an array of bytes.
 // This serialization does not store the length of the serialized data within the serialized data.
 // It is therefore useful only within a system that already identifies the length of this field (such as a CScript).
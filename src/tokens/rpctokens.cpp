@@ -8,6 +8,8 @@
 #include "core_io.h"
 #include "dstencode.h"
 #include <evo/specialtx.h>
+#include "index/tokenindex.h"
+#include "index/txindex.h"
 #include "init.h"
 #include "bytzaddrenc.h"
 #include "rpc/protocol.h"
@@ -99,8 +101,9 @@ extern UniValue tokeninfo(const JSONRPCRequest& request)
         }
 
         UniValue entry(UniValue::VOBJ);
-        for (auto tokenGroupMapping : tokenGroupManager.get()->GetMapTokenGroups()) {
-            entry.push_back(Pair(tgDescGetName(*tokenGroupMapping.second.pTokenGroupDescription), EncodeTokenGroup(tokenGroupMapping.second.tokenGroupInfo.associatedGroup)));
+        const CTokenGroupSnapshot tokenGroups = tokenGroupManager.get()->GetSnapshot();
+        for (const CTokenGroupCreation* tgCreation : tokenGroups.GetSortedByID()) {
+            entry.push_back(Pair(tgDescGetName(*tgCreation->pTokenGroupDescription), EncodeTokenGroup(tgCreation->tokenGroupInfo.associatedGroup)));
         }
         ret.push_back(entry);
     } else if (operation == "all") {
@@ -115,9 +118,10 @@ extern UniValue tokeninfo(const JSONRPCRequest& request)
             fShowCreation = (strShowCreation == "true");
         }
 
-        for (auto tokenGroupMapping : tokenGroupManager.get()->GetMapTokenGroups()) {
+        const CTokenGroupSnapshot tokenGroups = tokenGroupManager.get()->GetSnapshot();
+        for (const CTokenGroupCreation* tgCreation : tokenGroups.GetSortedByID()) {
             UniValue entry(UniValue::VOBJ);
-            TokenGroupCreationToJSON(tokenGroupMapping.first, tokenGroupMapping.second, entry, fShowCreation);
+            TokenGroupCreationToJSON(tgCreation->tokenGroupInfo.associatedGroup, *tgCreation, entry, fShowCreation);
             ret.push_back(entry);
         }
     } else if (operation == "stats") {
@@ -430,9 +434,11 @@ extern UniValue gettokentransaction(const JSONRPCRequest& request)
             }
             errmsg = "No such transaction found in the provided block";
         } else {
-            errmsg = fTxIndex
-              ? "No such mempool or blockchain transaction"
-              : "No such mempool transaction. Use -txindex to enable blockchain transaction queries";
+            errmsg = !g_txindex
+              ? "No such mempool transaction. Use -txindex to enable blockchain transaction queries"
+              : !g_txindex->IsSynced()
+              ? "No such mempool transaction. Blockchain transactions are still in the process of being indexed"
+              : "No such mempool or blockchain transaction";
         }
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, errmsg + ". Use gettransaction for wallet transactions.");
     }
@@ -885,6 +891,220 @@ UniValue verifytokenmetadata(const JSONRPCRequest& request)
     return tgDocument.CheckSignature(*keyID);
 }
 
+static TokenIndex& EnsureTokenIndex()
+{
+    if (!g_tokenindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Token index not enabled. Use -tokenindex to enable token supply and balance queries");
+    }
+    g_tokenindex->BlockUntilSyncedToCurrentChain();
+    return *g_tokenindex;
+}
+
+static CTokenGroupID ParseTokenGroupID(const UniValue& param)
+{
+    CTokenGroupID grpID = GetTokenGroup(param.get_str());
+    if (!grpID.isUserGroup()) {
+        throw JSONRPCError(RPC_INVALID_PARAMS, "Invalid parameter: No group specified");
+    }
+    return grpID;
+}
+
+static std::string EncodeTokenAddress(uint8_t addressType, const uint160& hashBytes)
+{
+    if (addressType == 2) {
+        return EncodeDestination(CScriptID(hashBytes));
+    }
+    return EncodeDestination(CKeyID(hashBytes));
+}
+
+extern UniValue gettokensupply(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1)
+        throw std::runtime_error(
+            "gettokensupply \"groupid\"\n"
+            "\nReturns the circulating supply of a token group. Requires -tokenindex.\n"
+            "\nArguments:\n"
+            "1. \"groupid\"     (string, required) the group identifier\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"groupID\": \"xxx\",       (string) the group identifier\n"
+            "  \"ticker\": \"xxx\",        (string) the token ticker\n"
+            "  \"height\": n,            (numeric) the height the token index is synced to\n"
+            "  \"supply\": \"x.xxx\",      (string) the amount of tokens in circulation\n"
+            "  \"supplySat\": n,         (numeric) the amount of tokens in circulation in the smallest unit\n"
+            "  \"minted\": \"x.xxx\",      (string) the total amount of tokens minted\n"
+            "  \"mintedSat\": n,         (numeric) the total amount of tokens minted in the smallest unit\n"
+            "  \"melted\": \"x.xxx\",      (string) the total amount of tokens melted\n"
+            "  \"meltedSat\": n,         (numeric) the total amount of tokens melted in the smallest unit\n"
+            "  \"holders\": n            (numeric) the number of addresses holding tokens of this group\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("gettokensupply", "\"groupid\"")
+            + HelpExampleRpc("gettokensupply", "\"groupid\"")
+        );
+
+    CTokenGroupID grpID = ParseTokenGroupID(request.params[0]);
+    TokenIndex& tokenindex = EnsureTokenIndex();
+
+    CTokenGroupSupply supply;
+    if (!tokenindex.GetTokenSupply(grpID, supply)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, tokenindex.IsSynced()
+            ? "Token group not found"
+            : "Token group not found. Tokens are still in the process of being indexed");
+    }
+
+    const CBlockIndex* pindex = tokenindex.GetBestBlockIndex();
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("groupID", EncodeTokenGroup(grpID));
+    ret.pushKV("ticker", tokenGroupManager.get()->GetTokenGroupTickerByID(grpID));
+    ret.pushKV("height", pindex ? pindex->nHeight : -1);
+    ret.pushKV("supply", tokenGroupManager.get()->TokenValueFromAmount(supply.nSupply, grpID));
+    ret.pushKV("supplySat", supply.nSupply);
+    ret.pushKV("minted", tokenGroupManager.get()->TokenValueFromAmount(supply.nMinted, grpID));
+    ret.pushKV("mintedSat", supply.nMinted);
+    ret.pushKV("melted", tokenGroupManager.get()->TokenValueFromAmount(supply.nMelted, grpID));
+    ret.pushKV("meltedSat", supply.nMelted);
+    ret.pushKV("holders", supply.nHolders);
+    return ret;
+}
+
+extern UniValue listtokenholders(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 3)
+        throw std::runtime_error(
+            "listtokenholders \"groupid\" ( count skip )\n"
+            "\nReturns the addresses holding a token group, largest balance first. Requires -tokenindex.\n"
+            "\nArguments:\n"
+            "1. \"groupid\"     (string, required) the group identifier\n"
+            "2. count         (numeric, optional, default=100) the number of holders to return\n"
+            "3. skip          (numeric, optional, default=0) the number of holders to skip\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"address\": \"xxx\",     (string) the holding address\n"
+            "    \"balance\": \"x.xxx\",   (string) the token balance of the address\n"
+            "    \"balanceSat\": n       (numeric) the token balance in the smallest unit\n"
+            "  }\n"
+            "  ,...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("listtokenholders", "\"groupid\"")
+            + HelpExampleCli("listtokenholders", "\"groupid\" 10 20")
+            + HelpExampleRpc("listtokenholders", "\"groupid\", 10, 20")
+        );
+
+    CTokenGroupID grpID = ParseTokenGroupID(request.params[0]);
+
+    int nCount = 100;
+    if (!request.params[1].isNull()) {
+        nCount = request.params[1].get_int();
+    }
+    int nSkip = 0;
+    if (!request.params[2].isNull()) {
+        nSkip = request.params[2].get_int();
+    }
+    if (nCount < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative count");
+    }
+    if (nSkip < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative skip");
+    }
+
+    TokenIndex& tokenindex = EnsureTokenIndex();
+
+    std::vector<std::pair<CTokenBalanceKey, CAmount> > holders;
+    if (!tokenindex.GetTokenHolders(grpID, holders)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Unable to read token holders");
+    }
+
+    std::sort(holders.begin(), holders.end(),
+        [](const std::pair<CTokenBalanceKey, CAmount>& a, const std::pair<CTokenBalanceKey, CAmount>& b) {
+            return a.second > b.second;
+        });
+
+    UniValue ret(UniValue::VARR);
+    for (size_t i = nSkip; i < holders.size() && i < (size_t)nSkip + nCount; i++) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("address", EncodeTokenAddress(holders[i].first.addressType, holders[i].first.hashBytes));
+        entry.pushKV("balance", tokenGroupManager.get()->TokenValueFromAmount(holders[i].second, grpID));
+        entry.pushKV("balanceSat", holders[i].second);
+        ret.push_back(entry);
+    }
+    return ret;
+}
+
+extern UniValue gettokenaddressbalance(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 2)
+        throw std::runtime_error(
+            "gettokenaddressbalance \"address\" ( \"groupid\" )\n"
+            "\nReturns the token balances of an address. Requires -tokenindex.\n"
+            "\nArguments:\n"
+            "1. \"address\"     (string, required) the address\n"
+            "2. \"groupid\"     (string, optional) only return the balance of this group\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"groupID\": \"xxx\",     (string) the group identifier\n"
+            "    \"ticker\": \"xxx\",      (string) the token ticker\n"
+            "    \"balance\": \"x.xxx\",   (string) the token balance of the address\n"
+            "    \"balanceSat\": n       (numeric) the token balance in the smallest unit\n"
+            "  }\n"
+            "  ,...\n"
+            "]\n"
+            "\nExamples:\n"
+            + HelpExampleCli("gettokenaddressbalance", "\"address\"")
+            + HelpExampleCli("gettokenaddressbalance", "\"address\" \"groupid\"")
+            + HelpExampleRpc("gettokenaddressbalance", "\"address\", \"groupid\"")
+        );
+
+    CTxDestination dest = DecodeDestination(request.params[0].get_str());
+    uint8_t addressType;
+    uint160 hashBytes;
+    if (const CKeyID* keyID = boost::get<CKeyID>(&dest)) {
+        addressType = 1;
+        hashBytes = *keyID;
+    } else if (const CScriptID* scriptID = boost::get<CScriptID>(&dest)) {
+        addressType = 2;
+        hashBytes = *scriptID;
+    } else {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+    }
+
+    std::vector<CTokenGroupID> groups;
+    if (!request.params[1].isNull()) {
+        groups.push_back(ParseTokenGroupID(request.params[1]));
+    }
+
+    TokenIndex& tokenindex = EnsureTokenIndex();
+
+    if (groups.empty()) {
+        std::vector<std::pair<CTokenGroupID, CTokenGroupSupply> > supplies;
+        if (!tokenindex.GetAllTokenSupplies(supplies)) {
+            throw JSONRPCError(RPC_DATABASE_ERROR, "Unable to read token groups");
+        }
+        for (const auto& entry : supplies) {
+            groups.push_back(entry.first);
+        }
+    }
+
+    UniValue ret(UniValue::VARR);
+    for (const CTokenGroupID& grpID : groups) {
+        CAmount nBalance = tokenindex.GetTokenBalance(grpID, addressType, hashBytes);
+        if (nBalance == 0 && request.params[1].isNull()) {
+            continue;
+        }
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("groupID", EncodeTokenGroup(grpID));
+        entry.pushKV("ticker", tokenGroupManager.get()->GetTokenGroupTickerByID(grpID));
+        entry.pushKV("balance", tokenGroupManager.get()->TokenValueFromAmount(nBalance, grpID));
+        entry.pushKV("balanceSat", nBalance);
+        ret.push_back(entry);
+    }
+    return ret;
+}
+
 static const CRPCCommand commands[] =
 { //  category              name                        actor (function)            argNames
   //  --------------------- --------------------------  --------------------------  ----------
@@ -895,6 +1115,9 @@ static const CRPCCommand commands[] =
     { "tokens",             "encodetokenmetadata",   &encodetokenmetadata,    {"spec"} },
     { "tokens",             "decodetokenmetadata",   &decodetokenmetadata,    {} },
     { "tokens",             "verifytokenmetadata",   &verifytokenmetadata,    {"hex_data","creation_address", "signature"} },
+    { "tokens",             "gettokensupply",           &gettokensupply,            {"groupid"} },
+    { "tokens",             "listtokenholders",         &listtokenholders,          {"groupid", "count", "skip"} },
+    { "tokens",             "gettokenaddressbalance",   &gettokenaddressbalance,    {"address", "groupid"} },
 };
 
 void RegisterTokensRPCCommands(CRPCTable &t)
@@ -106,35 +106,14 @@ template void TGFilterURLCharacters(CTokenGroupDescriptionNFT& tgDesc);
 // Validation is performed after data is written to the database and before it is written to the map
 template <typename T>
 void TGFilterTickerUniqueness(T& tgDesc, const CTokenGroupID& tgID) {
-    // Iterate existing token groups and verify that the new group has a unique ticker
-    std::string strLowerTicker;
-    std::transform(tgDesc.strTicker.begin(), tgDesc.strTicker.end(), std::back_inserter(strLowerTicker), ::tolower);
-
-    std::map<CTokenGroupID, CTokenGroupCreation> mapTGs = tokenGroupManager.get()->GetMapTokenGroups();
-
-    if (strLowerTicker != "") {
-        std::find_if(
-            mapTGs.begin(),
-            mapTGs.end(),
-            [strLowerTicker, tgID, &tgDesc](const std::pair<CTokenGroupID, CTokenGroupCreation>& tokenGroup) {
-                    // Only try to match with valid token groups
-                    if (tokenGroup.second.tokenGroupInfo.invalid) return false;
-
-                    // If the ID is the same, the token group is the same
-                    if (tokenGroup.second.tokenGroupInfo.associatedGroup == tgID) return false;
-
-                    // Compare lower case
-                    std::string strHeapTicker = tgDescGetTicker(*tokenGroup.second.pTokenGroupDescription);
-                    std::string strHeapTickerLower;
-                    std::transform(strHeapTicker.begin(), strHeapTicker.end(), std::back_inserter(strHeapTickerLower), ::tolower);
-                    if (strLowerTicker == strHeapTickerLower){
-                        // Token ticker already exists
-                        tgDesc.strTicker = "";
-                        return true;
-                    }
-
-                    return false;
-                });
+    // Look up the ticker among the existing valid token groups and verify that the new group has a unique ticker
+    CTokenGroupID tgIDExisting;
+    if (tgDesc.strTicker != "" && tokenGroupManager.get()->GetValidTokenGroupIdByTicker(tgDesc.strTicker, tgIDExisting)) {
+        // If the ID is the same, the token group is the same
+        if (tgIDExisting != tgID) {
+            // Token ticker already exists
+            tgDesc.strTicker = "";
+        }
     }
 }
 template void TGFilterTickerUniqueness(CTokenGroupDescriptionRegular& tgDesc, const CTokenGroupID& tgID);
@@ -142,34 +121,14 @@ template void TGFilterTickerUniqueness(CTokenGroupDescriptionMGT& tgDesc, const
 
 template <typename T>
 void TGFilterNameUniqueness(T& tgDesc, const CTokenGroupID& tgID) {
-    // Iterate existing token groups and verify that the new group has a unique name
-    std::string strLowerName;
-    std::transform(tgDesc.strName.begin(), tgDesc.strName.end(), std::back_inserter(strLowerName), ::tolower);
-
-    std::map<CTokenGroupID, CTokenGroupCreation> mapTGs = tokenGroupManager.get()->GetMapTokenGroups();
-
-    if (strLowerName != "") {
-        std::find_if(
-            mapTGs.begin(),
-            mapTGs.end(),
-            [strLowerName, tgID, &tgDesc](const std::pair<CTokenGroupID, CTokenGroupCreation>& tokenGroup) {
-                    // Only try to match with valid token groups
-                    if (tokenGroup.second.tokenGroupInfo.invalid) return false;
-
-                    // If the ID is the same, the token group is the same
-                    if (tokenGroup.second.tokenGroupInfo.associatedGroup == tgID) return false;
-
-                    std::string strHeapName = tgDescGetName(*tokenGroup.second.pTokenGroupDescription);
-                    std::string strHeapNameLower;
-                    std::transform(strHeapName.begin(), strHeapName.end(), std::back_inserter(strHeapNameLower), ::tolower);
-                    if (strLowerName == strHeapNameLower){
-                        // Token name already exists
-                        tgDesc.strName = "";
-                        return true;
-                    }
-
-                    return false;
-                });
+    // Look up the name among the existing valid token groups and verify that the new group has a unique name
+    CTokenGroupID tgIDExisting;
+    if (tgDesc.strName != "" && tokenGroupManager.get()->GetValidTokenGroupIdByName(tgDesc.strName, tgIDExisting)) {
+        // If the ID is the same, the token group is the same
+        if (tgIDExisting != tgID) {
+            // Token name already exists
+            tgDesc.strName = "";
+        }
     }
 }
 template void TGFilterNameUniqueness(CTokenGroupDescriptionRegular& tgDesc, const CTokenGroupID& tgID);
@@ -18,8 +18,99 @@
 
 std::shared_ptr<CTokenGroupManager> tokenGroupManager;
 
+static std::string ToLower(const std::string& str) {
+    std::string strLower;
+    std::transform(str.begin(), str.end(), std::back_inserter(strLower), ::tolower);
+    return strLower;
+}
+
+bool CTokenGroupSnapshot::GetValidTokenGroupIdByTicker(const std::string& strTicker, CTokenGroupID& tokenGroupID) const {
+    const CTokenGroupID* pTokenGroupID = mapTickers.find(ToLower(strTicker));
+    if (!pTokenGroupID) return false;
+    tokenGroupID = *pTokenGroupID;
+    return true;
+}
+
+bool CTokenGroupSnapshot::GetValidTokenGroupIdByName(const std::string& strName, CTokenGroupID& tokenGroupID) const {
+    const CTokenGroupID* pTokenGroupID = mapNames.find(ToLower(strName));
+    if (!pTokenGroupID) return false;
+    tokenGroupID = *pTokenGroupID;
+    return true;
+}
+
+bool CTokenGroupSnapshot::GetTokenGroupIdByTicker(const std::string& strTicker, CTokenGroupID& tokenGroupID) const {
+    const std::string strNeedleTicker = ToLower(strTicker);
+    for (const CTokenGroupCreation* pTokenGroupCreation : GetSortedByID()) {
+        if (ToLower(tgDescGetTicker(*pTokenGroupCreation->pTokenGroupDescription)) == strNeedleTicker) {
+            tokenGroupID = pTokenGroupCreation->tokenGroupInfo.associatedGroup;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CTokenGroupSnapshot::GetTokenGroupIdByName(const std::string& strName, CTokenGroupID& tokenGroupID) const {
+    const std::string strNeedleName = ToLower(strName);
+    for (const CTokenGroupCreation* pTokenGroupCreation : GetSortedByID()) {
+        if (ToLower(tgDescGetName(*pTokenGroupCreation->pTokenGroupDescription)) == strNeedleName) {
+            tokenGroupID = pTokenGroupCreation->tokenGroupInfo.associatedGroup;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<const CTokenGroupCreation*> CTokenGroupSnapshot::GetSortedByID() const {
+    std::vector<const CTokenGroupCreation*> vTokenGroups;
+    vTokenGroups.reserve(mapTokenGroups.size());
+    for (const auto& tokenGroup : mapTokenGroups) {
+        vTokenGroups.emplace_back(&tokenGroup.second);
+    }
+    std::sort(vTokenGroups.begin(), vTokenGroups.end(), [](const CTokenGroupCreation* a, const CTokenGroupCreation* b) {
+        return a->tokenGroupInfo.associatedGroup < b->tokenGroupInfo.associatedGroup;
+    });
+    return vTokenGroups;
+}
+
+bool CTokenGroupSnapshot::Add(const CTokenGroupCreation& tokenGroupCreation) {
+    const CTokenGroupID& tgID = tokenGroupCreation.tokenGroupInfo.associatedGroup;
+    if (mapTokenGroups.count(tgID)) return false;
+    mapTokenGroups = mapTokenGroups.set(tgID, tokenGroupCreation);
+
+    // The first valid group to use a ticker or name keeps it, as the uniqueness filters blank later duplicates
+    if (tokenGroupCreation.tokenGroupInfo.invalid) return true;
+    std::string strTicker = ToLower(tgDescGetTicker(*tokenGroupCreation.pTokenGroupDescription));
+    if (strTicker != "" && !mapTickers.count(strTicker)) {
+        mapTickers = mapTickers.set(strTicker, tgID);
+    }
+    std::string strName = ToLower(tgDescGetName(*tokenGroupCreation.pTokenGroupDescription));
+    if (strName != "" && !mapNames.count(strName)) {
+        mapNames = mapNames.set(strName, tgID);
+    }
+    return true;
+}
+
+bool CTokenGroupSnapshot::Remove(const CTokenGroupID& tokenGroupID) {
+    const CTokenGroupCreation* pTokenGroupCreation = mapTokenGroups.find(tokenGroupID);
+    if (!pTokenGroupCreation) return false;
+    const std::string strTicker = ToLower(tgDescGetTicker(*pTokenGroupCreation->pTokenGroupDescription));
+    const std::string strName = ToLower(tgDescGetName(*pTokenGroupCreation->pTokenGroupDescription));
+    mapTokenGroups = mapTokenGroups.erase(tokenGroupID);
+
+    // No other valid group takes the ticker or name over, the uniqueness filters blanked them in the groups added later
+    const CTokenGroupID* pTickerID = mapTickers.find(strTicker);
+    if (pTickerID && *pTickerID == tokenGroupID) mapTickers = mapTickers.erase(strTicker);
+    const CTokenGroupID* pNameID = mapNames.find(strName);
+    if (pNameID && *pNameID == tokenGroupID) mapNames = mapNames.erase(strName);
+    return true;
+}
+
 CTokenGroupManager::CTokenGroupManager() {
-    mapTokenGroups.clear();
+}
+
+CTokenGroupSnapshot CTokenGroupManager::GetSnapshot() const {
+    LOCK(cs);
+    return tokenGroups;
 }
 
 bool CTokenGroupManager::StoreManagementTokenGroups(CTokenGroupCreation tokenGroupCreation) {
@@ -61,19 +152,19 @@ bool CTokenGroupManager::AddTokenGroups(const std::vector<CTokenGroupCreation>&
 
         StoreManagementTokenGroups(tokenGroupCreation);
 
-        auto ret = mapTokenGroups.insert(std::pair<CTokenGroupID, CTokenGroupCreation>(tokenGroupCreation.tokenGroupInfo.associatedGroup, tokenGroupCreation));
-
-        CTokenGroupCreation& tokenGroupCreationRet = (*ret.first).second;
-        bool fInsertedNew = ret.second;
+        // Publish every group on its own, the uniqueness filters of the next one check against it
+        LOCK(cs);
+        CTokenGroupSnapshot newTokenGroups = tokenGroups;
+        bool fInsertedNew = newTokenGroups.Add(tokenGroupCreation);
         if (!fInsertedNew) {
-            LogPrint(BCLog::TOKEN, "%s - Double token creation with tokenGroupID %s.\n", __func__, EncodeTokenGroup(tokenGroupCreationRet.tokenGroupInfo.associatedGroup));
+            LogPrint(BCLog::TOKEN, "%s - Double token creation with tokenGroupID %s.\n", __func__, EncodeTokenGroup(tokenGroupCreation.tokenGroupInfo.associatedGroup));
         }
+        tokenGroups = newTokenGroups;
     }
     return true;
 }
 
 void CTokenGroupManager::ResetTokenGroups() {
-    mapTokenGroups.clear();
     ClearManagementTokenGroups();
 
     CTokenGroupInfo tgInfoBYTZ(NoGroup, (CAmount)GroupAuthorityFlags::ALL);
@@ -81,8 +172,11 @@ void CTokenGroupManager::ResetTokenGroups() {
     CTokenGroupDescriptionVariant tgDescriptionBYTZ = CTokenGroupDescriptionRegular("BYTZ", "Bytz", 8, "https://bytz.gg", uint256());
     CTokenGroupStatus tokenGroupStatus;
     CTokenGroupCreation tgCreationBYTZ(MakeTransactionRef(tgTxBytz), uint256(), tgInfoBYTZ, std::make_shared<CTokenGroupDescriptionVariant>(tgDescriptionBYTZ), tokenGroupStatus);
-    mapTokenGroups.insert(std::pair<CTokenGroupID, CTokenGroupCreation>(NoGroup, tgCreationBYTZ));
+    CTokenGroupSnapshot newTokenGroups;
+    newTokenGroups.Add(tgCreationBYTZ);
 
+    LOCK(cs);
+    tokenGroups = newTokenGroups;
 }
 
 bool CTokenGroupManager::RemoveTokenGroup(CTransaction tx, CTokenGroupID &toRemoveTokenGroupID) {
@@ -108,10 +202,11 @@ bool CTokenGroupManager::RemoveTokenGroup(CTransaction tx, CTokenGroupID &toRemo
             tgGVTCreation.reset();
         }
 
-        std::map<CTokenGroupID, CTokenGroupCreation>::iterator iter = mapTokenGroups.find(tokenGroupInfo.associatedGroup);
-        if (iter != mapTokenGroups.end()) {
-            mapTokenGroups.erase(iter);
-            toRemoveTokenGroupID = iter->first;
+        LOCK(cs);
+        CTokenGroupSnapshot newTokenGroups = tokenGroups;
+        if (newTokenGroups.Remove(tokenGroupInfo.associatedGroup)) {
+            tokenGroups = newTokenGroups;
+            toRemoveTokenGroupID = tokenGroupInfo.associatedGroup;
             return true;
         }
     }
@@ -121,73 +216,55 @@ bool CTokenGroupManager::RemoveTokenGroup(CTransaction tx, CTokenGroupID &toRemo
 bool CTokenGroupManager::GetTokenGroupCreation(const CTokenGroupID& tgID, CTokenGroupCreation& tgCreation) {
     const CTokenGroupID grpID = tgID.isSubgroup() ? tgID.parentGroup() : tgID;
 
-    std::map<CTokenGroupID, CTokenGroupCreation>::iterator iter = mapTokenGroups.find(grpID);
-    if (iter != mapTokenGroups.end()) {
-        tgCreation = mapTokenGroups.at(grpID);
-    } else {
+    const CTokenGroupSnapshot snapshot = GetSnapshot();
+    const CTokenGroupCreation* pTokenGroupCreation = snapshot.Find(grpID);
+    if (!pTokenGroupCreation) {
         return false;
     }
+    tgCreation = *pTokenGroupCreation;
     return true;
 }
 std::string CTokenGroupManager::GetTokenGroupNameByID(CTokenGroupID tokenGroupId) {
-    CTokenGroupCreation tokenGroupCreation;
-    return GetTokenGroupCreation(tokenGroupId, tokenGroupCreation) ? tgDescGetName(*tokenGroupCreation.pTokenGroupDescription) : "";
+    const CTokenGroupSnapshot snapshot = GetSnapshot();
+    const CTokenGroupCreation* pTokenGroupCreation = snapshot.Find(tokenGroupId.isSubgroup() ? tokenGroupId.parentGroup() : tokenGroupId);
+    return pTokenGroupCreation ? tgDescGetName(*pTokenGroupCreation->pTokenGroupDescription) : "";
 }
 
 std::string CTokenGroupManager::GetTokenGroupTickerByID(CTokenGroupID tokenGroupId) {
-    CTokenGroupCreation tokenGroupCreation;
-    return GetTokenGroupCreation(tokenGroupId, tokenGroupCreation) ? tgDescGetName(*tokenGroupCreation.pTokenGroupDescription) : "";
+    const CTokenGroupSnapshot snapshot = GetSnapshot();
+    const CTokenGroupCreation* pTokenGroupCreation = snapshot.Find(tokenGroupId.isSubgroup() ? tokenGroupId.parentGroup() : tokenGroupId);
+    return pTokenGroupCreation ? tgDescGetName(*pTokenGroupCreation->pTokenGroupDescription) : "";
 }
 
 bool CTokenGroupManager::GetTokenGroupIdByTicker(std::string strTicker, CTokenGroupID &tokenGroupID) {
-    std::string strNeedleTicker;
-    std::transform(strTicker.begin(), strTicker.end(), std::back_inserter(strNeedleTicker), ::tolower);
-    auto result = std::find_if(
-        mapTokenGroups.begin(), mapTokenGroups.end(),
-        [strNeedleTicker](const std::pair<CTokenGroupID, CTokenGroupCreation>& tokenGroup) {
-            std::string strHeapTickerLower;
-            std::string strHeapTicker = tgDescGetTicker(*tokenGroup.second.pTokenGroupDescription);
-            std::transform(strHeapTicker.begin(), strHeapTicker.end(), std::back_inserter(strHeapTickerLower), ::tolower);
-            return strHeapTickerLower == strNeedleTicker;
-        });
-    if (result != mapTokenGroups.end()) {
-        tokenGroupID = result->first;
-        return true;
-    };
-    return false;
+    return GetSnapshot().GetTokenGroupIdByTicker(strTicker, tokenGroupID);
 }
 
 bool CTokenGroupManager::GetTokenGroupIdByName(std::string strName, CTokenGroupID &tokenGroupID) {
-    std::string strNeedleName;
-    std::transform(strName.begin(), strName.end(), std::back_inserter(strNeedleName), ::tolower);
-    auto result = std::find_if(
-        mapTokenGroups.begin(), mapTokenGroups.end(),
-        [strNeedleName](const std::pair<CTokenGroupID, CTokenGroupCreation>& tokenGroup) {
-            std::string strHeapNameLower;
-            std::string strHeapName = tgDescGetName(*tokenGroup.second.pTokenGroupDescription);
-            std::transform(strHeapName.begin(), strHeapName.end(), std::back_inserter(strHeapNameLower), ::tolower);
-            return strHeapNameLower == strNeedleName;
-        });
-    if (result != mapTokenGroups.end()) {
-        tokenGroupID = result->first;
-        return true;
-    };
-    return false;
+    return GetSnapshot().GetTokenGroupIdByName(strName, tokenGroupID);
+}
+
+bool CTokenGroupManager::GetValidTokenGroupIdByTicker(const std::string& strTicker, CTokenGroupID& tokenGroupID) {
+    return GetSnapshot().GetValidTokenGroupIdByTicker(strTicker, tokenGroupID);
+}
+
+bool CTokenGroupManager::GetValidTokenGroupIdByName(const std::string& strName, CTokenGroupID& tokenGroupID) {
+    return GetSnapshot().GetValidTokenGroupIdByName(strName, tokenGroupID);
 }
 
 bool CTokenGroupManager::ManagementTokensCreated() {
     return MGTTokensCreated() && GVTTokensCreated();
 }
 
-uint16_t CTokenGroupManager::GetTokensInBlock(const CBlock& block, const CTokenGroupID& tgId) {
+uint16_t CTokenGroupManager::GetTokensInBlock(const CBlock& block, const CTokenGroupID& tgId, CTokenGroupBlockData* pBlockData) {
     uint16_t nTokenCount = 0;
     if (tokenGroupManager) {
         for (unsigned int i = 0; i < block.vtx.size(); i++)
         {
-            for (const auto &outp : block.vtx[i]->vout)
+            CTokenGroupTxData tgTxDataLocal;
+            const CTokenGroupTxData& tgTxData = CTokenGroupBlockData::GetOrParse(pBlockData, *block.vtx[i], tgTxDataLocal);
+            for (const CTokenGroupInfo& tokenGrp : tgTxData.vOutputs)
             {
-                const CScript &scriptPubKey = outp.scriptPubKey;
-                CTokenGroupInfo tokenGrp(scriptPubKey);
                 if (!tokenGrp.invalid && tokenGrp.associatedGroup == tgId)
                 {
                     nTokenCount++;
@@ -200,16 +277,16 @@ uint16_t CTokenGroupManager::GetTokensInBlock(const CBlock& block, const CTokenG
 }
 
 unsigned int CTokenGroupManager::GetTokenTxStats(const CTransactionRef &tx, const CCoinsViewCache& view, const CTokenGroupID &tgId,
-                uint16_t &nTokenCount, CAmount &nTokenMint) {
+                uint16_t &nTokenCount, CAmount &nTokenMint, CTokenGroupBlockData* pBlockData) {
 
     CAmount nTxValueOut = 0;
     CAmount nTxValueIn = 0;
 
     if (!tx->IsCoinBase() && !tx->IsCoinStake() && !tx->HasZerocoinSpendInputs()) {
-        for (const auto &outp : tx->vout)
+        CTokenGroupTxData tgTxDataLocal;
+        const CTokenGroupTxData& tgTxData = CTokenGroupBlockData::GetOrParse(pBlockData, *tx, tgTxDataLocal);
+        for (const CTokenGroupInfo& tokenGrp : tgTxData.vOutputs)
         {
-            const CScript &scriptPubKey = outp.scriptPubKey;
-            CTokenGroupInfo tokenGrp(scriptPubKey);
             if (!tokenGrp.invalid && tokenGrp.associatedGroup == tgId && !tokenGrp.isAuthority())
             {
                 nTxValueOut += tokenGrp.quantity;
@@ -224,7 +301,7 @@ unsigned int CTokenGroupManager::GetTokenTxStats(const CTransactionRef &tx, cons
                 continue;
             const CScript &script = coin.out.scriptPubKey;
 
-            CTokenGroupInfo tokenGrp(script);
+            const CTokenGroupInfo tokenGrp = pBlockData ? pBlockData->GetOutput(prevout, script) : CTokenGroupInfo(script);
             if (!tokenGrp.invalid && tokenGrp.associatedGroup == tgId && !tokenGrp.isAuthority())
             {
                 nTxValueIn += tokenGrp.quantity;
@@ -279,7 +356,7 @@ std::string CTokenGroupManager::TokenValueFromAmount(const CAmount& amount, cons
     }
 }
 
-bool CTokenGroupManager::CheckFees(const CTransaction &tx, const std::unordered_map<CTokenGroupID, CTokenGroupBalance>& tgMintMeltBalance, CValidationState& state, const CBlockIndex* pindex) {
+bool CTokenGroupManager::CheckFees(const CTransaction &tx, const CTokenGroupTxData& tgTxData, const std::unordered_map<CTokenGroupID, CTokenGroupBalance>& tgMintMeltBalance, CValidationState& state, const CBlockIndex* pindex) {
     if (!tgMGTCreation) return true;
     // A token group creation costs 5x the standard TX fee
     // A token mint transaction costs 2x the standard TX fee
@@ -292,8 +369,7 @@ bool CTokenGroupManager::CheckFees(const CTransaction &tx, const std::unordered_
 
     CFeeRate feeRate = CFeeRate(DEFAULT_BLOCK_MIN_TX_FEE);
 
-    for (auto txout : tx.vout) {
-        CTokenGroupInfo grp(txout.scriptPubKey);
+    for (const CTokenGroupInfo& grp : tgTxData.vOutputs) {
         if (grp.invalid)
             return false;
         if (grp.isGroupCreation() && !grp.associatedGroup.hasFlag(TokenGroupIdFlags::MGT_TOKEN)) {
@@ -305,10 +381,9 @@ bool CTokenGroupManager::CheckFees(const CTransaction &tx, const std::unordered_
             tokenOutputs++;
         }
     }
-    for (auto bal : tgMintMeltBalance) {
-        CTokenGroupCreation tgCreation;
-        CTokenGroupID tgID = bal.first;
-        CTokenGroupBalance tgBalance = bal.second;
+    for (const auto& bal : tgMintMeltBalance) {
+        const CTokenGroupID& tgID = bal.first;
+        const CTokenGroupBalance& tgBalance = bal.second;
         if (tgBalance.output - tgBalance.input > 0) {
             // Mint
             if (!tgID.hasFlag(TokenGroupIdFlags::MGT_TOKEN)) {
@@ -7,23 +7,63 @@
 #define TOKEN_GROUP_MANAGER_H
 
 #include "consensus/tokengroups.h"
+#include "sync.h"
 #include "tokens/tokengroupconfiguration.h"
 
 #include <functional>
 #include <unordered_map>
 
+#include <immer/map.hpp>
+
 class CBlockIndex;
 class CTokenGroupManager;
 class UniValue;
 
 extern std::shared_ptr<CTokenGroupManager> tokenGroupManager;
 
+// Immutable view of all known token groups, with lookup tables by ticker and by name.
+// Copies share their structure, so readers can hold and iterate a snapshot without
+// locking or copying the token group descriptions.
+class CTokenGroupSnapshot
+{
+public:
+    typedef immer::map<CTokenGroupID, CTokenGroupCreation> TokenGroupMap;
+    typedef immer::map<std::string, CTokenGroupID> TokenGroupIdMap;
+
+private:
+    TokenGroupMap mapTokenGroups;
+    // lower case ticker and name of every valid token group
+    TokenGroupIdMap mapTickers;
+    TokenGroupIdMap mapNames;
+
+public:
+    size_t size() const { return mapTokenGroups.size(); }
+
+    TokenGroupMap::const_iterator begin() const { return mapTokenGroups.begin(); }
+    TokenGroupMap::const_iterator end() const { return mapTokenGroups.end(); }
+
+    const CTokenGroupCreation* Find(const CTokenGroupID& tgID) const { return mapTokenGroups.find(tgID); }
+    // Iteration above follows the hash order, this returns the groups ordered by ID. Valid as long as the snapshot.
+    std::vector<const CTokenGroupCreation*> GetSortedByID() const;
+    // Looks through all groups, invalid ones included, and returns the one with the lowest ID
+    bool GetTokenGroupIdByTicker(const std::string& strTicker, CTokenGroupID& tokenGroupID) const;
+    bool GetTokenGroupIdByName(const std::string& strName, CTokenGroupID& tokenGroupID) const;
+    // Looks up the valid group that was added first with the ticker or name, as the uniqueness filters need
+    bool GetValidTokenGroupIdByTicker(const std::string& strTicker, CTokenGroupID& tokenGroupID) const;
+    bool GetValidTokenGroupIdByName(const std::string& strName, CTokenGroupID& tokenGroupID) const;
+
+    // Returns false if a token group with the same ID already exists
+    bool Add(const CTokenGroupCreation& tokenGroupCreation);
+    bool Remove(const CTokenGroupID& tokenGroupID);
+};
+
 // TokenGroup Class
 // Keeps track of all of the token groups
 class CTokenGroupManager
 {
 private:
-    std::map<CTokenGroupID, CTokenGroupCreation> mapTokenGroups;
+    mutable CCriticalSection cs;
+    CTokenGroupSnapshot tokenGroups;
     std::unique_ptr<CTokenGroupCreation> tgMGTCreation;
     std::unique_ptr<CTokenGroupCreation> tgGVTCreation;
 
@@ -34,12 +74,16 @@ public:
     bool RemoveTokenGroup(CTransaction tx, CTokenGroupID &toRemoveTokenGroupID);
     void ResetTokenGroups();
 
+    // Returns the current token groups. The snapshot does not change when groups are added or removed later.
+    CTokenGroupSnapshot GetSnapshot() const;
+
     bool GetTokenGroupCreation(const CTokenGroupID& tgID, CTokenGroupCreation& tgCreation);
     std::string GetTokenGroupNameByID(CTokenGroupID tokenGroupId);
     std::string GetTokenGroupTickerByID(CTokenGroupID tokenGroupId);
     bool GetTokenGroupIdByTicker(std::string strTicker, CTokenGroupID &tokenGroupID);
     bool GetTokenGroupIdByName(std::string strName, CTokenGroupID &tokenGroupID);
-    std::map<CTokenGroupID, CTokenGroupCreation> GetMapTokenGroups() { return mapTokenGroups; };
+    bool GetValidTokenGroupIdByTicker(const std::string& strTicker, CTokenGroupID& tokenGroupID);
+    bool GetValidTokenGroupIdByName(const std::string& strName, CTokenGroupID& tokenGroupID);
 
     bool StoreManagementTokenGroups(CTokenGroupCreation tokenGroupCreation);
     void ClearManagementTokenGroups();
@@ -55,14 +99,15 @@ public:
 
     bool ManagementTokensCreated();
 
-    uint16_t GetTokensInBlock(const CBlock& block, const CTokenGroupID& tgId);
-    unsigned int GetTokenTxStats(const CTransactionRef &tx, const CCoinsViewCache& view, const CTokenGroupID &tgId, uint16_t &nTokenCount, CAmount &nTokenMint);
+    // The optional block data shares the parsed outputs with the other token checks of the block
+    uint16_t GetTokensInBlock(const CBlock& block, const CTokenGroupID& tgId, CTokenGroupBlockData* pBlockData = nullptr);
+    unsigned int GetTokenTxStats(const CTransactionRef &tx, const CCoinsViewCache& view, const CTokenGroupID &tgId, uint16_t &nTokenCount, CAmount &nTokenMint, CTokenGroupBlockData* pBlockData = nullptr);
 
     bool TokenMoneyRange(CAmount nValueOut);
     CAmount AmountFromTokenValue(const UniValue& value, const CTokenGroupID& tgID);
     std::string TokenValueFromAmount(const CAmount& amount, const CTokenGroupID& tgID);
 
-    bool CheckFees(const CTransaction &tx, const std::unordered_map<CTokenGroupID, CTokenGroupBalance>& tgMintMeltBalance, CValidationState& state, const CBlockIndex* pindex);
+    bool CheckFees(const CTransaction &tx, const CTokenGroupTxData& tgTxData, const std::unordered_map<CTokenGroupID, CTokenGroupBalance>& tgMintMeltBalance, CValidationState& state, const CBlockIndex* pindex);
 };
 
 #endif
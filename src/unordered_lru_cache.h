@@ -5,6 +5,8 @@
 #ifndef BITCOIN_UNORDERED_LRU_CACHE_H
 #define BITCOIN_UNORDERED_LRU_CACHE_H
 
+#include <memusage.h>
+
 #include <unordered_map>
 
 template<typename Key, typename Value, typename Hasher, size_t MaxSize = 0, size_t TruncateThreshold = 0>
@@ -28,6 +30,8 @@ public:
     }
 
     size_t max_size() const { return maxSize; }
+    size_t size() const { return cacheMap.size(); }
+    size_t DynamicUsage() const { return memusage::DynamicUsage(cacheMap); }
 
     template<typename Value2>
     void _emplace(const Key& key, Value2&& v)
@@ -26,6 +26,10 @@
 #include <consensus/validation.h>
 #include <cuckoocache.h>
 #include <hash.h>
+#include <index/addressindex.h>
+#include <index/spentindex.h>
+#include <index/timestampindex.h>
+#include <index/txindex.h>
 #include <init.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
@@ -37,6 +41,7 @@
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <reverse_iterator.h>
+#include <saltedhasher.h>
 #include <script/script.h>
 #include <script/sigcache.h>
 #include <script/standard.h>
@@ -74,6 +79,7 @@
 
 #include <future>
 #include <sstream>
+#include <unordered_set>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/thread.hpp>
@@ -251,10 +257,6 @@ uint256 g_best_block;
 int nScriptCheckThreads = 0;
 std::atomic_bool fImporting(false);
 std::atomic_bool fReindex(false);
-bool fTxIndex = true;
-bool fAddressIndex = false;
-bool fTimestampIndex = false;
-bool fSpentIndex = false;
 bool fHavePruned = false;
 bool fPruneMode = false;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
@@ -262,7 +264,9 @@ bool fRequireStandard = true;
 unsigned int nBytesPerSigOp = DEFAULT_BYTES_PER_SIGOP;
 bool fCheckBlockIndex = false;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
+bool fCheckZerocoinSpends = DEFAULT_CHECK_ZEROCOIN_SPENDS;
 size_t nCoinCacheUsage = 5000 * 300;
+static CCoinsFlushStats coinsFlushStats;
 uint64_t nPruneTarget = 0;
 int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
 
@@ -284,7 +288,7 @@ static void CheckBlockIndex(const Consensus::Params& consensusParams);
 CScript COINBASE_FLAGS;
 
 /** Proof of Stake */
-std::map<uint256, uint256> mapProofOfStake;
+unordered_lru_cache<uint256, uint256, StaticSaltedHasher> mapProofOfStake(PROOF_OF_STAKE_CACHE_SIZE);
 
 const std::string strMessageMagic = "DarkNet Signed Message:\n";
 
@@ -346,7 +350,7 @@ enum class FlushStateMode {
 static bool FlushStateToDisk(const CChainParams& chainParams, CValidationState &state, FlushStateMode mode, int nManualPruneHeight=0);
 static void FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nManualPruneHeight);
 static void FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPruneAfterHeight);
-bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks = nullptr);
+bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks = nullptr, CTokenGroupBlockData *pTokenGroupBlockData = nullptr);
 static FILE* OpenUndoFile(const CDiskBlockPos &pos, bool fReadOnly = false);
 
 bool CheckFinalTx(const CTransaction &tx, int flags)
@@ -936,12 +940,12 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
         statsClient.count("transactions.sigOps", nSigOps, 1.0f);
 
         // Add memory address index
-        if (fAddressIndex) {
+        if (g_addressindex) {
             pool.addAddressIndex(entry, view);
         }
 
         // Add memory spent index
-        if (fSpentIndex) {
+        if (g_spentindex) {
             pool.addSpentIndex(entry, view);
         }
 
@@ -992,10 +996,10 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState &state, const CTransa
 
 bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, std::vector<uint256> &hashes)
 {
-    if (!fTimestampIndex)
+    if (!g_timestampindex)
         return error("Timestamp index not enabled");
 
-    if (!pblocktree->ReadTimestampIndex(high, low, hashes))
+    if (!g_timestampindex->ReadTimestampIndex(high, low, hashes))
         return error("Unable to get hashes for timestamps");
 
     return true;
@@ -1003,13 +1007,13 @@ bool GetTimestampIndex(const unsigned int &high, const unsigned int &low, std::v
 
 bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value)
 {
-    if (!fSpentIndex)
+    if (!g_spentindex)
         return false;
 
     if (mempool.getSpentIndex(key, value))
         return true;
 
-    if (!pblocktree->ReadSpentIndex(key, value))
+    if (!g_spentindex->ReadSpentIndex(key, value))
         return false;
 
     return true;
@@ -1018,10 +1022,10 @@ bool GetSpentIndex(CSpentIndexKey &key, CSpentIndexValue &value)
 bool GetAddressIndex(uint160 addressHash, int type,
                      std::vector<std::pair<CAddressIndexKey, CAmount> > &addressIndex, int start, int end)
 {
-    if (!fAddressIndex)
+    if (!g_addressindex)
         return error("address index not enabled");
 
-    if (!pblocktree->ReadAddressIndex(addressHash, type, addressIndex, start, end))
+    if (!g_addressindex->ReadAddressIndex(addressHash, type, addressIndex, start, end))
         return error("unable to get txids for address");
 
     return true;
@@ -1030,10 +1034,10 @@ bool GetAddressIndex(uint160 addressHash, int type,
 bool GetAddressUnspent(uint160 addressHash, int type,
                        std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > &unspentOutputs)
 {
-    if (!fAddressIndex)
+    if (!g_addressindex)
         return error("address index not enabled");
 
-    if (!pblocktree->ReadAddressUnspentIndex(addressHash, type, unspentOutputs))
+    if (!g_addressindex->ReadAddressUnspentIndex(addressHash, type, unspentOutputs))
         return error("unable to get txids for address");
 
     return true;
@@ -1056,31 +1060,37 @@ bool GetTransaction(const uint256& hash, CTransactionRef& txOut, const Consensus
             return true;
         }
 
-        if (fTxIndex) {
-            CDiskTxPos postx;
-            if (pblocktree->ReadTxIndex(hash, postx)) {
-                CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
-                if (file.IsNull())
-                    return error("%s: OpenBlockFile failed", __func__);
-                CBlockHeader header;
-                try {
-                    file >> header;
-                    fseek(file.Get(), postx.nTxOffset, SEEK_CUR);
-                    file >> txOut;
-                } catch (const std::exception& e) {
-                    return error("%s: Deserialize or I/O error - %s", __func__, e.what());
-                }
-                hashBlock = header.GetHash();
-                if (txOut->GetHash() != hash)
-                    return error("%s: txid mismatch", __func__);
+        if (g_txindex) {
+            if (g_txindex->FindTx(hash, hashBlock, txOut)) {
                 if (!mapBlockIndex.count(hashBlock)) {
                     return error("%s: hashBlock %s not in mapBlockIndex", __func__, hashBlock.ToString());
                 }
                 return true;
             }
 
-            // transaction not found in index, nothing more can be done
-            return false;
+            // The index is updated from the validation interface queue, so even a synced index might not have
+            // seen the latest blocks yet. Only those are searched directly, after that nothing more can be done
+            if (g_txindex->IsSynced()) {
+                const CBlockIndex* pindexBest = g_txindex->GetBestBlockIndex();
+                if (pindexBest == chainActive.Tip()) {
+                    return false;
+                }
+                const CBlockIndex* pindexFork = pindexBest ? chainActive.FindFork(pindexBest) : nullptr;
+                for (const CBlockIndex* pindex = chainActive.Tip(); pindex && pindex != pindexFork; pindex = pindex->pprev) {
+                    CBlock block;
+                    if (!ReadBlockFromDisk(block, pindex, consensusParams)) {
+                        return error("%s: failed to read block %s", __func__, pindex->GetBlockHash().ToString());
+                    }
+                    for (const auto& tx : block.vtx) {
+                        if (tx->GetHash() == hash) {
+                            txOut = tx;
+                            hashBlock = pindex->GetBlockHash();
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            }
         }
 
         if (fAllowSlow) { // use coin database to locate block that contains transaction, and scan it
@@ -1435,35 +1445,41 @@ void InitScriptExecutionCache() {
  * which are matched. This is useful for checking blocks where we will likely never need the cache
  * entry again.
  *
+ * If pTokenGroupBlockData is not nullptr, the parsed token group outputs of the transaction are kept
+ * there for the remaining transactions of the block that spend them.
+ *
  * Non-static (and re-declared) in src/test/txvalidationcache_tests.cpp
  */
-bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks)
+bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks, CTokenGroupBlockData *pTokenGroupBlockData)
 {
     boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
     if (!tx.IsCoinBase() && !tx.HasZerocoinSpendInputs())
     {
         if ((unsigned int)chainActive.Tip()->nHeight >= Params().GetConsensus().ATPStartHeight) {
+            // Parse the token group outputs once for all token checks below
+            CTokenGroupTxData tgTxDataLocal;
+            const CTokenGroupTxData& tgTxData = CTokenGroupBlockData::GetOrParse(pTokenGroupBlockData, tx, tgTxDataLocal);
+
             std::unordered_map<CTokenGroupID, CTokenGroupBalance> tgMintMeltBalance;
             CBlockIndex* pindexPrev = mapBlockIndex.find(inputs.GetBestBlock())->second;
-            if (!CheckTokenGroups(tx, state, inputs, tgMintMeltBalance))
+            if (!CheckTokenGroups(tx, tgTxData, state, inputs, tgMintMeltBalance, pTokenGroupBlockData))
                 return state.DoS(0, error("Token group inputs and outputs do not balance"), REJECT_MALFORMED, "token-group-imbalance");
 
             //Check that all token transactions paid their fees
-            if (IsAnyOutputGrouped(tx)) {
-                if (!tokenGroupManager.get()->CheckFees(tx, tgMintMeltBalance, state, pindexPrev)) {
+            if (tgTxData.fAnyGrouped) {
+                if (!tokenGroupManager.get()->CheckFees(tx, tgTxData, tgMintMeltBalance, state, pindexPrev)) {
                     return state.DoS(0, error("Token transaction does not pay enough fees"), REJECT_MALFORMED, "token-group-imbalance");
                 }
                 if (!tokenGroupManager.get()->ManagementTokensCreated()){
-                    for (const CTxOut &txout : tx.vout)
+                    for (const CTokenGroupInfo& grp : tgTxData.vOutputs)
                     {
-                        CTokenGroupInfo grp(txout.scriptPubKey);
                         if ((grp.invalid || grp.associatedGroup != NoGroup) && !grp.associatedGroup.hasFlag(TokenGroupIdFlags::MGT_TOKEN)) {
                             return state.DoS(0, false, REJECT_NONSTANDARD, "op_group-before-mgt-tokens");
                         }
                     }
                 }
             }
-            for (std::pair<CTokenGroupID, CTokenGroupBalance> mintMeltItem : tgMintMeltBalance) {
+            for (const auto& mintMeltItem : tgMintMeltBalance) {
                 if (mintMeltItem.first.hasFlag(TokenGroupIdFlags::NFT_TOKEN) && mintMeltItem.second.output > 0) {
                     CTokenGroupCreation tgCreation;
                     if (!tokenGroupManager.get()->GetTokenGroupCreation(mintMeltItem.first, tgCreation)) {
@@ -1593,7 +1609,27 @@ bool UndoWriteToDisk(const CBlockUndo& blockundo, CDiskBlockPos& pos, const uint
     return true;
 }
 
-static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
+/** Abort with a message */
+bool AbortNode(const std::string& strMessage, const std::string& userMessage="")
+{
+    SetMiscWarning(strMessage);
+    LogPrintf("*** %s\n", strMessage);
+    uiInterface.ThreadSafeMessageBox(
+        userMessage.empty() ? _("Error: A fatal internal error occurred, see debug.log for details") : userMessage,
+        "", CClientUIInterface::MSG_ERROR);
+    StartShutdown();
+    return false;
+}
+
+bool AbortNode(CValidationState& state, const std::string& strMessage, const std::string& userMessage="")
+{
+    AbortNode(strMessage, userMessage);
+    return state.Error(strMessage);
+}
+
+} // namespace
+
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
 {
     CDiskBlockPos pos = pindex->GetUndoPos();
     if (pos.IsNull()) {
@@ -1624,26 +1660,6 @@ static bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex *pindex)
     return true;
 }
 
-/** Abort with a message */
-bool AbortNode(const std::string& strMessage, const std::string& userMessage="")
-{
-    SetMiscWarning(strMessage);
-    LogPrintf("*** %s\n", strMessage);
-    uiInterface.ThreadSafeMessageBox(
-        userMessage.empty() ? _("Error: A fatal internal error occurred, see debug.log for details") : userMessage,
-        "", CClientUIInterface::MSG_ERROR);
-    StartShutdown();
-    return false;
-}
-
-bool AbortNode(CValidationState& state, const std::string& strMessage, const std::string& userMessage="")
-{
-    AbortNode(strMessage, userMessage);
-    return state.Error(strMessage);
-}
-
-} // namespace
-
 /**
  * Restore the UTXO in a Coin at a given COutPoint
  * @param undo The Coin to be restored.
@@ -1707,10 +1723,6 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         return DISCONNECT_FAILED;
     }
 
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
-    std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
-
     if (!UndoSpecialTxsInBlock(block, pindex)) {
         return DISCONNECT_FAILED;
     }
@@ -1722,41 +1734,6 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         bool is_coinbase = tx.IsCoinBase();
         bool is_coinstake = tx.IsCoinStake();
 
-        if (fAddressIndex) {
-
-            for (unsigned int k = tx.vout.size(); k-- > 0;) {
-                const CTxOut &out = tx.vout[k];
-
-                if (out.scriptPubKey.IsPayToScriptHash()) {
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin()+2, out.scriptPubKey.begin()+22);
-
-                    // undo receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(2, uint160(hashBytes), pindex->nHeight, i, hash, k, false), out.nValue));
-
-                    // undo unspent index
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(2, uint160(hashBytes), hash, k), CAddressUnspentValue()));
-
-                } else if (out.scriptPubKey.IsPayToPublicKeyHash()) {
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin()+3, out.scriptPubKey.begin()+23);
-
-                    // undo receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(1, uint160(hashBytes), pindex->nHeight, i, hash, k, false), out.nValue));
-
-                    // undo unspent index
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), hash, k), CAddressUnspentValue()));
-
-                } else if (out.scriptPubKey.IsPayToPublicKey()) {
-                    uint160 hashBytes(Hash160(out.scriptPubKey.begin()+1, out.scriptPubKey.end()-1));
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, pindex->nHeight, i, hash, k, false), out.nValue));
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, hashBytes, hash, k), CAddressUnspentValue()));
-                } else {
-                    continue;
-                }
-
-            }
-
-        }
-
         // Check that all outputs are available and match the outputs in the block itself
         // exactly.
         for (size_t o = 0; o < tx.vout.size(); o++) {
@@ -1779,49 +1756,9 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
             }
             for (unsigned int j = tx.vin.size(); j-- > 0;) {
                 const COutPoint &out = tx.vin[j].prevout;
-                int undoHeight = txundo.vprevout[j].nHeight;
                 int res = ApplyTxInUndo(std::move(txundo.vprevout[j]), view, out);
                 if (res == DISCONNECT_FAILED) return DISCONNECT_FAILED;
                 fClean = fClean && res != DISCONNECT_UNCLEAN;
-
-                const CTxIn input = tx.vin[j];
-
-                if (fSpentIndex) {
-                    // undo and delete the spent index
-                    spentIndex.push_back(std::make_pair(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue()));
-                }
-
-                if (fAddressIndex) {
-                    const Coin &coin = view.AccessCoin(tx.vin[j].prevout);
-                    const CTxOut &prevout = coin.out;
-                    if (prevout.scriptPubKey.IsPayToScriptHash()) {
-                        std::vector<unsigned char> hashBytes(prevout.scriptPubKey.begin()+2, prevout.scriptPubKey.begin()+22);
-
-                        // undo spending activity
-                        addressIndex.push_back(std::make_pair(CAddressIndexKey(2, uint160(hashBytes), pindex->nHeight, i, hash, j, true), prevout.nValue * -1));
-
-                        // restore unspent index
-                        addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(2, uint160(hashBytes), input.prevout.hash, input.prevout.n), CAddressUnspentValue(prevout.nValue, prevout.scriptPubKey, undoHeight)));
-
-
-                    } else if (prevout.scriptPubKey.IsPayToPublicKeyHash()) {
-                        std::vector<unsigned char> hashBytes(prevout.scriptPubKey.begin()+3, prevout.scriptPubKey.begin()+23);
-
-                        // undo spending activity
-                        addressIndex.push_back(std::make_pair(CAddressIndexKey(1, uint160(hashBytes), pindex->nHeight, i, hash, j, true), prevout.nValue * -1));
-
-                        // restore unspent index
-                        addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), input.prevout.hash, input.prevout.n), CAddressUnspentValue(prevout.nValue, prevout.scriptPubKey, undoHeight)));
-
-                    } else if (prevout.scriptPubKey.IsPayToPublicKey()) {
-                        uint160 hashBytes(Hash160(prevout.scriptPubKey.begin()+1, prevout.scriptPubKey.end()-1));
-                        addressIndex.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, pindex->nHeight, i, hash, j, false), prevout.nValue));
-                        addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, hashBytes, hash, j), CAddressUnspentValue()));
-                    } else {
-                        continue;
-                    }
-                }
-
             }
             if (IsAnyOutputGroupedCreation(tx) && fDisconnectTokens) {
                 CTokenGroupID toRemoveTokenGroupID;
@@ -1837,24 +1774,6 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         return DISCONNECT_FAILED;
     }
 
-    if (fSpentIndex) {
-        if (!pblocktree->UpdateSpentIndex(spentIndex)) {
-            AbortNode("Failed to delete spent index");
-            return DISCONNECT_FAILED;
-        }
-    }
-
-    if (fAddressIndex) {
-        if (!pblocktree->EraseAddressIndex(addressIndex)) {
-            AbortNode("Failed to delete address index");
-            return DISCONNECT_FAILED;
-        }
-        if (!pblocktree->UpdateAddressUnspentIndex(addressUnspentIndex)) {
-            AbortNode("Failed to write address unspent index");
-            return DISCONNECT_FAILED;
-        }
-    }
-
     // move best block pointer to prevout block
     view.SetBestBlock(pindex->pprev->GetBlockHash());
     evoDb->WriteBestBlock(pindex->pprev->GetBlockHash());
@@ -1915,31 +1834,54 @@ static bool WriteUndoDataForBlock(const CBlockUndo& blockundo, CValidationState&
     return true;
 }
 
-static bool WriteTxIndexDataForBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex)
+static CCheckQueue<CScriptCheck> scriptcheckqueue(128);
+
+void ThreadScriptCheck() {
+    RenameThread("bytz-scriptch");
+    scriptcheckqueue.Thread();
+}
+
+/** Reads one coin from the coin database for PrefetchBlockInputs. */
+class CCoinPrefetch
 {
-    if (!fTxIndex) return true;
+private:
+    const CCoinsView* view;
+    COutPoint outpoint;
+    Coin* coin;
+
+public:
+    CCoinPrefetch() : view(nullptr), coin(nullptr) {}
+    CCoinPrefetch(const CCoinsView* viewIn, const COutPoint& outpointIn, Coin* coinIn) : view(viewIn), outpoint(outpointIn), coin(coinIn) {}
 
-    CDiskTxPos pos(pindex->GetBlockPos(), GetSizeOfCompactSize(block.vtx.size()));
-    std::vector<std::pair<uint256, CDiskTxPos> > vPos;
-    vPos.reserve(block.vtx.size());
-    for (const CTransactionRef& tx : block.vtx)
+    bool operator()()
     {
-        vPos.push_back(std::make_pair(tx->GetHash(), pos));
-        pos.nTxOffset += ::GetSerializeSize(*tx, SER_DISK, CLIENT_VERSION);
+        // A missing coin is left spent; ConnectBlock reports it when it looks the coin up again.
+        if (!view->GetCoin(outpoint, *coin)) {
+            coin->Clear();
+        }
+        return true;
     }
 
-    if (!pblocktree->WriteTxIndex(vPos)) {
-        return AbortNode(state, "Failed to write transaction index");
+    void swap(CCoinPrefetch& check)
+    {
+        std::swap(view, check.view);
+        std::swap(outpoint, check.outpoint);
+        std::swap(coin, check.coin);
     }
+};
 
-    return true;
+static CCheckQueue<CCoinPrefetch> coinprefetchqueue(16);
+
+void ThreadCoinPrefetch() {
+    RenameThread("bytz-prefetch");
+    coinprefetchqueue.Thread();
 }
 
-static CCheckQueue<CScriptCheck> scriptcheckqueue(128);
+static CCheckQueue<CZerocoinSpendCheck> zerocoincheckqueue(16);
 
-void ThreadScriptCheck() {
-    RenameThread("bytz-scriptch");
-    scriptcheckqueue.Thread();
+void ThreadZerocoinSpendCheck() {
+    RenameThread("bytz-zcspendch");
+    zerocoincheckqueue.Thread();
 }
 
 // Protected by cs_main
@@ -2147,6 +2089,13 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
         }
     }
 
+    // Zerocoin is disabled since V17, so its historical spends and mints are only checked as far as the
+    // scripts are: for assumed-valid blocks they are parsed to keep the zerocoin database complete, but
+    // the chain lookups and accumulator checks are skipped.
+    const bool fZerocoinChecks = fScriptChecks;
+    // The signatures and serials of the spends are only verified on request, see -checkzerocoinspends.
+    const bool fZerocoinSpendChecks = fZerocoinChecks && fCheckZerocoinSpends;
+
     int64_t nTime1 = GetTimeMicros(); nTimeCheck += nTime1 - nTimeStart;
     LogPrint(BCLog::BENCHMARK, "    - Sanity checks: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime1 - nTimeStart), nTimeCheck * MICRO, nTimeCheck * MILLI / nBlocksTotal);
 
@@ -2218,8 +2167,8 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
         }
 
         uint256 hash = block.GetHash();
-        if(!mapProofOfStake.count(hash)) // add to mapProofOfStake
-            mapProofOfStake.insert(std::make_pair(hash, hashProofOfStake));
+        if(!mapProofOfStake.exists(hash)) // add to mapProofOfStake
+            mapProofOfStake.insert(hash, hashProofOfStake);
     }
 
     int64_t nTime2 = GetTimeMicros(); nTimeForks += nTime2 - nTime1;
@@ -2228,15 +2177,13 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     CBlockUndo blockundo;
 
     CCheckQueueControl<CScriptCheck> control(fScriptChecks && nScriptCheckThreads ? &scriptcheckqueue : nullptr);
+    CCheckQueueControl<CZerocoinSpendCheck> zerocoinControl(fZerocoinSpendChecks && nScriptCheckThreads ? &zerocoincheckqueue : nullptr);
 
     std::vector<int> prevheights;
     CAmount nFees = 0;
     int nInputs = 0;
     unsigned int nSigOps = 0;
     blockundo.vtxundo.reserve(block.vtx.size() - 1);
-    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
-    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> > addressUnspentIndex;
-    std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
     std::vector<uint256> vSpendsInBlock;
     CAmount nValueIn = 0;
     //! Zerocoin
@@ -2244,6 +2191,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     std::vector<std::pair<libzerocoin::PublicCoin, uint256> > vMints;
     //! ATP
     std::vector<CTokenGroupCreation> newTokenGroups;
+    CTokenGroupBlockData tgBlockData;
 
     std::vector<PrecomputedTransactionData> txdata;
     txdata.reserve(block.vtx.size()); // Required so that pointers to individual PrecomputedTransactionData don't get invalidated
@@ -2268,7 +2216,6 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     for (unsigned int i = 0; i < block.vtx.size(); i++)
     {
         const CTransactionRef tx = block.vtx[i];
-        const uint256 txhash = tx->GetHash();
 
         nInputs += tx->vin.size();
 
@@ -2278,8 +2225,18 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 
         if (tx->HasZerocoinSpendInputs())
         {
-            if (!CheckZerocoinSpendTx(pindex, state, *tx, vSpendsInBlock, vSpends, vMints, nValueIn))
+            std::vector<CZerocoinSpendCheck> vSpendChecks;
+            if (!CheckZerocoinSpendTx(pindex, state, *tx, vSpendsInBlock, vSpends, vMints, nValueIn, fZerocoinChecks, fZerocoinSpendChecks ? &vSpendChecks : nullptr))
                 return false;
+            if (nScriptCheckThreads) {
+                zerocoinControl.Add(vSpendChecks);
+            } else {
+                for (auto& check : vSpendChecks) {
+                    if (!check())
+                        return state.DoS(100, error("%s: invalid zerocoin spend in tx %s", __func__, tx->GetHash().ToString()),
+                                         REJECT_INVALID, "bad-txns-invalid-zbytz");
+                }
+            }
         } else if (!tx->IsCoinBase())
         {
             CAmount txfee = 0;
@@ -2305,45 +2262,6 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
                                  REJECT_INVALID, "bad-txns-nonfinal");
             }
 
-            if (fAddressIndex || fSpentIndex)
-            {
-                for (size_t j = 0; j < tx->vin.size(); j++) {
-                    const CTxIn input = tx->vin[j];
-                    const Coin& coin = view.AccessCoin(tx->vin[j].prevout);
-                    const CTxOut &prevout = coin.out;
-                    uint160 hashBytes;
-                    int addressType;
-
-                    if (prevout.scriptPubKey.IsPayToScriptHash()) {
-                        hashBytes = uint160(std::vector<unsigned char>(prevout.scriptPubKey.begin()+2, prevout.scriptPubKey.begin()+22));
-                        addressType = 2;
-                    } else if (prevout.scriptPubKey.IsPayToPublicKeyHash()) {
-                        hashBytes = uint160(std::vector<unsigned char>(prevout.scriptPubKey.begin()+3, prevout.scriptPubKey.begin()+23));
-                        addressType = 1;
-                    } else if (prevout.scriptPubKey.IsPayToPublicKey()) {
-                        hashBytes = Hash160(prevout.scriptPubKey.begin()+1, prevout.scriptPubKey.end()-1);
-                        addressType = 1;
-                    } else {
-                        hashBytes.SetNull();
-                        addressType = 0;
-                    }
-
-                    if (fAddressIndex && addressType > 0) {
-                        // record spending activity
-                        addressIndex.push_back(std::make_pair(CAddressIndexKey(addressType, hashBytes, pindex->nHeight, i, txhash, j, true), prevout.nValue * -1));
-
-                        // remove address from unspent index
-                        addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(addressType, hashBytes, input.prevout.hash, input.prevout.n), CAddressUnspentValue()));
-                    }
-
-                    if (fSpentIndex) {
-                        // add the spent index to determine the txid and input that spent an output
-                        // and to find the amount and address from an input
-                        spentIndex.push_back(std::make_pair(CSpentIndexKey(input.prevout.hash, input.prevout.n), CSpentIndexValue(txhash, j, pindex->nHeight, prevout.nValue, addressType, hashBytes)));
-                    }
-                }
-
-            }
             if (IsAnyOutputGroupedCreation(*tx)) {
                 if (pindex->nHeight < chainparams.GetConsensus().ATPStartHeight) {
                     return state.DoS(0, false, REJECT_NONSTANDARD, "premature-op_group-tx");
@@ -2377,7 +2295,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
                     if (!TxOutToPublicCoin(out, coin, state))
                         return state.DoS(100, error("%s: failed final check of zerocoinmint for tx %s", __func__, tx->GetHash().GetHex()));
 
-                    if (!ContextualCheckZerocoinMint(coin, pindex))
+                    if (!ContextualCheckZerocoinMint(coin, pindex, fZerocoinChecks))
                         return state.DoS(100, error("%s: zerocoin mint failed contextual check", __func__));
 
                     vMints.emplace_back(std::make_pair(coin, tx->GetHash()));
@@ -2399,45 +2317,12 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 
             std::vector<CScriptCheck> vChecks;
             bool fCacheResults = fJustCheck; /* Don't cache results if we're actually connecting blocks (still consult the cache, though) */
-            if (!CheckInputs(*tx, state, view, fScriptChecks, flags, fCacheResults, fCacheResults, txdata[i], nScriptCheckThreads ? &vChecks : nullptr))
+            if (!CheckInputs(*tx, state, view, fScriptChecks, flags, fCacheResults, fCacheResults, txdata[i], nScriptCheckThreads ? &vChecks : nullptr, &tgBlockData))
                 return error("ConnectBlock(): CheckInputs on %s failed with %s",
                     tx->GetHash().ToString(), FormatStateMessage(state));
             control.Add(vChecks);
         }
 
-        if (fAddressIndex) {
-            for (unsigned int k = 0; k < tx->vout.size(); k++) {
-                const CTxOut &out = tx->vout[k];
-
-                if (out.scriptPubKey.IsPayToScriptHash()) {
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin()+2, out.scriptPubKey.begin()+22);
-
-                    // record receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(2, uint160(hashBytes), pindex->nHeight, i, txhash, k, false), out.nValue));
-
-                    // record unspent output
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(2, uint160(hashBytes), txhash, k), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight)));
-
-                } else if (out.scriptPubKey.IsPayToPublicKeyHash()) {
-                    std::vector<unsigned char> hashBytes(out.scriptPubKey.begin()+3, out.scriptPubKey.begin()+23);
-
-                    // record receiving activity
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(1, uint160(hashBytes), pindex->nHeight, i, txhash, k, false), out.nValue));
-
-                    // record unspent output
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, uint160(hashBytes), txhash, k), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight)));
-
-                } else if (out.scriptPubKey.IsPayToPublicKey()) {
-                    uint160 hashBytes(Hash160(out.scriptPubKey.begin()+1, out.scriptPubKey.end()-1));
-                    addressIndex.push_back(std::make_pair(CAddressIndexKey(1, hashBytes, pindex->nHeight, i, txhash, k, false), out.nValue));
-                    addressUnspentIndex.push_back(std::make_pair(CAddressUnspentKey(1, hashBytes, txhash, k), CAddressUnspentValue(out.nValue, out.scriptPubKey, pindex->nHeight)));
-                } else {
-                    continue;
-                }
-
-            }
-        }
-
         CTxUndo undoDummy;
         if (i > 0) {
             blockundo.vtxundo.push_back(CTxUndo());
@@ -2449,6 +2334,8 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 
     if (!control.Wait())
         return state.DoS(100, error("%s: CheckQueue failed", __func__), REJECT_INVALID, "block-validation-failed");
+    if (!zerocoinControl.Wait())
+        return state.DoS(100, error("%s: zerocoin spend CheckQueue failed", __func__), REJECT_INVALID, "bad-txns-invalid-zbytz");
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
     LogPrint(BCLog::BENCHMARK, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1, MILLI * (nTime4 - nTime2), nInputs <= 1 ? 0 : MILLI * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * MICRO, nTimeVerify * MILLI / nBlocksTotal);
 
@@ -2532,7 +2419,8 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 
     pindex->nCarbonFeesEscrow = nCarbonFeesEscrow;
 
-    // Ensure that accumulator checkpoints are valid and in the same state as this instance of the chain
+    // Ensure that accumulator checkpoints are valid and in the same state as this instance of the chain.
+    // ValidateAccumulatorCheckpoint is currently disabled and always succeeds.
     AccumulatorMap mapAccumulators(Params().Zerocoin_Params(pindex->nHeight < Params().GetConsensus().nBlockZerocoinV2));
     if (!ValidateAccumulatorCheckpoint(block, pindex, mapAccumulators)) {
         if (!ShutdownRequested()) {
@@ -2554,34 +2442,20 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
         setDirtyBlockIndex.insert(pindex);
     }
 
-    if (!WriteTxIndexDataForBlock(block, state, pindex))
-        return false;
-
     // Flush spend/mint info to disk
     if (!zerocoinDB->WriteCoinSpendBatch(vSpends)) return AbortNode(state, ("Failed to record coin serials to database"));
     if (!zerocoinDB->WriteCoinMintBatch(vMints)) return AbortNode(state, ("Failed to record new mints to database"));
+    if (!vMints.empty()) {
+        std::list<libzerocoin::PublicCoin> listPubcoins;
+        for (const auto& mint : vMints)
+            listPubcoins.emplace_back(mint.first);
+        if (!zerocoinDB->WriteBlockPubcoins(pindex->nHeight, pindex->GetBlockHash(), listPubcoins))
+            return AbortNode(state, ("Failed to index the mints of the block"));
+    }
 
     //Record accumulator checksums
     DatabaseChecksums(mapAccumulators);
 
-    if (fAddressIndex) {
-        if (!pblocktree->WriteAddressIndex(addressIndex)) {
-            return AbortNode(state, "Failed to write address index");
-        }
-
-        if (!pblocktree->UpdateAddressUnspentIndex(addressUnspentIndex)) {
-            return AbortNode(state, "Failed to write address unspent index");
-        }
-    }
-
-    if (fSpentIndex)
-        if (!pblocktree->UpdateSpentIndex(spentIndex))
-            return AbortNode(state, "Failed to write transaction index");
-
-    if (fTimestampIndex)
-        if (!pblocktree->WriteTimestampIndex(CTimestampIndexKey(pindex->nTime, pindex->GetBlockHash())))
-            return AbortNode(state, "Failed to write timestamp index");
-
     if (!pTokenDB->WriteTokenGroupsBatch(newTokenGroups))
         return AbortNode(state, "Failed to write token creation data");
     if (!tokenGroupManager.get()->AddTokenGroups(newTokenGroups)) {
@@ -2714,9 +2588,24 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
             // overwrite one. Still, use a conservative safety factor of 2.
             if (!CheckDiskSpace(48 * 2 * 2 * pcoinsTip->GetCacheSize()))
                 return state.Error("out of disk space");
-            // Flush the chainstate (which may refer to block index entries).
-            if (!pcoinsTip->Flush())
+            // Flush the chainstate (which may refer to block index entries). Only modified
+            // coins are written and the rest stay cached, so the working set survives the
+            // flush. When the cache ran into its limit, the oldest unmodified coins make room.
+            size_t nWritten = 0;
+            if (!pcoinsTip->Sync(nWritten))
                 return AbortNode(state, "Failed to write to coin database");
+            size_t nEvicted = 0;
+            if (fCacheLarge || fCacheCritical) {
+                nEvicted = pcoinsTip->Trim(nCoinCacheUsage / 100 * COINS_CACHE_RETAIN_PERCENT);
+            }
+            LogPrint(BCLog::COINDB, "%s: wrote %u coins, evicted %u, %u coins (%.1fMiB) left in cache\n", __func__,
+                nWritten, nEvicted, pcoinsTip->GetCacheSize(), pcoinsTip->DynamicMemoryUsage() * (1.0 / 1024 / 1024));
+            coinsFlushStats.nFlushes++;
+            coinsFlushStats.nLastFlushTime = nNow / 1000000;
+            coinsFlushStats.nLastFlushWritten = nWritten;
+            coinsFlushStats.nLastFlushEvicted = nEvicted;
+            coinsFlushStats.nTotalWritten += nWritten;
+            coinsFlushStats.nTotalEvicted += nEvicted;
             if (!evoDb->CommitRootTransaction()) {
                 return AbortNode(state, "Failed to commit EvoDB");
             }
@@ -2734,6 +2623,12 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
     return true;
 }
 
+CCoinsFlushStats GetCoinsFlushStats()
+{
+    LOCK(cs_main);
+    return coinsFlushStats;
+}
+
 void FlushStateToDisk() {
     CValidationState state;
     const CChainParams& chainparams = Params();
@@ -2885,6 +2780,7 @@ bool CChainState::DisconnectTip(CValidationState& state, const CChainParams& cha
 }
 
 static int64_t nTimeReadFromDisk = 0;
+static int64_t nTimePrefetch = 0;
 static int64_t nTimeConnectTotal = 0;
 static int64_t nTimeFlush = 0;
 static int64_t nTimeChainState = 0;
@@ -2955,6 +2851,67 @@ public:
     }
 };
 
+/**
+ * Load the coins spent by a block into the chainstate cache before the block is connected.
+ * The coins that are not cached yet are read from the coin database in parallel on the
+ * prefetch threads, so that the serial lookups in ConnectBlock only hit memory. Coins created
+ * within the block itself are skipped, as are the inputs of zerocoin spends.
+ */
+static void PrefetchBlockInputs(const CBlock& block, CCoinsViewCache& cache, unsigned int& nCached, unsigned int& nFetched)
+{
+    nCached = nFetched = 0;
+
+    std::unordered_set<uint256, StaticSaltedHasher> setBlockTxids;
+    for (const auto& tx : block.vtx) {
+        setBlockTxids.insert(tx->GetHash());
+    }
+
+    std::vector<COutPoint> vOutpoints;
+    for (const auto& tx : block.vtx) {
+        if (tx->IsCoinBase() || tx->HasZerocoinSpendInputs()) {
+            continue;
+        }
+        for (const CTxIn& txin : tx->vin) {
+            if (setBlockTxids.count(txin.prevout.hash)) {
+                continue;
+            }
+            if (cache.HaveCoinInCache(txin.prevout)) {
+                nCached++;
+            } else {
+                vOutpoints.push_back(txin.prevout);
+            }
+        }
+    }
+    if (vOutpoints.empty()) {
+        return;
+    }
+
+    // The backing view of pcoinsTip is the coin database, which can be read concurrently.
+    const CCoinsView* base = cache.GetBackend();
+    std::vector<Coin> vCoins(vOutpoints.size());
+    if (nScriptCheckThreads) {
+        std::vector<CCoinPrefetch> vChecks;
+        vChecks.reserve(vOutpoints.size());
+        for (size_t i = 0; i < vOutpoints.size(); i++) {
+            vChecks.emplace_back(base, vOutpoints[i], &vCoins[i]);
+        }
+        CCheckQueueControl<CCoinPrefetch> control(&coinprefetchqueue);
+        control.Add(vChecks);
+        control.Wait();
+    } else {
+        for (size_t i = 0; i < vOutpoints.size(); i++) {
+            CCoinPrefetch(base, vOutpoints[i], &vCoins[i])();
+        }
+    }
+
+    for (size_t i = 0; i < vOutpoints.size(); i++) {
+        if (!vCoins[i].IsSpent()) {
+            cache.AddPrefetchedCoin(vOutpoints[i], std::move(vCoins[i]));
+            nFetched++;
+        }
+    }
+}
+
 /**
  * Connect a new block to chainActive. pblock is either nullptr or a pointer to a CBlock
  * corresponding to pindexNew, to bypass loading it again from disk.
@@ -2981,9 +2938,16 @@ bool CChainState::ConnectTip(CValidationState& state, const CChainParams& chainp
     int64_t nTime2 = GetTimeMicros(); nTimeReadFromDisk += nTime2 - nTime1;
     int64_t nTime3;
     LogPrint(BCLog::BENCHMARK, "  - Load block from disk: %.2fms [%.2fs]\n", (nTime2 - nTime1) * MILLI, nTimeReadFromDisk * MICRO);
+    unsigned int nPrefetchCached, nPrefetchFetched;
+    PrefetchBlockInputs(blockConnecting, *pcoinsTip, nPrefetchCached, nPrefetchFetched);
+    int64_t nTime2_1 = GetTimeMicros(); nTimePrefetch += nTime2_1 - nTime2;
+    LogPrint(BCLog::BENCHMARK, "  - Prefetch inputs: %.2fms (%u cached, %u fetched) [%.2fs]\n", (nTime2_1 - nTime2) * MILLI, nPrefetchCached, nPrefetchFetched, nTimePrefetch * MICRO);
+    nTime2 = nTime2_1;
     {
         auto dbTx = evoDb->BeginTransaction();
 
+        const uint64_t nHitsBefore = pcoinsTip->GetCacheHits();
+        const uint64_t nMissesBefore = pcoinsTip->GetCacheMisses();
         CCoinsViewCache view(pcoinsTip.get());
         bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, chainparams);
         GetMainSignals().BlockChecked(blockConnecting, state);
@@ -2993,7 +2957,8 @@ bool CChainState::ConnectTip(CValidationState& state, const CChainParams& chainp
             return error("ConnectTip(): ConnectBlock %s failed with %s", pindexNew->GetBlockHash().ToString(), FormatStateMessage(state));
         }
         nTime3 = GetTimeMicros(); nTimeConnectTotal += nTime3 - nTime2;
-        LogPrint(BCLog::BENCHMARK, "  - Connect total: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime3 - nTime2) * MILLI, nTimeConnectTotal * MICRO, nTimeConnectTotal * MILLI / nBlocksTotal);
+        LogPrint(BCLog::BENCHMARK, "  - Connect total: %.2fms (%u coin cache hits, %u misses) [%.2fs (%.2fms/blk)]\n", (nTime3 - nTime2) * MILLI,
+            (unsigned int)(pcoinsTip->GetCacheHits() - nHitsBefore), (unsigned int)(pcoinsTip->GetCacheMisses() - nMissesBefore), nTimeConnectTotal * MICRO, nTimeConnectTotal * MILLI / nBlocksTotal);
         bool flushed = view.Flush();
         assert(flushed);
         dbTx->Commit();
@@ -4601,22 +4566,6 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams) EXCLUSIVE_LOCKS_RE
     pblocktree->ReadReindexing(fReindexing);
     if(fReindexing) fReindex = true;
 
-    // Check whether we have a transaction index
-    pblocktree->ReadFlag("txindex", fTxIndex);
-    LogPrintf("%s: transaction index %s\n", __func__, fTxIndex ? "enabled" : "disabled");
-
-    // Check whether we have an address index
-    pblocktree->ReadFlag("addressindex", fAddressIndex);
-    LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
-
-    // Check whether we have a timestamp index
-    pblocktree->ReadFlag("timestampindex", fTimestampIndex);
-    LogPrintf("%s: timestamp index %s\n", __func__, fTimestampIndex ? "enabled" : "disabled");
-
-    // Check whether we have a spent index
-    pblocktree->ReadFlag("spentindex", fSpentIndex);
-    LogPrintf("%s: spent index %s\n", __func__, fSpentIndex ? "enabled" : "disabled");
-
     return true;
 }
 
@@ -4643,6 +4592,7 @@ bool LoadChainTip(const CChainParams& chainparams)
         return false;
     }
     chainActive.SetTip(pindex);
+    stakeModifierCache.Sync(chainActive);
 
     g_chainstate.PruneBlockIndexCandidates();
 
@@ -4897,6 +4847,7 @@ void UnloadBlockIndex()
 {
     LOCK(cs_main);
     chainActive.SetTip(nullptr);
+    stakeModifierCache.Clear();
     pindexBestInvalid = nullptr;
     pindexBestHeader = nullptr;
     mempool.clear();
@@ -4937,21 +4888,6 @@ bool LoadBlockIndex(const CChainParams& chainparams)
         // needs_init.
 
         LogPrintf("Initializing databases...\n");
-        // Use the provided setting for -txindex in the new database
-        fTxIndex = gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX);
-        pblocktree->WriteFlag("txindex", fTxIndex);
-
-        // Use the provided setting for -addressindex in the new database
-        fAddressIndex = gArgs.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
-        pblocktree->WriteFlag("addressindex", fAddressIndex);
-
-        // Use the provided setting for -timestampindex in the new database
-        fTimestampIndex = gArgs.GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX);
-        pblocktree->WriteFlag("timestampindex", fTimestampIndex);
-
-        // Use the provided setting for -spentindex in the new database
-        fSpentIndex = gArgs.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX);
-        pblocktree->WriteFlag("spentindex", fSpentIndex);
     }
     return true;
 }
@@ -22,10 +22,12 @@
 #include <fs.h>
 #include <protocol.h> // For CMessageHeader::MessageStartChars
 #include <policy/feerate.h>
+#include <saltedhasher.h>
 #include <script/script_error.h>
 #include <sync.h>
 #include <versionbits.h>
 #include <spentindex.h>
+#include <unordered_lru_cache.h>
 
 #include <algorithm>
 #include <exception>
@@ -41,6 +43,7 @@
 
 class CBlockIndex;
 class CBlockTreeDB;
+class CBlockUndo;
 class CChainParams;
 class CCoinsViewDB;
 class CZerocoinDB;
@@ -112,6 +115,8 @@ static const unsigned int BLOCK_DOWNLOAD_WINDOW = 1024;
 static const unsigned int DATABASE_WRITE_INTERVAL = 60 * 60;
 /** Time to wait (in seconds) between flushing chainstate to disk. */
 static const unsigned int DATABASE_FLUSH_INTERVAL = 24 * 60 * 60;
+/** Share of -dbcache (in percent) that unmodified coins may keep after a flush under cache pressure. */
+static const unsigned int COINS_CACHE_RETAIN_PERCENT = 50;
 /** Maximum length of reject messages. */
 static const unsigned int MAX_REJECT_MESSAGE_LENGTH = 111;
 /** Block download timeout base, expressed in millionths of the block interval (i.e. 2.5 min) */
@@ -127,10 +132,14 @@ static const int64_t MAX_FEE_ESTIMATION_TIP_AGE = 3 * 60 * 60;
 static const bool DEFAULT_PERMIT_BAREMULTISIG = true;
 static const unsigned int DEFAULT_BYTES_PER_SIGOP = 20;
 static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
+/** Default for -checkzerocoinspends */
+static const bool DEFAULT_CHECK_ZEROCOIN_SPENDS = false;
 static const bool DEFAULT_TXINDEX = true;
 static const bool DEFAULT_ADDRESSINDEX = false;
 static const bool DEFAULT_TIMESTAMPINDEX = false;
 static const bool DEFAULT_SPENTINDEX = false;
+static const bool DEFAULT_TOKENINDEX = false;
+static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
 static const unsigned int DEFAULT_BANSCORE_THRESHOLD = 100;
 /** Default for -persistmempool */
 static const bool DEFAULT_PERSIST_MEMPOOL = true;
@@ -144,6 +153,7 @@ static const unsigned int MAX_BLOCKS_TO_ANNOUNCE = 8;
 static const int MAX_UNCONNECTING_HEADERS = 10;
 
 static const bool DEFAULT_PEERBLOOMFILTERS = true;
+static const bool DEFAULT_PEERBLOCKFILTERS = false;
 
 /** Default for -stopatheight */
 static const int DEFAULT_STOPATHEIGHT = 0;
@@ -171,15 +181,13 @@ extern uint256 g_best_block;
 extern std::atomic_bool fImporting;
 extern std::atomic_bool fReindex;
 extern int nScriptCheckThreads;
-extern bool fTxIndex;
-extern bool fAddressIndex;
-extern bool fTimestampIndex;
-extern bool fSpentIndex;
 extern bool fIsBareMultisigStd;
 extern bool fRequireStandard;
 extern unsigned int nBytesPerSigOp;
 extern bool fCheckBlockIndex;
 extern bool fCheckpointsEnabled;
+/** Whether ConnectBlock verifies the signatures and serials of historical zerocoin spends */
+extern bool fCheckZerocoinSpends;
 extern size_t nCoinCacheUsage;
 /** A fee rate smaller than this is considered zero fee (for relaying, mining and transaction creation) */
 extern CFeeRate minRelayTxFee;
@@ -213,7 +221,10 @@ extern bool fPruneMode;
 /** Number of MiB of block files that we're trying to stay below. */
 extern uint64_t nPruneTarget;
 
-extern std::map<uint256, uint256> mapProofOfStake;
+/** Number of proof-of-stake hashes of recently connected blocks kept in memory */
+static const size_t PROOF_OF_STAKE_CACHE_SIZE = 10000;
+/** Proof-of-stake hashes by block hash, least recently used entries are evicted (guarded by cs_main) */
+extern unordered_lru_cache<uint256, uint256, StaticSaltedHasher> mapProofOfStake;
 
 /** Block files containing a block-height within MIN_BLOCKS_TO_KEEP of chainActive.Tip() will not be pruned. */
 static const unsigned int MIN_BLOCKS_TO_KEEP = 288;
@@ -288,6 +299,10 @@ bool LoadChainTip(const CChainParams& chainparams);
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the coin prefetch thread */
+void ThreadCoinPrefetch();
+/** Run an instance of the zerocoin spend checking thread */
+void ThreadZerocoinSpendCheck();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Retrieve a transaction (from memory pool, or from disk, if possible) */
@@ -319,6 +334,20 @@ void PruneOneBlockFile(const int fileNumber);
  */
 void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune);
 
+/** Statistics of the chainstate flushes, reported by getcoinscacheinfo. */
+struct CCoinsFlushStats
+{
+    uint64_t nFlushes = 0;
+    int64_t nLastFlushTime = 0;
+    uint64_t nLastFlushWritten = 0;
+    uint64_t nLastFlushEvicted = 0;
+    uint64_t nTotalWritten = 0;
+    uint64_t nTotalEvicted = 0;
+};
+
+/** Get the statistics of the chainstate flushes since startup. */
+CCoinsFlushStats GetCoinsFlushStats();
+
 /** Flush all state, indexes and buffers to disk. */
 void FlushStateToDisk();
 /** Prune block files and flush state to disk. */
@@ -432,6 +461,8 @@ void InitScriptExecutionCache();
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
 
+bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex);
+
 /** Functions for validating blocks and updating the block tree */
 
 /** Context-independent validity checks */
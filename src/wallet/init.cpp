@@ -524,6 +524,14 @@ void WalletInit::InitStaking() const
     }
 
     stakingManager->nReserveBalance = nReserveBalance;
+
+    if (stakingManager->fEnableStaking) {
+        int nStakingThreads = gArgs.GetArg("-stakingthreads", DEFAULT_STAKING_THREADS);
+        if (nStakingThreads <= 0)
+            nStakingThreads = GetNumCores();
+        stakingManager->Start(nStakingThreads);
+        LogPrintf("Using %d threads for stake kernel search\n", stakingManager->GetStakingThreads());
+    }
 }
 
 void WalletInit::InitRewardsManagement() const
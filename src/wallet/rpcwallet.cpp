@@ -4071,6 +4071,13 @@ UniValue getstakingstatus(const JSONRPCRequest& request)
             "  \"enoughcoins\": true|false,        (boolean) if available coins are greater than reserve balance\n"
             "  \"mnsync\": true|false,             (boolean) if masternode data is synced\n"
             "  \"staking status\": true|false,     (boolean) if the wallet is staking or not\n"
+            "  \"stakingthreads\": n,               (numeric) number of threads used to search for stake kernels\n"
+            "  \"lastsearch\": {                    (json object) the last kernel search\n"
+            "    \"slot\": n,                       (numeric) the time slot that was searched\n"
+            "    \"inputs\": n,                     (numeric) the number of stakable inputs hashed\n"
+            "    \"duration_ms\": n,                (numeric) time spent searching, in milliseconds\n"
+            "    \"found\": true|false,             (boolean) if a kernel was found\n"
+            "  }\n"
             "}\n"
 
             "\nExamples:\n" +
@@ -4096,6 +4103,15 @@ UniValue getstakingstatus(const JSONRPCRequest& request)
     }
     obj.push_back(Pair("mnsync", fMnSync));
     obj.push_back(Pair("staking_status", fStakingStatus));
+    obj.push_back(Pair("stakingthreads", stakingManager->GetStakingThreads()));
+
+    CStakeSearchStats stats = stakingManager->GetLastSearchStats();
+    UniValue searchObj(UniValue::VOBJ);
+    searchObj.push_back(Pair("slot", stats.nSlot));
+    searchObj.push_back(Pair("inputs", (uint64_t)stats.nInputs));
+    searchObj.push_back(Pair("duration_ms", stats.nDurationMicros * 0.001));
+    searchObj.push_back(Pair("found", stats.fFound));
+    obj.push_back(Pair("lastsearch", searchObj));
 
     return obj;
 }
@@ -0,0 +1,119 @@
+// Copyright (c) 2021 The Bytz Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <pos/staking-manager.h>
+#include <script/interpreter.h>
+#include <test/test_bytz.h>
+#include <txmempool.h>
+#include <validation.h>
+#include <wallet/wallet.h>
+
+#include <boost/test/unit_test.hpp>
+
+class StakingTestingSetup : public TestChain100Setup
+{
+public:
+    StakingTestingSetup()
+    {
+        wallet = std::make_shared<CWallet>(WalletLocation(), WalletDatabase::CreateMock());
+        bool firstRun;
+        wallet->LoadWallet(firstRun);
+        {
+            LOCK(wallet->cs_wallet);
+            wallet->AddKeyPubKey(coinbaseKey, coinbaseKey.GetPubKey());
+        }
+        WalletRescanReserver reserver(wallet.get());
+        reserver.reserve();
+        wallet->ScanForWalletTransactions(chainActive.Genesis(), nullptr, reserver);
+        staking = MakeUnique<CStakingManager>(wallet);
+    }
+
+    ~StakingTestingSetup()
+    {
+        staking.reset();
+        wallet.reset();
+    }
+
+    /** Spend the given outputs of coinbaseKey to a single output paying back to it. */
+    CMutableTransaction CreateSpend(const std::vector<COutPoint>& vPrevouts, CAmount nValue)
+    {
+        CScript scriptPubKey = GetScriptForRawPubKey(coinbaseKey.GetPubKey());
+        CMutableTransaction spend;
+        spend.nVersion = 1;
+        for (const COutPoint& prevout : vPrevouts) {
+            spend.vin.emplace_back(prevout);
+        }
+        spend.vout.emplace_back(nValue, scriptPubKey);
+
+        for (unsigned int i = 0; i < spend.vin.size(); i++) {
+            std::vector<unsigned char> vchSig;
+            uint256 hash = SignatureHash(scriptPubKey, spend, i, SIGHASH_ALL, 0, SigVersion::BASE);
+            BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+            vchSig.push_back((unsigned char)SIGHASH_ALL);
+            spend.vin[i].scriptSig << vchSig;
+        }
+        return spend;
+    }
+
+    /** Mine a block and pass it to the staking manager the way the notification interface does. */
+    CBlock ConnectBlock(const std::vector<CMutableTransaction>& txns, const std::vector<CTransactionRef>& vtxConflicted = {})
+    {
+        CBlock block = CreateAndProcessBlock(txns, coinbaseKey);
+        const CBlockIndex* pindex;
+        {
+            LOCK(cs_main);
+            pindex = chainActive.Tip();
+        }
+        BOOST_CHECK(pindex->GetBlockHash() == block.GetHash());
+        staking->BlockConnected(std::make_shared<const CBlock>(block), pindex, vtxConflicted);
+        return block;
+    }
+
+    std::shared_ptr<CWallet> wallet;
+    std::unique_ptr<CStakingManager> staking;
+};
+
+BOOST_FIXTURE_TEST_SUITE(staking_tests, StakingTestingSetup)
+
+BOOST_AUTO_TEST_CASE(stake_candidates_incremental)
+{
+    // the first query loads the candidates from the wallet
+    staking->MintableCoins();
+    const COutPoint coinbaseOut(coinbaseTxns[0].GetHash(), 0);
+    BOOST_CHECK(staking->HasStakeCandidate(coinbaseOut));
+
+    // an output created and spent within the same block never becomes a candidate
+    CMutableTransaction spend1 = CreateSpend({coinbaseOut}, 11 * CENT);
+    CMutableTransaction spend2 = CreateSpend({COutPoint(spend1.GetHash(), 0)}, 10 * CENT);
+    CBlock block1 = ConnectBlock({spend1, spend2});
+    const COutPoint spendOut(spend2.GetHash(), 0);
+    BOOST_CHECK(!staking->HasStakeCandidate(coinbaseOut));
+    BOOST_CHECK(!staking->HasStakeCandidate(COutPoint(spend1.GetHash(), 0)));
+    BOOST_CHECK(staking->HasStakeCandidate(spendOut));
+    const COutPoint blockOut(block1.vtx[0]->GetHash(), 0);
+    BOOST_CHECK(staking->HasStakeCandidate(blockOut));
+
+    // a candidate spent by a mempool transaction comes back when that transaction leaves the mempool unconfirmed
+    CTransactionRef mempoolTx = MakeTransactionRef(CreateSpend({spendOut, blockOut}, 9 * CENT));
+    staking->TransactionAddedToMempool(mempoolTx);
+    BOOST_CHECK(!staking->HasStakeCandidate(spendOut));
+    BOOST_CHECK(!staking->HasStakeCandidate(blockOut));
+    staking->TransactionRemovedFromMempool(mempoolTx);
+    BOOST_CHECK(staking->HasStakeCandidate(spendOut));
+    BOOST_CHECK(staking->HasStakeCandidate(blockOut));
+
+    // a block conflicting with the mempool transaction only restores the inputs it did not spend itself
+    staking->TransactionAddedToMempool(mempoolTx);
+    CMutableTransaction spend3 = CreateSpend({spendOut}, 8 * CENT);
+    ConnectBlock({spend3}, {mempoolTx});
+    BOOST_CHECK(!staking->HasStakeCandidate(spendOut));
+    BOOST_CHECK(staking->HasStakeCandidate(blockOut));
+    BOOST_CHECK(staking->HasStakeCandidate(COutPoint(spend3.GetHash(), 0)));
+
+    // a confirmed spend is not restored by a later removal notification
+    staking->TransactionRemovedFromMempool(mempoolTx);
+    BOOST_CHECK(!staking->HasStakeCandidate(spendOut));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
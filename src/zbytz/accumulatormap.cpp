@@ -42,7 +42,7 @@ bool AccumulatorMap::Load(uint256 nCheckpoint)
         uint32_t nChecksum = ParseChecksum(nCheckpoint, denom);
 
         CBigNum bnValue;
-        if (!zerocoinDB->ReadAccumulatorValue(nChecksum, bnValue))
+        if (!GetAccumulatorValueFromChecksum(nChecksum, false, bnValue) || bnValue == 0)
             return error("%s : cannot find checksum %d", __func__, nChecksum);
 
         mapAccumulators.at(denom)->setValue(bnValue);
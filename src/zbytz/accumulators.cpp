@@ -7,7 +7,9 @@
 #include "init.h"
 #include "pos/checks.h"
 #include "spork.h"
+#include "sync.h"
 #include "tinyformat.h"
+#include "unordered_lru_cache.h"
 #include "validation.h"
 #include "zbytz/accumulators.h"
 #include "zbytz/accumulatormap.h"
@@ -16,8 +18,12 @@
 #include "zbytz/zbytzchain.h"
 #include "zbytz/zerocoindb.h"
 
-std::map<uint32_t, CBigNum> mapAccumulatorValues;
-std::list<uint256> listAccCheckpointsNoDB;
+/** Number of accumulator values kept in memory, eight per checkpoint */
+static const size_t ACCUMULATOR_VALUE_CACHE_SIZE = 8 * 1000;
+
+/** Recently used accumulator values by checksum, in front of the zerocoin database */
+static CCriticalSection cs_accumulatorValues;
+static unordered_lru_cache<uint32_t, CBigNum, std::hash<uint32_t> > accumulatorValueCache(ACCUMULATOR_VALUE_CACHE_SIZE);
 
 
 uint32_t ParseChecksum(uint256 nChecksum, libzerocoin::CoinDenomination denomination)
@@ -68,9 +74,10 @@ int GetChecksumHeight(uint32_t nChecksum, libzerocoin::CoinDenomination denomina
 
 bool GetAccumulatorValueFromChecksum(uint32_t nChecksum, bool fMemoryOnly, CBigNum& bnAccValue)
 {
-    if (mapAccumulatorValues.count(nChecksum)) {
-        bnAccValue = mapAccumulatorValues.at(nChecksum);
-        return true;
+    {
+        LOCK(cs_accumulatorValues);
+        if (accumulatorValueCache.get(nChecksum, bnAccValue))
+            return true;
     }
 
     if (fMemoryOnly)
@@ -78,8 +85,11 @@ bool GetAccumulatorValueFromChecksum(uint32_t nChecksum, bool fMemoryOnly, CBigN
 
     if (!zerocoinDB->ReadAccumulatorValue(nChecksum, bnAccValue)) {
         bnAccValue = 0;
+        return true;
     }
 
+    LOCK(cs_accumulatorValues);
+    accumulatorValueCache.insert(nChecksum, bnAccValue);
     return true;
 }
 
@@ -96,7 +106,8 @@ void AddAccumulatorChecksum(const uint32_t nChecksum, const CBigNum &bnValue)
     //Since accumulators are switching at v2, stop databasing v1 because its useless. Only focus on v2.
     if (chainActive.Height() >= Params().GetConsensus().nBlockZerocoinV2) {
         zerocoinDB->WriteAccumulatorValue(nChecksum, bnValue);
-        mapAccumulatorValues.insert(std::make_pair(nChecksum, bnValue));
+        LOCK(cs_accumulatorValues);
+        accumulatorValueCache.insert(nChecksum, bnValue);
     }
 }
 
@@ -116,7 +127,10 @@ void DatabaseChecksums(AccumulatorMap& mapAccumulators)
 bool EraseChecksum(uint32_t nChecksum)
 {
     //erase from both memory and database
-    mapAccumulatorValues.erase(nChecksum);
+    {
+        LOCK(cs_accumulatorValues);
+        accumulatorValueCache.erase(nChecksum);
+    }
     return zerocoinDB->EraseAccumulatorValue(nChecksum);
 }
 
@@ -244,9 +258,6 @@ bool CalculateAccumulatorCheckpoint(int nHeight, uint256& nCheckpoint, Accumulat
     if (!InitializeAccumulators(nHeight, nHeightCheckpoint, mapAccumulators))
         return error("%s: failed to initialize accumulators", __func__);
 
-    //Whether this should filter out invalid/fraudulent outpoints
-    bool fFilterInvalid = false;// nHeight >= Params().Zerocoin_Block_RecalculateAccumulators();
-
     //Accumulate all coins over the last ten blocks that havent been accumulated (height - 20 through height - 11)
     int nTotalMintsFound = 0;
     CBlockIndex *pindex = chainActive[nHeightCheckpoint >= 20 ? nHeightCheckpoint - 20 : 0];
@@ -263,12 +274,8 @@ bool CalculateAccumulatorCheckpoint(int nHeight, uint256& nCheckpoint, Accumulat
         }
 
         //grab mints from this block
-        CBlock block;
-        if(!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-            return error("%s: failed to read block from disk", __func__);
-
         std::list<libzerocoin::PublicCoin> listPubcoins;
-        if (!BlockToPubcoinList(block, listPubcoins, fFilterInvalid))
+        if (!GetBlockPubcoins(pindex, listPubcoins))
             return error("%s: failed to get zerocoin mintlist from block %d", __func__, pindex->nHeight);
 
         nTotalMintsFound += listPubcoins.size();
@@ -345,13 +352,26 @@ int ComputeAccumulatedCoins(int nHeightEnd, libzerocoin::CoinDenomination denom)
 }
 
 
-std::list<libzerocoin::PublicCoin> GetPubcoinFromBlock(const CBlockIndex* pindex){
+bool GetBlockPubcoins(const CBlockIndex* pindex, std::list<libzerocoin::PublicCoin>& listPubcoins)
+{
+    if (zerocoinDB->ReadBlockPubcoins(pindex->nHeight, pindex->GetBlockHash(), listPubcoins))
+        return true;
+
     //grab mints from this block
     CBlock block;
     if(!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-        throw GetPubcoinException("GetPubcoinFromBlock: failed to read block from disk while adding pubcoins to witness");
-    std::list<libzerocoin::PublicCoin> listPubcoins;
+        return error("%s: failed to read block from disk", __func__);
     if(!BlockToPubcoinList(block, listPubcoins, true))
+        return error("%s: failed to get zerocoin mintlist from block %d", __func__, pindex->nHeight);
+
+    //blocks connected before the pubcoin index existed are indexed on first use
+    zerocoinDB->WriteBlockPubcoins(pindex->nHeight, pindex->GetBlockHash(), listPubcoins);
+    return true;
+}
+
+std::list<libzerocoin::PublicCoin> GetPubcoinFromBlock(const CBlockIndex* pindex){
+    std::list<libzerocoin::PublicCoin> listPubcoins;
+    if(!GetBlockPubcoins(pindex, listPubcoins))
         throw GetPubcoinException("GetPubcoinFromBlock: failed to get zerocoin mintlist from block "+std::to_string(pindex->nHeight)+"\n");
     return listPubcoins;
 }
@@ -902,9 +922,6 @@ bool CalculateAccumulatorCheckpointWithoutDB(int nHeight, uint256& nCheckpoint,
 
     mapAccumulators.Reset();
 
-    //Whether this should filter out invalid/fraudulent outpoints
-    bool fFilterInvalid = false;// nHeight >= Params().Zerocoin_Block_RecalculateAccumulators();
-
     //Accumulate all coins over the full zerocoin period
     int nTotalMintsFound = 0;
     CBlockIndex *pindex = chainActive[Params().GetConsensus().nBlockZerocoinV2];
@@ -921,12 +938,8 @@ bool CalculateAccumulatorCheckpointWithoutDB(int nHeight, uint256& nCheckpoint,
         }
 
         //grab mints from this block
-        CBlock block;
-        if(!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-            return error("%s: failed to read block from disk", __func__);
-
         std::list<libzerocoin::PublicCoin> listPubcoins;
-        if (!BlockToPubcoinList(block, listPubcoins, fFilterInvalid))
+        if (!GetBlockPubcoins(pindex, listPubcoins))
             return error("%s: failed to get zerocoin mintlist from block %d", __func__, pindex->nHeight);
 
         nTotalMintsFound += listPubcoins.size();
@@ -50,6 +50,8 @@ bool GenerateAccumulatorWitness(
 
 bool GenerateAccumulatorWitness(CoinWitnessData* coinWitness, AccumulatorMap& mapAccumulators, CBlockIndex* pindexCheckpoint);
 */
+/** Get the pubcoins minted in a block from the pubcoin index, reading and indexing the block if it is not indexed yet */
+bool GetBlockPubcoins(const CBlockIndex* pindex, std::list<libzerocoin::PublicCoin>& listPubcoins);
 std::list<libzerocoin::PublicCoin> GetPubcoinFromBlock(const CBlockIndex* pindex);
 bool GetAccumulatorValueFromDB(uint256 nCheckpoint, libzerocoin::CoinDenomination denom, CBigNum& bnAccValue);
 bool GetAccumulatorValue(int& nHeight, const libzerocoin::CoinDenomination denom, CBigNum& bnAccValue);
@@ -139,6 +139,29 @@ bool CZerocoinDB::ReadAccumulatorValue(const uint32_t& nChecksum, CBigNum& bnVal
     return Read(std::make_pair('2', nChecksum), bnValue);
 }
 
+bool CZerocoinDB::WriteBlockPubcoins(int nHeight, const uint256& hashBlock, const std::list<libzerocoin::PublicCoin>& listPubcoins)
+{
+    std::vector<std::pair<CBigNum, int64_t> > vPubcoins;
+    vPubcoins.reserve(listPubcoins.size());
+    for (const libzerocoin::PublicCoin& pubcoin : listPubcoins)
+        vPubcoins.emplace_back(pubcoin.getValue(), libzerocoin::ZerocoinDenominationToInt(pubcoin.getDenomination()));
+
+    return Write(std::make_pair('p', nHeight), std::make_pair(hashBlock, vPubcoins));
+}
+
+bool CZerocoinDB::ReadBlockPubcoins(int nHeight, const uint256& hashBlock, std::list<libzerocoin::PublicCoin>& listPubcoins)
+{
+    // entries of disconnected blocks are not erased, the hash tells them apart
+    std::pair<uint256, std::vector<std::pair<CBigNum, int64_t> > > entry;
+    if (!Read(std::make_pair('p', nHeight), entry) || entry.first != hashBlock)
+        return false;
+
+    libzerocoin::ZerocoinParams* params = Params().Zerocoin_Params(false);
+    for (const auto& pubcoin : entry.second)
+        listPubcoins.emplace_back(params, pubcoin.first, libzerocoin::IntToZerocoinDenomination(pubcoin.second));
+    return true;
+}
+
 bool CZerocoinDB::EraseAccumulatorValue(const uint32_t& nChecksum)
 {
     LogPrint(BCLog::ZEROCOIN, "%s : checksum:%d\n", __func__, nChecksum);
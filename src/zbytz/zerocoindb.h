@@ -36,6 +36,10 @@ public:
     bool WriteAccumulatorValue(const uint32_t& nChecksum, const CBigNum& bnValue);
     bool ReadAccumulatorValue(const uint32_t& nChecksum, CBigNum& bnValue);
     bool EraseAccumulatorValue(const uint32_t& nChecksum);
+    /** Index the pubcoins minted in a block by its height, so witnesses can be built without reading the block */
+    bool WriteBlockPubcoins(int nHeight, const uint256& hashBlock, const std::list<libzerocoin::PublicCoin>& listPubcoins);
+    /** Read the pubcoins of the block at nHeight. Returns false if it is not indexed or another block was indexed at that height */
+    bool ReadBlockPubcoins(int nHeight, const uint256& hashBlock, std::list<libzerocoin::PublicCoin>& listPubcoins);
 };
 
 #endif //PIVX_ZEROCOINDB_H
@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+# Copyright (c) 2021 The Bytz Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+import json
+import time
+
+from test_framework.test_framework import BytzTestFramework
+from test_framework.util import *
+
+'''
+p2p_msghandler_threads.py
+
+Checks that blocks, transactions, governance objects and LLMQ messages
+sync while peer messages are processed on several message handler threads
+
+'''
+
+class MsgHandlerThreadsTest(BytzTestFramework):
+    def set_test_params(self):
+        self.set_bytz_test_params(4, 3, [["-msghandlerthreads=4"]] * 4, fast_dip3_enforcement=True)
+
+    def run_test(self):
+        # Connect all nodes to node1 so that we always have the whole network connected
+        for i in range(len(self.nodes)):
+            if i != 1:
+                connect_nodes(self.nodes[i], 1)
+
+        self.log.info("Sync sporks and mine a quorum")
+        self.nodes[0].spork("SPORK_17_QUORUM_DKG_ENABLED", 0)
+        self.wait_for_sporks_same()
+        self.mine_quorum()
+
+        self.log.info("Mine a block, wait for its chainlock")
+        self.nodes[0].generate(1)
+        self.sync_blocks()
+        self.wait_for_chainlocked_block_all_nodes(self.nodes[0].getbestblockhash())
+
+        self.log.info("Relay a transaction, wait for its InstantSend lock")
+        txid = self.nodes[0].sendtoaddress(self.nodes[1].getnewaddress(), 1)
+        self.sync_mempools()
+        for node in self.nodes:
+            self.wait_for_instantlock(txid, node)
+        self.nodes[0].generate(1)
+        self.sync_blocks()
+
+        self.log.info("Relay a governance object")
+        proposal_time = int(time.time())
+        proposal = {
+            "type": 1,
+            "name": "MsgHandlerThreads",
+            "start_epoch": proposal_time,
+            "end_epoch": proposal_time + 24 * 60 * 60,
+            "payment_amount": 1,
+            "payment_address": self.nodes[0].getnewaddress(),
+            "url": "https://bytz.org"
+        }
+        proposal_hex = ''.join(format(x, '02x') for x in json.dumps(proposal).encode())
+        collateral_hash = self.nodes[0].gobject("prepare", "0", 1, proposal_time, proposal_hex)
+        self.nodes[0].generate(6)
+        self.sync_blocks()
+        object_hash = self.nodes[0].gobject("submit", "0", 1, proposal_time, proposal_hex, collateral_hash)
+        wait_until(lambda: all(object_hash in node.gobject("list", "all", "proposals") for node in self.nodes), timeout=30)
+
+        self.log.info("Restart a node, wait for it to sync all of it again")
+        self.restart_node(0)
+        connect_nodes(self.nodes[0], 1)
+        self.nodes[1].generate(1)
+        self.sync_blocks()
+        wait_until(lambda: self.nodes[0].mnsync("status")["IsSynced"], timeout=60)
+        wait_until(lambda: object_hash in self.nodes[0].gobject("list", "all", "proposals"), timeout=30)
+        self.wait_for_chainlocked_block(self.nodes[0], self.nodes[0].getbestblockhash())
+
+
+if __name__ == '__main__':
+    MsgHandlerThreadsTest().main()
@@ -84,6 +84,7 @@ BASE_SCRIPTS= [
     #'feature_llmq_is_cl_conflicts.py', # NOTE: needs bytz_hash to pass
     'feature_llmq_is_retroactive.py', # NOTE: needs bytz_hash to pass
     'feature_llmq_dkgerrors.py',
+    'p2p_msghandler_threads.py', # NOTE: needs bytz_hash to pass
     #'feature_dip4_coinbasemerkleroots.py', # NOTE: needs bytz_hash to pass
     # vv Tests less than 60s vv
     #'p2p_sendheaders.py', # NOTE: needs bytz_hash to pass